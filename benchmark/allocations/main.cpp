@@ -0,0 +1,258 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/rlnc/seed_codes.hpp>
+#include <kodo/rs/reed_solomon_codes.hpp>
+#include <kodo/nocode/carousel_codes.hpp>
+
+#include "../counting_allocator.hpp"
+
+/// Counts the heap allocations made per block when the encoders and
+/// decoders are built from warmed factories. In the steady state the
+/// count should be zero for all stacks.
+template<class Encoder, class Decoder>
+struct allocations_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Decoder::factory decoder_factory;
+
+    void start()
+    {
+        m_blocks = 0;
+        m_allocations = heap_allocations();
+        gauge::time_benchmark::start();
+    }
+
+    void stop()
+    {
+        gauge::time_benchmark::stop();
+        m_allocations = heap_allocations() - m_allocations;
+    }
+
+    double measurement()
+    {
+        assert(m_blocks > 0);
+        return double(m_allocations) / m_blocks;
+    }
+
+    void store_run(gauge::table& results)
+    {
+        results.set_value("allocations", measurement());
+
+        // The time spent per block in microseconds
+        results.set_value("block_time",
+            gauge::time_benchmark::measurement() /
+            (m_blocks / gauge::time_benchmark::iteration_count()));
+    }
+
+    bool accept_measurement()
+    {
+        // Every block must be decoded
+        if(!m_complete)
+            return false;
+
+        return gauge::time_benchmark::accept_measurement();
+    }
+
+    std::string unit_text() const
+    {
+        return "allocations per block";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                gauge::config_set cs;
+                cs.set_value<uint32_t>("symbols", s);
+                cs.set_value<uint32_t>("symbol_size", p);
+
+                add_configuration(cs);
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_data_in.resize(symbols * symbol_size);
+
+        for(uint8_t &e : m_data_in)
+        {
+            e = rand() % 256;
+        }
+
+        m_payload.resize(std::max(m_encoder_factory->max_payload_size(),
+                                  m_decoder_factory->max_payload_size()));
+
+        // Warm the pools and caches, the first block of a coder
+        // allocates its memory
+        for(uint32_t i = 0; i < 4; ++i)
+            code_block();
+    }
+
+    /// Codes a block using an encoder and decoder built by the factories
+    void code_block()
+    {
+        auto encoder = m_encoder_factory->build();
+        auto decoder = m_decoder_factory->build();
+
+        encoder->set_symbols(sak::storage(m_data_in));
+
+        if(kodo::is_systematic_encoder(encoder))
+            kodo::set_systematic_off(encoder);
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&m_payload[0]);
+            decoder->decode(&m_payload[0]);
+        }
+
+        m_complete = m_complete && decoder->is_complete();
+        ++m_blocks;
+    }
+
+    void run_benchmark()
+    {
+        m_complete = true;
+
+        RUN{
+            code_block();
+        }
+    }
+
+protected:
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The data encoded
+    std::vector<uint8_t> m_data_in;
+
+    /// The payload buffer
+    std::vector<uint8_t> m_payload;
+
+    /// The number of blocks coded in the run
+    uint64_t m_blocks;
+
+    /// The allocations made in the run
+    uint64_t m_allocations;
+
+    /// True if all blocks of the run were decoded
+    bool m_complete;
+};
+
+BENCHMARK_OPTION(allocations_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(64);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    gauge::runner::instance().register_options(options);
+}
+
+typedef allocations_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_allocations;
+
+BENCHMARK_F(setup_rlnc_allocations, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef allocations_benchmark<
+    kodo::seed_rlnc_encoder<fifi::binary8>,
+    kodo::seed_rlnc_decoder<fifi::binary8> > setup_seed_allocations;
+
+BENCHMARK_F(setup_seed_allocations, SeedRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef allocations_benchmark<
+    kodo::rs_encoder<fifi::binary8>,
+    kodo::rs_decoder<fifi::binary8> > setup_rs_allocations;
+
+BENCHMARK_F(setup_rs_allocations, ReedSolomon, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef allocations_benchmark<
+    kodo::nocode_carousel_encoder,
+    kodo::nocode_carousel_decoder> setup_nocode_allocations;
+
+BENCHMARK_F(setup_nocode_allocations, NoCode, Binary, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
+
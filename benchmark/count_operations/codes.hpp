@@ -9,6 +9,7 @@
 #include <kodo/linear_block_decoder_delayed.hpp>
 #include <kodo/partial_shallow_symbol_storage.hpp>
 #include <kodo/finite_field_counter.hpp>
+#include <kodo/finite_field_volume_counter.hpp>
 
 namespace kodo
 {
@@ -35,6 +36,7 @@ namespace kodo
                storage_bytes_used<
                storage_block_info<
                // Finite Field API
+               finite_field_volume_counter<
                finite_field_counter<
                finite_field_math<typename fifi::default_field<Field>::type,
                finite_field_info<Field,
@@ -42,7 +44,7 @@ namespace kodo
                final_coder_factory_pool<
                // Final type
                full_rlnc_encoder_count<Field>
-                   > > > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > > > >
     { };
 
     template<class Field>
@@ -65,6 +67,7 @@ namespace kodo
                storage_bytes_used<
                storage_block_info<
                // Finite Field API
+               finite_field_volume_counter<
                finite_field_counter<
                finite_field_math<typename fifi::default_field<Field>::type,
                finite_field_info<Field,
@@ -72,7 +75,7 @@ namespace kodo
                final_coder_factory_pool<
                // Final type
                full_rlnc_decoder_count<Field>
-                   > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > >
     { };
 
     template<class Field>
@@ -96,6 +99,7 @@ namespace kodo
                storage_bytes_used<
                storage_block_info<
                // Finite Field API
+               finite_field_volume_counter<
                finite_field_counter<
                finite_field_math<typename fifi::default_field<Field>::type,
                finite_field_info<Field,
@@ -103,7 +107,7 @@ namespace kodo
                final_coder_factory_pool<
                // Final type
                full_delayed_rlnc_decoder_count<Field>
-                   > > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > > >
     { };
 
 }
@@ -15,6 +15,7 @@
 #include <gauge/csv_printer.hpp>
 
 #include "codes.hpp"
+#include "../perf_counters.hpp"
 
 std::vector<uint32_t> setup_symbols()
 {
@@ -174,11 +175,18 @@ public:
     {
         m_encoder->reset_operations_counter();
         m_decoder->reset_operations_counter();
+
+        m_encoder->reset_operations_volume();
+        m_decoder->reset_operations_volume();
+
+        m_perf_counters.start();
     }
 
     /// Stops a measurement and saves the counter
     void stop()
     {
+        m_perf_counters.stop();
+
         gauge::config_set cs = get_current_configuration();
 
         std::string type = cs.get_value<std::string>("type");
@@ -186,10 +194,12 @@ public:
         if(type == "encoder")
         {
             m_counter = m_encoder->get_operations_counter();
+            m_volume = m_encoder->get_operations_volume();
         }
         else if(type == "decoder")
         {
             m_counter = m_decoder->get_operations_counter();
+            m_volume = m_decoder->get_operations_volume();
         }
         else
         {
@@ -216,9 +226,60 @@ public:
 
         results.set_value("invert(value)",
                           m_counter.m_invert);
+
+        store_volume(results);
+
+        // Both the encoder and decoder run until the block is decoded
+        m_perf_counters.store(results, m_decoder->block_size());
     }
 
 
+    /// Stores the bytes processed per operation, per buffer and per
+    /// decoder phase
+    void store_volume(gauge::table& results)
+    {
+        typedef kodo::operations_volume volume;
+
+        results.set_value("multiply_bytes",
+                          m_volume.operation_bytes(volume::multiply));
+
+        results.set_value("multiply_add_bytes",
+                          m_volume.operation_bytes(volume::multiply_add));
+
+        results.set_value("add_bytes",
+                          m_volume.operation_bytes(volume::add));
+
+        results.set_value("multiply_subtract_bytes",
+                          m_volume.operation_bytes(volume::multiply_subtract));
+
+        results.set_value("subtract_bytes",
+                          m_volume.operation_bytes(volume::subtract));
+
+        results.set_value("coefficient_operations",
+                          m_volume.buffer_calls(volume::coefficients));
+
+        results.set_value("coefficient_bytes",
+                          m_volume.buffer_bytes(volume::coefficients));
+
+        results.set_value("data_operations",
+                          m_volume.buffer_calls(volume::symbol_data));
+
+        results.set_value("data_bytes",
+                          m_volume.buffer_bytes(volume::symbol_data));
+
+        for(uint32_t p = 0; p < kodo::decoder_phase::phase_count; ++p)
+        {
+            auto phase = static_cast<kodo::decoder_phase::type>(p);
+            std::string name = kodo::decoder_phase::name(phase);
+
+            results.set_value(name + "_operations",
+                              m_volume.phase_calls(phase));
+
+            results.set_value(name + "_bytes",
+                              m_volume.phase_bytes(phase));
+        }
+    }
+
     /// Prepares the measurement for every run
     void setup()
     {
@@ -331,6 +392,12 @@ protected:
     /// The counter containing the measurement results
     kodo::operations_counter m_counter;
 
+    /// The calls and bytes of the operations measured
+    kodo::operations_volume m_volume;
+
+    /// The hardware counters of the measurement
+    perf_counters m_perf_counters;
+
 };
 
 /// Using this macro we may specify options. For specifying options
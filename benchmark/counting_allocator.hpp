@@ -0,0 +1,58 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+/// @file counting_allocator.hpp
+///
+/// Replaces the global operator new and delete with versions counting
+/// the heap allocations of the program. The replacement applies to the
+/// whole program, so the header must only be included by one source
+/// file of a program written to count allocations, i.e. never by the
+/// kodo_tests unit tests.
+
+namespace
+{
+    /// The number of heap allocations made by the program
+    std::atomic<uint64_t> counted_allocations(0);
+}
+
+/// @return The number of heap allocations made by the program
+inline uint64_t heap_allocations()
+{
+    return counted_allocations.load();
+}
+
+void* operator new(std::size_t size)
+{
+    ++counted_allocations;
+
+    void *memory = std::malloc(size > 0 ? size : 1);
+
+    if(memory == 0)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    std::free(memory);
+}
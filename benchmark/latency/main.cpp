@@ -0,0 +1,529 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "codes.hpp"
+#include "../perf_counters.hpp"
+
+/// @return The current value of the time stamp counter of the CPU on x86,
+///         elsewhere the time in nanoseconds
+inline uint64_t read_clock()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/// Measures the latency of every encode(), decode() or recode() call
+/// and reports the distribution of the latencies. The calls are
+/// grouped by the position of the packet in the generation, e.g. to
+/// separate the packet completing the decoding.
+template<class Encoder, class Decoder>
+struct latency_benchmark : public gauge::benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    void start()
+    {
+        m_perf_counters.start();
+    }
+
+    void stop()
+    {
+        m_perf_counters.stop();
+    }
+
+    void store_run(gauge::table& results)
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        std::string position = cs.get_value<std::string>("position");
+
+        // Select the latencies of the packets at the position
+        std::vector<uint64_t> latencies;
+        latencies.reserve(m_latencies.size());
+
+        for(uint32_t i = 0; i < m_latencies.size(); ++i)
+        {
+            if(at_position(position, symbols, m_positions[i], m_last[i]))
+                latencies.push_back(m_latencies[i]);
+        }
+
+        assert(latencies.size() > 0);
+
+        std::sort(latencies.begin(), latencies.end());
+
+        uint64_t total = 0;
+
+        for(const auto& l : latencies)
+        {
+            total += l;
+        }
+
+        results.set_value("packets", latencies.size());
+        results.set_value("mean", double(total) / latencies.size());
+        results.set_value("p50", percentile(latencies, 0.5));
+        results.set_value("p90", percentile(latencies, 0.9));
+        results.set_value("p99", percentile(latencies, 0.99));
+        results.set_value("p99.9", percentile(latencies, 0.999));
+        results.set_value("max", latencies.back());
+
+        // The counters cover every packet of the run, whatever the
+        // position reported
+        m_perf_counters.store(results,
+                              uint64_t(m_blocks) * m_encoder->block_size());
+    }
+
+    /// @param position The position selected [all|q1|q2|q3|q4|last]
+    /// @param symbols The number of symbols in the generation
+    /// @param index The index of the packet in its block
+    /// @param last True if the packet was the last of its block
+    /// @return True if the packet is at the position
+    bool at_position(const std::string& position, uint32_t symbols,
+                     uint32_t index, bool last) const
+    {
+        if(position == "all")
+        {
+            return true;
+        }
+        else if(position == "last")
+        {
+            return last;
+        }
+
+        // The quarter of the generation, the packets received beyond
+        // the number of symbols belong to the last quarter
+        uint32_t quarter = std::min(index * 4 / symbols, 3U);
+
+        assert(position.size() == 2 && position[0] == 'q');
+        return quarter == uint32_t(position[1] - '1');
+    }
+
+    /// @param latencies The sorted latencies
+    /// @param fraction The fraction of the latencies below the
+    ///        percentile
+    /// @return The percentile using the nearest rank method
+    uint64_t percentile(const std::vector<uint64_t>& latencies,
+                        double fraction) const
+    {
+        assert(latencies.size() > 0);
+
+        uint32_t rank =
+            uint32_t(std::ceil(fraction * latencies.size()));
+
+        return latencies[std::max(rank, 1U) - 1];
+    }
+
+    std::string unit_text() const
+    {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+        return "cycles";
+#else
+        return "ns";
+#endif
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto types = options["type"].as<std::vector<std::string> >();
+        auto positions = options["position"].as<std::vector<std::string> >();
+
+        m_blocks = options["blocks"].as<uint32_t>();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(types.size() > 0);
+        assert(positions.size() > 0);
+        assert(m_blocks > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& t : types)
+                {
+                    for(const auto& q : positions)
+                    {
+                        gauge::config_set cs;
+                        cs.set_value<uint32_t>("symbols", s);
+                        cs.set_value<uint32_t>("symbol_size", p);
+                        cs.set_value<std::string>("type", t);
+                        cs.set_value<std::string>("position", q);
+
+                        add_configuration(cs);
+                    }
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_encoder = m_encoder_factory->build();
+        m_decoder = m_decoder_factory->build();
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_payload.resize(std::max(m_encoder->payload_size(),
+                                  m_decoder->payload_size()));
+
+        m_recoded_payload.resize(m_decoder->payload_size());
+
+        // Reserve room for a block of twice the symbols to keep the
+        // allocations out of the measurements
+        m_latencies.clear();
+        m_positions.clear();
+        m_last.clear();
+
+        m_latencies.reserve(2 * symbols * m_blocks);
+        m_positions.reserve(2 * symbols * m_blocks);
+        m_last.reserve(2 * symbols * m_blocks);
+    }
+
+    /// Prepares the encoder for a new block
+    void initialize_encoder()
+    {
+        m_encoder->initialize(*m_encoder_factory);
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        // We switch any systematic operations off so we code
+        // symbols from the beginning
+        if(kodo::is_systematic_encoder(m_encoder))
+            kodo::set_systematic_off(m_encoder);
+    }
+
+    /// Records the latency of a call
+    /// @param index The index of the packet in its block
+    /// @param start The clock before the call
+    /// @param stop The clock after the call
+    void record(uint32_t index, uint64_t start, uint64_t stop)
+    {
+        m_latencies.push_back(stop - start);
+        m_positions.push_back(index);
+        m_last.push_back(false);
+    }
+
+    /// Marks the latency recorded last as the last packet of a block
+    void record_last()
+    {
+        assert(m_last.size() > 0);
+        m_last.back() = true;
+    }
+
+    /// Measures the latency of encoding the symbols of a block
+    void encode_block()
+    {
+        initialize_encoder();
+
+        uint32_t symbols = m_encoder->symbols();
+
+        for(uint32_t i = 0; i < symbols; ++i)
+        {
+            uint64_t start = read_clock();
+            m_encoder->encode(&m_payload[0]);
+            uint64_t stop = read_clock();
+
+            record(i, start, stop);
+        }
+
+        record_last();
+    }
+
+    /// Measures the latency of decoding the symbols of a block
+    void decode_block()
+    {
+        initialize_encoder();
+        m_decoder->initialize(*m_decoder_factory);
+
+        for(uint32_t i = 0; !m_decoder->is_complete(); ++i)
+        {
+            m_encoder->encode(&m_payload[0]);
+
+            uint64_t start = read_clock();
+            m_decoder->decode(&m_payload[0]);
+            uint64_t stop = read_clock();
+
+            record(i, start, stop);
+        }
+
+        record_last();
+    }
+
+    /// Measures the latency of recoding a packet after each packet
+    /// received, as done by a relay
+    void recode_block()
+    {
+        initialize_encoder();
+        m_decoder->initialize(*m_decoder_factory);
+
+        for(uint32_t i = 0; !m_decoder->is_complete(); ++i)
+        {
+            m_encoder->encode(&m_payload[0]);
+            m_decoder->decode(&m_payload[0]);
+
+            uint64_t start = read_clock();
+            m_decoder->recode(&m_recoded_payload[0]);
+            uint64_t stop = read_clock();
+
+            record(i, start, stop);
+        }
+
+        record_last();
+    }
+
+    /// Run the benchmark
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        std::string type = cs.get_value<std::string>("type");
+
+        RUN{
+
+            for(uint32_t i = 0; i < m_blocks; ++i)
+            {
+                if(type == "encoder")
+                {
+                    encode_block();
+                }
+                else if(type == "decoder")
+                {
+                    decode_block();
+                }
+                else if(type == "recoder")
+                {
+                    recode_block();
+                }
+                else
+                {
+                    assert(0);
+                }
+            }
+        }
+    }
+
+protected:
+
+    /// The number of blocks coded per run
+    uint32_t m_blocks;
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder to use
+    encoder_ptr m_encoder;
+
+    /// The decoder to use
+    decoder_ptr m_decoder;
+
+    /// The data encoded
+    std::vector<uint8_t> m_encoded_data;
+
+    /// The buffer for the payloads
+    std::vector<uint8_t> m_payload;
+
+    /// The buffer for the recoded payloads
+    std::vector<uint8_t> m_recoded_payload;
+
+    /// The latency of every call
+    std::vector<uint64_t> m_latencies;
+
+    /// The index of the packet of every call in its block
+    std::vector<uint32_t> m_positions;
+
+    /// True for the calls of the last packet of a block
+    std::vector<bool> m_last;
+
+    /// The hardware counters of the measurement
+    perf_counters m_perf_counters;
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(latency_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(64);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<std::string> types;
+    types.push_back("encoder");
+    types.push_back("decoder");
+    types.push_back("recoder");
+
+    auto default_types =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            types, "")->multitoken();
+
+    std::vector<std::string> positions;
+    positions.push_back("all");
+    positions.push_back("q1");
+    positions.push_back("q2");
+    positions.push_back("q3");
+    positions.push_back("q4");
+    positions.push_back("last");
+
+    auto default_positions =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            positions, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("type", default_types, "Set type [encoder|decoder|recoder]");
+
+    options.add_options()
+        ("position", default_positions,
+         "Set the packets in the generation reported "
+         "[all|q1|q2|q3|q4|last], qN is the Nth quarter of the generation");
+
+    options.add_options()
+        ("blocks", gauge::po::value<uint32_t>()->default_value(100),
+         "Set the number of blocks coded per run");
+
+    gauge::runner::instance().register_options(options);
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_latency;
+
+BENCHMARK_F(setup_rlnc_latency, FullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_latency8;
+
+BENCHMARK_F(setup_rlnc_latency8, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_latency16;
+
+BENCHMARK_F(setup_rlnc_latency16, FullRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_delayed_rlnc_decoder<fifi::binary> >
+    setup_delayed_rlnc_latency;
+
+BENCHMARK_F(setup_delayed_rlnc_latency, FullDelayedRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_delayed_rlnc_decoder<fifi::binary8> >
+    setup_delayed_rlnc_latency8;
+
+BENCHMARK_F(setup_delayed_rlnc_latency8, FullDelayedRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef latency_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_delayed_rlnc_decoder<fifi::binary16> >
+    setup_delayed_rlnc_latency16;
+
+BENCHMARK_F(setup_delayed_rlnc_latency16, FullDelayedRLNC, Binary16, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/memory_policy.hpp>
+
+/// Benchmarks the decoding throughput of large blocks when the decoder
+/// memory is allocated using the different memory policies
+template<class Encoder, class Decoder>
+struct memory_policy_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    void init()
+    {
+        m_factor = 2;
+        gauge::time_benchmark::init();
+    }
+
+    void start()
+    {
+        m_decoded_symbols = 0;
+        gauge::time_benchmark::start();
+    }
+
+    double measurement()
+    {
+        // Get the time spent per iteration
+        double time = gauge::time_benchmark::measurement();
+
+        gauge::config_set cs = get_current_configuration();
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        // The bytes decoded per iteration
+        uint64_t bytes = (uint64_t(m_decoded_symbols) * symbol_size) /
+            gauge::time_benchmark::iteration_count();
+
+        return bytes / time; // MB/s for each iteration
+    }
+
+    void store_run(gauge::table& results)
+    {
+        results.set_value("throughput", measurement());
+    }
+
+    bool accept_measurement()
+    {
+        // Only accept the measurement if the decoding was successful
+        if(!m_decoder->is_complete())
+        {
+            // We did not generate enough payloads to decode successfully,
+            // so we will generate more payloads for next run
+            m_factor++;
+
+            return false;
+        }
+
+        return gauge::time_benchmark::accept_measurement();
+    }
+
+    std::string unit_text() const
+    {
+        return "MB/s";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto policies = options["policy"].as<std::vector<std::string> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(policies.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& m : policies)
+                {
+                    gauge::config_set cs;
+                    cs.set_value<uint32_t>("symbols", s);
+                    cs.set_value<uint32_t>("symbol_size", p);
+                    cs.set_value<std::string>("policy", m);
+
+                    add_configuration(cs);
+                }
+            }
+        }
+    }
+
+    /// @param name The name of a policy given on the command line
+    /// @return The memory policy
+    kodo::memory_policy make_policy(const std::string &name) const
+    {
+        kodo::memory_policy policy;
+
+        if(name == "transparent" || name == "transparent_numa")
+        {
+            policy.m_huge_pages =
+                kodo::memory_policy::huge_pages_transparent;
+        }
+        else if(name == "explicit" || name == "explicit_numa")
+        {
+            policy.m_huge_pages = kodo::memory_policy::huge_pages_explicit;
+        }
+        else
+        {
+            assert(name == "heap" || name == "numa");
+        }
+
+        policy.m_numa_local = name == "numa" ||
+            name == "transparent_numa" || name == "explicit_numa";
+
+        return policy;
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        std::string policy = cs.get_value<std::string>("policy");
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        // A new decoder factory is needed for every configuration since
+        // the policy is used when the decoder memory is allocated
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory->set_memory_policy(make_policy(policy));
+
+        m_encoder = m_encoder_factory->build();
+        m_decoder = m_decoder_factory->build();
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        // We switch any systematic operations off so we code
+        // symbols from the beginning
+        if(kodo::is_systematic_encoder(m_encoder))
+            kodo::set_systematic_off(m_encoder);
+
+        uint32_t payload_count = symbols * m_factor;
+
+        m_payloads.resize(payload_count);
+        for(auto& payload : m_payloads)
+        {
+            payload.resize(m_encoder->payload_size());
+            m_encoder->encode(&payload[0]);
+        }
+
+        m_temp_payload.resize(m_encoder->payload_size());
+    }
+
+    void run_benchmark()
+    {
+        RUN{
+            // We have to make sure the decoder is in a "clean" state
+            // i.e. no symbols already decoded.
+            m_decoder->initialize(*m_decoder_factory);
+
+            for(const auto& payload : m_payloads)
+            {
+                std::copy(payload.begin(), payload.end(),
+                          m_temp_payload.begin());
+
+                m_decoder->decode(&m_temp_payload[0]);
+
+                ++m_decoded_symbols;
+
+                if(m_decoder->is_complete())
+                    break;
+            }
+        }
+    }
+
+protected:
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The encoder to use
+    encoder_ptr m_encoder;
+
+    /// The decoder to use
+    decoder_ptr m_decoder;
+
+    /// The number of symbols decoded
+    uint32_t m_decoded_symbols;
+
+    /// The data encoded
+    std::vector<uint8_t> m_encoded_data;
+
+    /// Temporary payload to not destroy the already encoded payloads
+    /// when decoding
+    std::vector<uint8_t> m_temp_payload;
+
+    /// Storage for encoded symbols
+    std::vector< std::vector<uint8_t> > m_payloads;
+
+    /// Multiplication factor for payload_count
+    uint32_t m_factor;
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(memory_policy_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(64);
+    symbols.push_back(128);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(65536);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<std::string> policies;
+    policies.push_back("heap");
+    policies.push_back("transparent");
+    policies.push_back("explicit");
+    policies.push_back("numa");
+    policies.push_back("transparent_numa");
+
+    auto default_policies =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            policies, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("policy", default_policies, "Set the memory policy [heap|"
+         "transparent|explicit|numa|transparent_numa|explicit_numa]");
+
+    gauge::runner::instance().register_options(options);
+}
+
+typedef memory_policy_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_memory_policy;
+
+BENCHMARK_F(setup_memory_policy, FullRLNC, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef memory_policy_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_memory_policy8;
+
+BENCHMARK_F(setup_memory_policy8, FullRLNC, Binary8, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/linear_block_decoder_delayed.hpp>
+
+namespace kodo
+{
+
+    /// RLNC decoder using Gaussian elimination decoder, delayed
+    /// here refers to the fact the we will not perform the backwards
+    /// substitution until we have reached full rank. Apart from that it
+    /// is built as the full_rlnc_decoder, so the memory usage compares.
+    template<class Field>
+    class full_delayed_rlnc_decoder
+        : public // Payload API
+                 inline_payload_recoder<
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder_delayed<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_delayed_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+}
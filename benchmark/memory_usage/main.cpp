@@ -0,0 +1,465 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/rlnc/fixed_full_vector_codes.hpp>
+#include <kodo/rlnc/seed_codes.hpp>
+#include <kodo/rs/reed_solomon_codes.hpp>
+#include <kodo/nocode/carousel_codes.hpp>
+
+#include "codes.hpp"
+
+/// Reports the memory held by a coder and its factory as returned by
+/// memory_usage(). The results are:
+/// - coder: The bytes held by a coder built by a new factory
+/// - pooled: The bytes the factory holds for the coder once it is
+///   returned to the pool, i.e. what an idle coder costs
+/// - factory: The bytes held by the factory while the coder is in use,
+///   e.g. the field tables shared by the coders
+template<class Coder>
+struct memory_usage_benchmark : public gauge::benchmark
+{
+
+    typedef typename Coder::factory factory_type;
+    typedef typename Coder::pointer pointer;
+
+    memory_usage_benchmark()
+        : m_coder(0),
+          m_pooled(0),
+          m_factory(0)
+    { }
+
+    void start()
+    { }
+
+    void stop()
+    { }
+
+    void store_run(gauge::table& results)
+    {
+        results.set_value("coder", m_coder);
+        results.set_value("pooled", m_pooled);
+        results.set_value("factory", m_factory);
+    }
+
+    std::string unit_text() const
+    {
+        return "bytes";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                gauge::config_set cs;
+                cs.set_value<uint32_t>("symbols", s);
+                cs.set_value<uint32_t>("symbol_size", p);
+
+                add_configuration(cs);
+            }
+        }
+    }
+
+    /// Run the benchmark
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        RUN{
+
+            // A new factory every run so the pool starts out empty
+            factory_type factory(symbols, symbol_size);
+
+            pointer coder = factory.build();
+
+            m_coder = coder->memory_usage();
+            m_factory = factory.memory_usage();
+
+            coder.reset();
+
+            m_pooled = factory.memory_usage() - m_factory;
+        }
+    }
+
+protected:
+
+    /// The bytes held by the coder
+    uint64_t m_coder;
+
+    /// The bytes held by the factory for the coder in its pool
+    uint64_t m_pooled;
+
+    /// The bytes held by the factory with the coder in use
+    uint64_t m_factory;
+
+};
+
+/// Benchmark of a coder whose number of symbols and symbol size are
+/// fixed at compile time, so only the fixed configuration is run
+template<class Coder, uint32_t Symbols, uint32_t SymbolSize>
+struct fixed_memory_usage_benchmark : public memory_usage_benchmark<Coder>
+{
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        (void) options;
+
+        gauge::config_set cs;
+        cs.set_value<uint32_t>("symbols", Symbols);
+        cs.set_value<uint32_t>("symbol_size", SymbolSize);
+
+        this->add_configuration(cs);
+    }
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(memory_usage_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(64);
+    symbols.push_back(128);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(100);
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    gauge::runner::instance().register_options(options);
+}
+
+//------------------------------------------------------------------
+// FullRLNCEncoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary> > setup_rlnc_encoder;
+
+BENCHMARK_F(setup_rlnc_encoder, FullRLNCEncoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8> > setup_rlnc_encoder8;
+
+BENCHMARK_F(setup_rlnc_encoder8, FullRLNCEncoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16> > setup_rlnc_encoder16;
+
+BENCHMARK_F(setup_rlnc_encoder16, FullRLNCEncoder, Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullRLNCDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_decoder;
+
+BENCHMARK_F(setup_rlnc_decoder, FullRLNCDecoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_decoder8;
+
+BENCHMARK_F(setup_rlnc_decoder8, FullRLNCDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_decoder16;
+
+BENCHMARK_F(setup_rlnc_decoder16, FullRLNCDecoder, Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullRLNCRunningRecodingDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_running_recoding_decoder<fifi::binary> >
+    setup_rlnc_running;
+
+BENCHMARK_F(setup_rlnc_running, FullRLNCRunningRecodingDecoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_running_recoding_decoder<fifi::binary8> >
+    setup_rlnc_running8;
+
+BENCHMARK_F(setup_rlnc_running8, FullRLNCRunningRecodingDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_running_recoding_decoder<fifi::binary16> >
+    setup_rlnc_running16;
+
+BENCHMARK_F(setup_rlnc_running16, FullRLNCRunningRecodingDecoder,
+            Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullRLNCRelay
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_relay<fifi::binary> > setup_rlnc_relay;
+
+BENCHMARK_F(setup_rlnc_relay, FullRLNCRelay, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_relay<fifi::binary8> > setup_rlnc_relay8;
+
+BENCHMARK_F(setup_rlnc_relay8, FullRLNCRelay, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_relay<fifi::binary16> > setup_rlnc_relay16;
+
+BENCHMARK_F(setup_rlnc_relay16, FullRLNCRelay, Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullRLNCLendingDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_lending_decoder<fifi::binary8> > setup_rlnc_lending8;
+
+BENCHMARK_F(setup_rlnc_lending8, FullRLNCLendingDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullRLNCPaddingAwareDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_rlnc_padding_aware_decoder<fifi::binary8> >
+    setup_rlnc_padding_aware8;
+
+BENCHMARK_F(setup_rlnc_padding_aware8, FullRLNCPaddingAwareDecoder,
+            Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FullDelayedRLNCDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::full_delayed_rlnc_decoder<fifi::binary8> > setup_rlnc_delayed8;
+
+BENCHMARK_F(setup_rlnc_delayed8, FullDelayedRLNCDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// FixedFullRLNCDecoder
+//------------------------------------------------------------------
+
+typedef fixed_memory_usage_benchmark<
+    kodo::fixed_full_rlnc_decoder<fifi::binary8, 64, 1600>, 64, 1600>
+    setup_rlnc_fixed8;
+
+BENCHMARK_F(setup_rlnc_fixed8, FixedFullRLNCDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// SeedRLNCEncoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_encoder<fifi::binary> > setup_seed_encoder;
+
+BENCHMARK_F(setup_seed_encoder, SeedRLNCEncoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_encoder<fifi::binary8> > setup_seed_encoder8;
+
+BENCHMARK_F(setup_seed_encoder8, SeedRLNCEncoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_encoder<fifi::binary16> > setup_seed_encoder16;
+
+BENCHMARK_F(setup_seed_encoder16, SeedRLNCEncoder, Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// SeedRLNCDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_decoder<fifi::binary> > setup_seed_decoder;
+
+BENCHMARK_F(setup_seed_decoder, SeedRLNCDecoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_decoder<fifi::binary8> > setup_seed_decoder8;
+
+BENCHMARK_F(setup_seed_decoder8, SeedRLNCDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<
+    kodo::seed_rlnc_decoder<fifi::binary16> > setup_seed_decoder16;
+
+BENCHMARK_F(setup_seed_decoder16, SeedRLNCDecoder, Binary16, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// CompactSeedRLNCEncoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::compact_seed_rlnc_encoder<fifi::binary8> >
+    setup_compact_seed_encoder8;
+
+BENCHMARK_F(setup_compact_seed_encoder8, CompactSeedRLNCEncoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// RSEncoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::rs_encoder<fifi::binary8> > setup_rs_encoder8;
+
+BENCHMARK_F(setup_rs_encoder8, RSEncoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// RSDecoder
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<
+    kodo::rs_decoder<fifi::binary8> > setup_rs_decoder8;
+
+BENCHMARK_F(setup_rs_decoder8, RSDecoder, Binary8, 1)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// NoCodeCarousel
+//------------------------------------------------------------------
+
+typedef memory_usage_benchmark<kodo::nocode_carousel_encoder>
+    setup_nocode_encoder;
+
+BENCHMARK_F(setup_nocode_encoder, NoCodeCarouselEncoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+typedef memory_usage_benchmark<kodo::nocode_carousel_decoder>
+    setup_nocode_decoder;
+
+BENCHMARK_F(setup_nocode_decoder, NoCodeCarouselDecoder, Binary, 1)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
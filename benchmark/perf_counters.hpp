@@ -0,0 +1,267 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <gauge/gauge.hpp>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+/// @brief Hardware performance counters of the calling thread, which
+///        the benchmarks attach to their results.
+///
+/// The counters are read through perf_event_open() on Linux, and count
+/// the user space events of the thread calling start() and stop(). An
+/// event the kernel or CPU does not provide, e.g. in a virtual machine
+/// or with a restrictive perf_event_paranoid setting, is left out of
+/// the results, on other platforms all of them are. The counters are
+/// scaled if the kernel multiplexes them.
+///
+/// The results are normalized by the bytes coded, so they compare
+/// across symbol sizes:
+/// - cycles_per_byte: CPU cycles per byte
+/// - ipc: Instructions per cycle
+/// - l1d_misses: L1 data cache read misses per kilobyte
+/// - llc_misses: Last level cache misses per kilobyte
+/// - branch_misses: Mispredicted branches per kilobyte
+///
+/// The generic perf events do not include the L2 cache, which
+/// therefore is not reported.
+class perf_counters : boost::noncopyable
+{
+public:
+
+    /// Constructor
+    perf_counters()
+        : m_opened(false)
+    { }
+
+    /// Destructor
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for(const auto& e : m_events)
+        {
+            close(e.m_fd);
+        }
+#endif
+    }
+
+    /// Resets and starts the counters, they are opened on the first call
+    void start()
+    {
+        if(!m_opened)
+        {
+            open();
+            m_opened = true;
+        }
+
+#if defined(__linux__)
+        for(auto& e : m_events)
+        {
+            e.m_value = 0;
+
+            ioctl(e.m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(e.m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /// Stops the counters and reads them
+    void stop()
+    {
+#if defined(__linux__)
+        for(auto& e : m_events)
+        {
+            ioctl(e.m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+
+        for(auto& e : m_events)
+        {
+            // The value followed by the time enabled and running
+            uint64_t data[3] = { 0, 0, 0 };
+
+            if(read(e.m_fd, data, sizeof(data)) != sizeof(data) ||
+               data[2] == 0)
+            {
+                continue;
+            }
+
+            e.m_value = data[0];
+
+            // Scale the value if the counter was multiplexed
+            if(data[2] < data[1])
+            {
+                e.m_value = uint64_t(double(data[0]) * data[1] / data[2]);
+            }
+        }
+#endif
+    }
+
+    /// @return True if any counter is available
+    bool available() const
+    {
+        return !m_events.empty();
+    }
+
+    /// @param name The name of a counter
+    /// @return The value of the counter read by the last stop(), zero if
+    ///         the counter is not available
+    uint64_t value(const std::string& name) const
+    {
+        for(const auto& e : m_events)
+        {
+            if(name == e.m_name)
+                return e.m_value;
+        }
+
+        return 0;
+    }
+
+    /// Adds the available counters to the results
+    /// @param results The results of the run
+    /// @param bytes The bytes coded between start() and stop() by the
+    ///        thread counted
+    void store(gauge::table& results, uint64_t bytes) const
+    {
+        if(bytes == 0)
+            return;
+
+        double kilobytes = bytes / 1024.0;
+
+        for(const auto& e : m_events)
+        {
+            std::string name = e.m_name;
+
+            if(name == "cycles")
+            {
+                results.set_value("cycles_per_byte",
+                                  double(e.m_value) / bytes);
+            }
+            else if(name == "instructions")
+            {
+                if(!has_event("cycles"))
+                    continue;
+
+                uint64_t cycles = value("cycles");
+
+                results.set_value("ipc", cycles > 0 ?
+                                  double(e.m_value) / cycles : 0.0);
+            }
+            else
+            {
+                results.set_value(name, e.m_value / kilobytes);
+            }
+        }
+    }
+
+private:
+
+    /// @param name The name of a counter
+    /// @return True if the counter is available
+    bool has_event(const std::string& name) const
+    {
+        for(const auto& e : m_events)
+        {
+            if(name == e.m_name)
+                return true;
+        }
+
+        return false;
+    }
+
+    /// Opens the counters, the ones which cannot be opened are skipped
+    void open()
+    {
+#if defined(__linux__)
+        uint64_t l1d_read_miss = PERF_COUNT_HW_CACHE_L1D |
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+            (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        open_event("cycles", PERF_TYPE_HARDWARE,
+                   PERF_COUNT_HW_CPU_CYCLES);
+
+        open_event("instructions", PERF_TYPE_HARDWARE,
+                   PERF_COUNT_HW_INSTRUCTIONS);
+
+        open_event("l1d_misses", PERF_TYPE_HW_CACHE, l1d_read_miss);
+
+        open_event("llc_misses", PERF_TYPE_HARDWARE,
+                   PERF_COUNT_HW_CACHE_MISSES);
+
+        open_event("branch_misses", PERF_TYPE_HARDWARE,
+                   PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+#if defined(__linux__)
+
+    /// Opens a counter of the calling thread
+    /// @param name The name of the counter
+    /// @param type The perf event type
+    /// @param config The perf event of the type
+    void open_event(const char *name, uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+            PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+
+        if(fd < 0)
+            return;
+
+        event e;
+        e.m_name = name;
+        e.m_fd = fd;
+        e.m_value = 0;
+
+        m_events.push_back(e);
+    }
+
+#endif
+
+private:
+
+    /// An open counter
+    struct event
+    {
+        /// The name of the counter
+        const char *m_name;
+
+        /// The file descriptor of the counter
+        int m_fd;
+
+        /// The value read by the last stop()
+        uint64_t m_value;
+    };
+
+    /// True once the counters have been opened
+    bool m_opened;
+
+    /// The counters which could be opened
+    std::vector<event> m_events;
+};
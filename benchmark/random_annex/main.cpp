@@ -0,0 +1,316 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/random_annex_encoder.hpp>
+#include <kodo/random_annex_decoder.hpp>
+#include <kodo/rfc5052_partitioning_scheme.hpp>
+
+/// Benchmarks the time needed to decode an object using the random annex
+/// code. The decoding time includes building the annex and the decoders,
+/// decoding every block and propagating the decoded symbols through the
+/// annex.
+template<class Encoder, class Decoder>
+struct random_annex_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+
+    typedef kodo::random_annex_encoder<
+        Encoder, kodo::rfc5052_partitioning_scheme> object_encoder;
+
+    typedef kodo::random_annex_decoder<
+        Decoder, kodo::rfc5052_partitioning_scheme> object_decoder;
+
+    void init()
+    {
+        m_factor = 2;
+        gauge::time_benchmark::init();
+    }
+
+    void store_run(gauge::table& results)
+    {
+        results.set_value("time", measurement());
+        results.set_value("decoded", m_decoded_blocks);
+    }
+
+    bool accept_measurement()
+    {
+        // Only accept the measurement if all blocks were decoded
+        if(m_decoded_blocks < m_encoded_payloads.size())
+        {
+            // We did not generate enough payloads to decode successfully,
+            // so we will generate more payloads for next run
+            m_factor++;
+
+            return false;
+        }
+
+        return gauge::time_benchmark::accept_measurement();
+    }
+
+    std::string unit_text() const
+    {
+        return "microseconds";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto blocks = options["blocks"].as<std::vector<uint32_t> >();
+        auto annex = options["annex"].as<std::vector<uint32_t> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(blocks.size() > 0);
+        assert(annex.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& b : blocks)
+                {
+                    for(const auto& a : annex)
+                    {
+                        // The annex must leave room for the base block
+                        if(a >= s)
+                            continue;
+
+                        gauge::config_set cs;
+                        cs.set_value<uint32_t>("symbols", s);
+                        cs.set_value<uint32_t>("symbol_size", p);
+                        cs.set_value<uint32_t>("blocks", b);
+                        cs.set_value<uint32_t>("annex", a);
+
+                        add_configuration(cs);
+                    }
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        uint32_t blocks = cs.get_value<uint32_t>("blocks");
+        uint32_t annex = cs.get_value<uint32_t>("annex");
+
+        // The object is sized so the base blocks fit the requested
+        // number of blocks
+        uint32_t object_size = blocks * (symbols - annex) * symbol_size;
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_object.resize(object_size);
+
+        for(uint8_t &e : m_object)
+        {
+            e = rand() % 256;
+        }
+
+        object_encoder encoder(annex, *m_encoder_factory,
+                               sak::storage(m_object));
+
+        // Encode enough payloads for every block
+        m_encoded_payloads.resize(encoder.encoders());
+
+        for(uint32_t i = 0; i < encoder.encoders(); ++i)
+        {
+            encoder_ptr e = encoder.build(i);
+
+            if(kodo::is_systematic_encoder(e))
+                kodo::set_systematic_off(e);
+
+            std::vector< std::vector<uint8_t> > &payloads =
+                m_encoded_payloads[i];
+
+            payloads.resize(e->symbols() * m_factor);
+
+            for(auto& payload : payloads)
+            {
+                payload.resize(e->payload_size());
+                e->encode(&payload[0]);
+            }
+
+            m_temp_payload.resize(e->payload_size());
+        }
+    }
+
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t annex = cs.get_value<uint32_t>("annex");
+
+        RUN{
+
+            object_decoder decoder(annex, *m_decoder_factory,
+                                   m_object.size());
+
+            assert(decoder.decoders() == m_encoded_payloads.size());
+
+            m_decoded_blocks = 0;
+
+            for(uint32_t i = 0; i < decoder.decoders(); ++i)
+            {
+                auto d = decoder.build(i);
+
+                for(const auto& payload : m_encoded_payloads[i])
+                {
+                    // The block may be completed by symbols propagated
+                    // from blocks decoded earlier
+                    if(d->is_complete())
+                        break;
+
+                    std::copy(payload.begin(), payload.end(),
+                              m_temp_payload.begin());
+
+                    d->decode(&m_temp_payload[0]);
+                }
+            }
+
+            for(uint32_t i = 0; i < decoder.decoders(); ++i)
+            {
+                if(decoder.build(i)->is_complete())
+                    ++m_decoded_blocks;
+            }
+        }
+    }
+
+protected:
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The object encoded
+    std::vector<uint8_t> m_object;
+
+    /// Storage for the encoded payloads of every block
+    std::vector< std::vector< std::vector<uint8_t> > > m_encoded_payloads;
+
+    /// Temporary payload to not destroy the already encoded payloads
+    /// when decoding
+    std::vector<uint8_t> m_temp_payload;
+
+    /// The number of blocks decoded in the last run
+    uint32_t m_decoded_blocks;
+
+    /// Multiplication factor for the number of payloads per block
+    uint32_t m_factor;
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(random_annex_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(32);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(64);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<uint32_t> blocks;
+    blocks.push_back(16);
+    blocks.push_back(128);
+    blocks.push_back(1024);
+    blocks.push_back(4096);
+
+    auto default_blocks =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            blocks, "")->multitoken();
+
+    std::vector<uint32_t> annex;
+    annex.push_back(4);
+    annex.push_back(8);
+
+    auto default_annex =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            annex, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols per block");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("blocks", default_blocks, "Set the number of blocks");
+
+    options.add_options()
+        ("annex", default_annex, "Set the annex size in symbols");
+
+    gauge::runner::instance().register_options(options);
+}
+
+typedef random_annex_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_random_annex;
+
+BENCHMARK_F(setup_random_annex, RandomAnnex, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef random_annex_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_random_annex8;
+
+BENCHMARK_F(setup_random_annex8, RandomAnnex, Binary8, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
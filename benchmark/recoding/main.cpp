@@ -0,0 +1,869 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+
+#include <gauge/gauge.hpp>
+#include <gauge/console_printer.hpp>
+#include <gauge/python_printer.hpp>
+#include <gauge/csv_printer.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "codes.hpp"
+#include "../perf_counters.hpp"
+
+/// Measures the throughput of the recode() function of a decoder
+/// holding a fraction of the symbols of the block
+template<class Encoder, class Decoder>
+struct recoding_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    void start()
+    {
+        m_recoded_symbols = 0;
+
+        m_perf_counters.start();
+        gauge::time_benchmark::start();
+    }
+
+    void stop()
+    {
+        gauge::time_benchmark::stop();
+        m_perf_counters.stop();
+    }
+
+    double measurement()
+    {
+        // Get the time spent per iteration
+        double time = gauge::time_benchmark::measurement();
+
+        gauge::config_set cs = get_current_configuration();
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        // The bytes recoded per iteration
+        uint64_t bytes = (m_recoded_symbols * symbol_size) /
+            gauge::time_benchmark::iteration_count();
+
+        return bytes / time; // MB/s for each iteration
+    }
+
+    void store_run(gauge::table& results)
+    {
+        results.set_value("throughput", measurement());
+
+        double time = gauge::time_benchmark::measurement();
+        double payloads = double(m_recoded_symbols) /
+            gauge::time_benchmark::iteration_count();
+
+        // The time is measured in microseconds
+        results.set_value("payloads", payloads / time * 1000000.0);
+        results.set_value("decoder_rank", m_decoder->rank());
+
+        gauge::config_set cs = get_current_configuration();
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        m_perf_counters.store(results, m_recoded_symbols * symbol_size);
+    }
+
+    std::string unit_text() const
+    {
+        return "MB/s";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto rank = options["rank"].as<std::vector<double> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(rank.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& r : rank)
+                {
+                    assert(r >= 0.0 && r <= 1.0);
+
+                    gauge::config_set cs;
+                    cs.set_value<uint32_t>("symbols", s);
+                    cs.set_value<uint32_t>("symbol_size", p);
+                    cs.set_value<double>("rank", r);
+
+                    add_configuration(cs);
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        double rank = cs.get_value<double>("rank");
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_encoder = m_encoder_factory->build();
+        m_decoder = m_decoder_factory->build();
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        // Coded symbols are received as they would be by a relay
+        if(kodo::is_systematic_encoder(m_encoder))
+            kodo::set_systematic_off(m_encoder);
+
+        m_payload.resize(std::max(m_encoder->payload_size(),
+                                  m_decoder->payload_size()));
+
+        // Bring the decoder to the rank benchmarked
+        uint32_t target_rank =
+            std::min(uint32_t(rank * symbols + 0.5), symbols);
+
+        while(m_decoder->rank() < target_rank)
+        {
+            m_encoder->encode(&m_payload[0]);
+            m_decoder->decode(&m_payload[0]);
+        }
+    }
+
+    /// Run the recoder
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+
+        // The clock is running
+        RUN{
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                m_decoder->recode(&m_payload[0]);
+                ++m_recoded_symbols;
+            }
+        }
+    }
+
+protected:
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder producing the symbols received by the decoder
+    encoder_ptr m_encoder;
+
+    /// The decoder recoding
+    decoder_ptr m_decoder;
+
+    /// The data encoded
+    std::vector<uint8_t> m_encoded_data;
+
+    /// The buffer for the payloads
+    std::vector<uint8_t> m_payload;
+
+    /// The number of symbols recoded
+    uint64_t m_recoded_symbols;
+
+    /// The hardware counters of the measurement
+    perf_counters m_perf_counters;
+
+};
+
+/// A link of the simulated network, carrying one payload per round
+/// from one node to another
+struct network_link
+{
+    /// The index of the sending node
+    uint32_t m_from;
+
+    /// The index of the receiving node
+    uint32_t m_to;
+};
+
+/// Transfers a block from a source through a network of relays to one
+/// or more sinks. Every link carries one payload per round and erases
+/// it with the configured probability. The relays recode a payload for
+/// each of their outgoing links.
+///
+/// The nodes are numbered with the source first, then the relays and
+/// the sinks last. Two topologies are supported:
+///
+/// - line: a chain of hops links with hops - 1 relays and one sink.
+/// - butterfly: the source S sends to the relays A and B, which both
+///   send to the relay C. C sends to the relay D over the bottleneck
+///   link and the sinks T1 and T2 receive from A and D respectively B
+///   and D.
+template<class Encoder, class Relay, class Decoder>
+struct relay_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Encoder::pointer encoder_ptr;
+
+    typedef typename Relay::factory relay_factory;
+    typedef typename Relay::pointer relay_ptr;
+
+    typedef typename Decoder::factory decoder_factory;
+    typedef typename Decoder::pointer decoder_ptr;
+
+    /// The clock used to measure the time spent in each node
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    void start()
+    {
+        std::fill(m_node_time.begin(), m_node_time.end(), 0.0);
+
+        m_source_payloads = 0;
+        m_transmissions = 0;
+
+        m_perf_counters.start();
+        gauge::time_benchmark::start();
+    }
+
+    void stop()
+    {
+        gauge::time_benchmark::stop();
+        m_perf_counters.stop();
+    }
+
+    double measurement()
+    {
+        // Get the time spent per iteration i.e. per block
+        double time = gauge::time_benchmark::measurement();
+
+        return m_encoder->block_size() / time; // MB/s for each block
+    }
+
+    void store_run(gauge::table& results)
+    {
+        double iterations =
+            double(gauge::time_benchmark::iteration_count());
+
+        uint32_t relays = m_relays.size();
+        uint32_t sinks = m_sinks.size();
+
+        double relay_time = 0.0;
+        double max_relay_time = 0.0;
+
+        for(uint32_t i = 0; i < relays; ++i)
+        {
+            relay_time += m_node_time[1 + i];
+            max_relay_time = std::max(max_relay_time, m_node_time[1 + i]);
+        }
+
+        double sink_time = 0.0;
+
+        for(uint32_t i = 0; i < sinks; ++i)
+        {
+            sink_time += m_node_time[1 + relays + i];
+        }
+
+        // The times are spent per block in microseconds, for the relays
+        // and sinks the mean per node is reported
+        results.set_value("goodput", measurement());
+        results.set_value("source_time", m_node_time[0] / iterations);
+
+        results.set_value("relay_time", relays > 0 ?
+                          relay_time / relays / iterations : 0.0);
+
+        results.set_value("max_relay_time", max_relay_time / iterations);
+        results.set_value("sink_time", sink_time / sinks / iterations);
+
+        // The payloads sent by the source per symbol, and by all nodes
+        // per block
+        gauge::config_set cs = get_current_configuration();
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+
+        results.set_value("overhead",
+                          m_source_payloads / iterations / symbols);
+
+        results.set_value("transmissions", m_transmissions / iterations);
+
+        // All nodes run on the calling thread, the bytes are the blocks
+        // delivered
+        m_perf_counters.store(results, uint64_t(
+            m_encoder->block_size() * iterations));
+    }
+
+    std::string unit_text() const
+    {
+        return "MB/s";
+    }
+
+    void get_options(gauge::po::variables_map& options)
+    {
+        auto symbols = options["symbols"].as<std::vector<uint32_t> >();
+        auto symbol_size = options["symbol_size"].as<std::vector<uint32_t> >();
+        auto topology = options["topology"].as<std::vector<std::string> >();
+        auto hops = options["hops"].as<std::vector<uint32_t> >();
+        auto erasure = options["erasure"].as<std::vector<double> >();
+
+        assert(symbols.size() > 0);
+        assert(symbol_size.size() > 0);
+        assert(topology.size() > 0);
+        assert(hops.size() > 0);
+        assert(erasure.size() > 0);
+
+        for(const auto& s : symbols)
+        {
+            for(const auto& p : symbol_size)
+            {
+                for(const auto& t : topology)
+                {
+                    // The butterfly has a fixed number of hops from the
+                    // source to the sinks
+                    std::vector<uint32_t> topology_hops = hops;
+
+                    if(t == "butterfly")
+                    {
+                        topology_hops.assign(1, 4);
+                    }
+                    else
+                    {
+                        assert(t == "line");
+                    }
+
+                    for(const auto& h : topology_hops)
+                    {
+                        for(const auto& e : erasure)
+                        {
+                            assert(h > 0);
+                            assert(e >= 0.0 && e < 1.0);
+
+                            gauge::config_set cs;
+                            cs.set_value<uint32_t>("symbols", s);
+                            cs.set_value<uint32_t>("symbol_size", p);
+                            cs.set_value<std::string>("topology", t);
+                            cs.set_value<uint32_t>("hops", h);
+                            cs.set_value<double>("erasure", e);
+
+                            add_configuration(cs);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void setup()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        std::string topology = cs.get_value<std::string>("topology");
+        uint32_t hops = cs.get_value<uint32_t>("hops");
+
+        m_erasure = cs.get_value<double>("erasure");
+
+        uint32_t relays = 0;
+        uint32_t sinks = 0;
+
+        m_links.clear();
+
+        if(topology == "line")
+        {
+            relays = hops - 1;
+            sinks = 1;
+
+            for(uint32_t i = 0; i < hops; ++i)
+            {
+                add_link(i, i + 1);
+            }
+        }
+        else if(topology == "butterfly")
+        {
+            relays = 4;
+            sinks = 2;
+
+            // The nodes are S = 0, A = 1, B = 2, C = 3, D = 4, T1 = 5
+            // and T2 = 6. The links are listed in the order the payloads
+            // travel in a round.
+            add_link(0, 1);
+            add_link(0, 2);
+            add_link(1, 3);
+            add_link(2, 3);
+            add_link(3, 4);
+            add_link(1, 5);
+            add_link(4, 5);
+            add_link(2, 6);
+            add_link(4, 6);
+        }
+        else
+        {
+            assert(0);
+        }
+
+        m_encoder_factory = std::make_shared<encoder_factory>(
+            symbols, symbol_size);
+
+        m_relay_factory = std::make_shared<relay_factory>(
+            symbols, symbol_size);
+
+        m_decoder_factory = std::make_shared<decoder_factory>(
+            symbols, symbol_size);
+
+        m_encoder = m_encoder_factory->build();
+
+        m_relays.resize(relays);
+        for(auto& relay : m_relays)
+        {
+            relay = m_relay_factory->build();
+        }
+
+        m_sinks.resize(sinks);
+        for(auto& sink : m_sinks)
+        {
+            sink = m_decoder_factory->build();
+        }
+
+        m_node_time.resize(1 + relays + sinks);
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_payload.resize(std::max(m_encoder_factory->max_payload_size(),
+                         std::max(m_relay_factory->max_payload_size(),
+                                  m_decoder_factory->max_payload_size())));
+    }
+
+    /// Adds a link to the network
+    /// @param from The index of the sending node
+    /// @param to The index of the receiving node
+    void add_link(uint32_t from, uint32_t to)
+    {
+        network_link l;
+        l.m_from = from;
+        l.m_to = to;
+
+        m_links.push_back(l);
+    }
+
+    /// @return True if all sinks decoded the block
+    bool sinks_complete() const
+    {
+        for(const auto& sink : m_sinks)
+        {
+            if(!sink->is_complete())
+                return false;
+        }
+
+        return true;
+    }
+
+    /// Sends a payload over a link
+    /// @param l The link
+    void send(const network_link& l)
+    {
+        if(l.m_from == 0)
+        {
+            clock_type::time_point start = clock_type::now();
+            m_encoder->encode(&m_payload[0]);
+            add_time(0, start);
+
+            ++m_source_payloads;
+        }
+        else
+        {
+            const relay_ptr& relay = m_relays[l.m_from - 1];
+
+            // A relay holding no symbols has nothing to send
+            if(relay->rank() == 0)
+                return;
+
+            clock_type::time_point start = clock_type::now();
+            relay->recode(&m_payload[0]);
+            add_time(l.m_from, start);
+        }
+
+        ++m_transmissions;
+
+        if(double(rand()) / RAND_MAX < m_erasure)
+            return;
+
+        if(l.m_to <= m_relays.size())
+        {
+            clock_type::time_point start = clock_type::now();
+            m_relays[l.m_to - 1]->decode(&m_payload[0]);
+            add_time(l.m_to, start);
+        }
+        else
+        {
+            const decoder_ptr& sink = m_sinks[l.m_to - 1 - m_relays.size()];
+
+            if(sink->is_complete())
+                return;
+
+            clock_type::time_point start = clock_type::now();
+            sink->decode(&m_payload[0]);
+            add_time(l.m_to, start);
+        }
+    }
+
+    /// Adds the time elapsed to the time spent in a node
+    /// @param node The index of the node
+    /// @param start The time the node started working
+    void add_time(uint32_t node, const clock_type::time_point& start)
+    {
+        m_node_time[node] += std::chrono::duration<double, std::micro>(
+            clock_type::now() - start).count();
+    }
+
+    /// Run the network
+    void run_benchmark()
+    {
+        gauge::config_set cs = get_current_configuration();
+
+        uint32_t symbols = cs.get_value<uint32_t>("symbols");
+        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+
+        m_encoder_factory->set_symbols(symbols);
+        m_encoder_factory->set_symbol_size(symbol_size);
+
+        m_relay_factory->set_symbols(symbols);
+        m_relay_factory->set_symbol_size(symbol_size);
+
+        m_decoder_factory->set_symbols(symbols);
+        m_decoder_factory->set_symbol_size(symbol_size);
+
+        // The clock is running
+        RUN{
+            // We have to make sure the coders are in a "clean" state
+            m_encoder->initialize(*m_encoder_factory);
+            m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+            for(auto& relay : m_relays)
+            {
+                relay->initialize(*m_relay_factory);
+            }
+
+            for(auto& sink : m_sinks)
+            {
+                sink->initialize(*m_decoder_factory);
+            }
+
+            while(!sinks_complete())
+            {
+                for(const auto& l : m_links)
+                {
+                    send(l);
+                }
+            }
+        }
+    }
+
+protected:
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The relay factory
+    std::shared_ptr<relay_factory> m_relay_factory;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The source
+    encoder_ptr m_encoder;
+
+    /// The relays
+    std::vector<relay_ptr> m_relays;
+
+    /// The sinks
+    std::vector<decoder_ptr> m_sinks;
+
+    /// The links of the network
+    std::vector<network_link> m_links;
+
+    /// The erasure probability of a link
+    double m_erasure;
+
+    /// The time spent in each node in microseconds
+    std::vector<double> m_node_time;
+
+    /// The number of payloads sent by the source
+    uint64_t m_source_payloads;
+
+    /// The number of payloads sent by all nodes
+    uint64_t m_transmissions;
+
+    /// The data encoded
+    std::vector<uint8_t> m_encoded_data;
+
+    /// The buffer for the payload in flight
+    std::vector<uint8_t> m_payload;
+
+    /// The hardware counters of the measurement
+    perf_counters m_perf_counters;
+
+};
+
+/// Using this macro we may specify options. For specifying options
+/// we use the boost program options library. So you may additional
+/// details on how to do it in the manual for that library.
+BENCHMARK_OPTION(recoding_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<uint32_t> symbols;
+    symbols.push_back(16);
+    symbols.push_back(32);
+    symbols.push_back(64);
+    symbols.push_back(128);
+
+    auto default_symbols =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbols, "")->multitoken();
+
+    std::vector<uint32_t> symbol_size;
+    symbol_size.push_back(1600);
+
+    auto default_symbol_size =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            symbol_size, "")->multitoken();
+
+    std::vector<double> rank;
+    rank.push_back(0.25);
+    rank.push_back(0.5);
+    rank.push_back(0.75);
+    rank.push_back(1.0);
+
+    auto default_rank =
+        gauge::po::value<std::vector<double> >()->default_value(
+            rank, "")->multitoken();
+
+    options.add_options()
+        ("symbols", default_symbols, "Set the number of symbols");
+
+    options.add_options()
+        ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
+
+    options.add_options()
+        ("rank", default_rank,
+         "Set the rank of the recoding decoder as a fraction of the "
+         "symbols");
+
+    gauge::runner::instance().register_options(options);
+}
+
+BENCHMARK_OPTION(relay_options)
+{
+    gauge::po::options_description options;
+
+    std::vector<std::string> topology;
+    topology.push_back("line");
+    topology.push_back("butterfly");
+
+    auto default_topology =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            topology, "")->multitoken();
+
+    std::vector<uint32_t> hops;
+    hops.push_back(2);
+    hops.push_back(4);
+    hops.push_back(8);
+
+    auto default_hops =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            hops, "")->multitoken();
+
+    std::vector<double> erasure;
+    erasure.push_back(0.1);
+    erasure.push_back(0.3);
+
+    auto default_erasure =
+        gauge::po::value<std::vector<double> >()->default_value(
+            erasure, "")->multitoken();
+
+    options.add_options()
+        ("topology", default_topology, "Set topology [line|butterfly]");
+
+    options.add_options()
+        ("hops", default_hops, "Set the number of hops of the line");
+
+    options.add_options()
+        ("erasure", default_erasure,
+         "Set the erasure probability of every link");
+
+    gauge::runner::instance().register_options(options);
+}
+
+//------------------------------------------------------------------
+// Recoding throughput
+//------------------------------------------------------------------
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_recoding;
+
+BENCHMARK_F(setup_rlnc_recoding, FullRLNCRecoding, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_recoding8;
+
+BENCHMARK_F(setup_rlnc_recoding8, FullRLNCRecoding, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary16>,
+    kodo::full_rlnc_decoder<fifi::binary16> > setup_rlnc_recoding16;
+
+BENCHMARK_F(setup_rlnc_recoding16, FullRLNCRecoding, Binary16, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_proxy_recoding_decoder<fifi::binary> >
+    setup_proxy_recoding;
+
+BENCHMARK_F(setup_proxy_recoding, ProxyRLNCRecoding, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_proxy_recoding_decoder<fifi::binary8> >
+    setup_proxy_recoding8;
+
+BENCHMARK_F(setup_proxy_recoding8, ProxyRLNCRecoding, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_running_recoding_decoder<fifi::binary8> >
+    setup_running_recoding8;
+
+BENCHMARK_F(setup_running_recoding8, RunningRLNCRecoding, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef recoding_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_relay<fifi::binary8> > setup_relay_recoding8;
+
+BENCHMARK_F(setup_relay_recoding8, RelayRLNCRecoding, Binary8, 5)
+{
+    run_benchmark();
+}
+
+//------------------------------------------------------------------
+// Relay networks
+//------------------------------------------------------------------
+
+typedef relay_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary>,
+    kodo::full_rlnc_decoder<fifi::binary> > setup_rlnc_network;
+
+BENCHMARK_F(setup_rlnc_network, FullRLNCNetwork, Binary, 5)
+{
+    run_benchmark();
+}
+
+typedef relay_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_rlnc_network8;
+
+BENCHMARK_F(setup_rlnc_network8, FullRLNCNetwork, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef relay_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_proxy_recoding_decoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_proxy_network8;
+
+BENCHMARK_F(setup_proxy_network8, ProxyRLNCNetwork, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef relay_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_running_recoding_decoder<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_running_network8;
+
+BENCHMARK_F(setup_running_network8, RunningRLNCNetwork, Binary8, 5)
+{
+    run_benchmark();
+}
+
+typedef relay_benchmark<
+    kodo::full_rlnc_encoder<fifi::binary8>,
+    kodo::full_rlnc_relay<fifi::binary8>,
+    kodo::full_rlnc_decoder<fifi::binary8> > setup_relay_network8;
+
+BENCHMARK_F(setup_relay_network8, RelayRLNCNetwork, Binary8, 5)
+{
+    run_benchmark();
+}
+
+int main(int argc, const char* argv[])
+{
+    srand(static_cast<uint32_t>(time(0)));
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::console_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::python_printer>());
+
+    gauge::runner::instance().printers().push_back(
+        std::make_shared<gauge::csv_printer>());
+
+    gauge::runner::run_benchmarks(argc, argv);
+
+    return 0;
+}
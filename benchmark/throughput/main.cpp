@@ -3,7 +3,16 @@
 // See accompanying file LICENSE.rst or
 // http://www.steinwurf.com/licensing
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <ctime>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include <boost/make_shared.hpp>
 
@@ -15,12 +24,15 @@
 #include <kodo/rlnc/full_vector_codes.hpp>
 #include <kodo/rlnc/seed_codes.hpp>
 #include <kodo/rs/reed_solomon_codes.hpp>
+#include <kodo/cpu_features.hpp>
 
 #include "codes.hpp"
+#include "../perf_counters.hpp"
 
-/// A test block represents an encoder and decoder pair
+/// The encoder, decoder and payloads used by one thread of the
+/// throughput benchmark
 template<class Encoder, class Decoder>
-struct throughput_benchmark : public gauge::time_benchmark
+struct throughput_worker
 {
 
     typedef typename Encoder::factory encoder_factory;
@@ -29,6 +41,178 @@ struct throughput_benchmark : public gauge::time_benchmark
     typedef typename Decoder::factory decoder_factory;
     typedef typename Decoder::pointer decoder_ptr;
 
+    /// The clock used to measure the time spent by the worker
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    /// Builds the encoder and decoder and prepares the payloads
+    /// @param the_encoder_factory The factory building the encoder
+    /// @param the_decoder_factory The factory building the decoder
+    /// @param payload_count The number of payloads to encode
+    void setup(const std::shared_ptr<encoder_factory>& the_encoder_factory,
+               const std::shared_ptr<decoder_factory>& the_decoder_factory,
+               uint32_t payload_count)
+    {
+        m_encoder_factory = the_encoder_factory;
+        m_decoder_factory = the_decoder_factory;
+
+        m_encoder = m_encoder_factory->build();
+        m_decoder = m_decoder_factory->build();
+
+        // Prepare the data to be encoded
+        m_encoded_data.resize(m_encoder->block_size());
+
+        for(uint8_t &e : m_encoded_data)
+        {
+            e = rand() % 256;
+        }
+
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        // Prepare storage to the encoded payloads
+        m_payloads.resize(payload_count);
+        for(uint32_t i = 0; i < payload_count; ++i)
+        {
+            m_payloads[i].resize( m_encoder->payload_size() );
+        }
+
+        m_temp_payload.resize( m_encoder->payload_size() );
+
+        reset();
+    }
+
+    /// Resets the counters of the worker
+    void reset()
+    {
+        m_encoded_symbols = 0;
+        m_decoded_symbols = 0;
+        m_time = 0.0;
+    }
+
+    void encode_payloads()
+    {
+        m_encoder->set_symbols(sak::storage(m_encoded_data));
+
+        // We switch any systematic operations off so we code
+        // symbols from the beginning
+        if(kodo::is_systematic_encoder(m_encoder))
+            kodo::set_systematic_off(m_encoder);
+
+        uint32_t payload_count = m_payloads.size();
+
+        for(uint32_t i = 0; i < payload_count; ++i)
+        {
+            std::vector<uint8_t> &payload = m_payloads[i];
+            m_encoder->encode(&payload[0]);
+
+            ++m_encoded_symbols;
+        }
+    }
+
+    void decode_payloads()
+    {
+        uint32_t payload_count = m_payloads.size();
+
+        for(uint32_t i = 0; i < payload_count; ++i)
+        {
+            std::copy(m_payloads[i].begin(),
+                      m_payloads[i].end(),
+                      m_temp_payload.begin());
+
+            m_decoder->decode(&m_temp_payload[0]);
+
+            ++m_decoded_symbols;
+
+            if(m_decoder->is_complete())
+            {
+                return;
+            }
+        }
+    }
+
+    /// Encodes a block
+    void run_encode()
+    {
+        clock_type::time_point start = clock_type::now();
+
+        // We have to make sure the encoder is in a "clean" state
+        m_encoder->initialize(*m_encoder_factory);
+
+        encode_payloads();
+
+        add_time(start);
+    }
+
+    /// Decodes a block
+    void run_decode()
+    {
+        clock_type::time_point start = clock_type::now();
+
+        // We have to make sure the decoder is in a "clean" state
+        // i.e. no symbols already decoded.
+        m_decoder->initialize(*m_decoder_factory);
+
+        // Decode the payloads
+        decode_payloads();
+
+        add_time(start);
+    }
+
+    /// Adds the time elapsed to the time spent by the worker
+    /// @param start The time the worker started
+    void add_time(const clock_type::time_point& start)
+    {
+        m_time += std::chrono::duration<double, std::micro>(
+            clock_type::now() - start).count();
+    }
+
+    /// The encoder factory
+    std::shared_ptr<encoder_factory> m_encoder_factory;
+
+    /// The decoder factory
+    std::shared_ptr<decoder_factory> m_decoder_factory;
+
+    /// The encoder to use
+    encoder_ptr m_encoder;
+
+    /// The number of symbols encoded
+    uint64_t m_encoded_symbols;
+
+    /// The encoder to use
+    decoder_ptr m_decoder;
+
+    /// The number of symbols decoded
+    uint64_t m_decoded_symbols;
+
+    /// The time spent coding in microseconds
+    double m_time;
+
+    /// The data encoded
+    std::vector<uint8_t> m_encoded_data;
+
+    /// Temporary payload to not destroy the already encoded payloads
+    /// when decoding
+    std::vector<uint8_t> m_temp_payload;
+
+    /// Storage for encoded symbols
+    std::vector< std::vector<uint8_t> > m_payloads;
+
+};
+
+/// A test block represents an encoder and decoder pair per thread. With
+/// a single thread one encoder or decoder is benchmarked. With more
+/// threads every thread codes its own blocks at the same time, the
+/// coders are built either from a factory per thread or from factories
+/// shared by all threads.
+template<class Encoder, class Decoder>
+struct throughput_benchmark : public gauge::time_benchmark
+{
+
+    typedef typename Encoder::factory encoder_factory;
+    typedef typename Decoder::factory decoder_factory;
+
+    /// The coders used by a thread
+    typedef throughput_worker<Encoder, Decoder> worker_type;
+
     void init()
     {
         m_factor = 2;
@@ -37,39 +221,55 @@ struct throughput_benchmark : public gauge::time_benchmark
 
     void start()
     {
-        m_encoded_symbols = 0;
-        m_decoded_symbols = 0;
+        for(auto& w : m_workers)
+        {
+            w.reset();
+        }
+
+        m_perf_counters.start();
         gauge::time_benchmark::start();
     }
 
     void stop()
     {
         gauge::time_benchmark::stop();
+        m_perf_counters.stop();
     }
 
-    double measurement()
+    /// @param w The worker
+    /// @return The number of bytes {en|de}coded by the worker
+    uint64_t coded_bytes(const worker_type& w)
     {
-        // Get the time spent per iteration
-        double time = gauge::time_benchmark::measurement();
-
         gauge::config_set cs = get_current_configuration();
         std::string type = cs.get_value<std::string>("type");
         uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
 
-        // The number of bytes {en|de}coded
-        uint64_t total_bytes = 0;
-
         if(type == "decoder")
         {
-            total_bytes = m_decoded_symbols * symbol_size;
+            return w.m_decoded_symbols * symbol_size;
         }
         else if(type == "encoder")
         {
-            total_bytes = m_encoded_symbols * symbol_size;
+            return w.m_encoded_symbols * symbol_size;
         }
         else
         {
             assert(0);
+            return 0;
+        }
+    }
+
+    double measurement()
+    {
+        // Get the time spent per iteration
+        double time = gauge::time_benchmark::measurement();
+
+        // The number of bytes {en|de}coded by all threads
+        uint64_t total_bytes = 0;
+
+        for(const auto& w : m_workers)
+        {
+            total_bytes += coded_bytes(w);
         }
 
         // The bytes per iteration
@@ -81,7 +281,39 @@ struct throughput_benchmark : public gauge::time_benchmark
 
     void store_run(gauge::table& results)
     {
-        results.set_value("throughput", measurement());
+        double throughput = measurement();
+
+        // The throughput of each thread over the time it spent coding
+        double thread_throughput = 0.0;
+        double min_thread_throughput = 0.0;
+
+        for(uint32_t i = 0; i < m_workers.size(); ++i)
+        {
+            double t = coded_bytes(m_workers[i]) / m_workers[i].m_time;
+
+            thread_throughput += t;
+            min_thread_throughput =
+                i == 0 ? t : std::min(min_thread_throughput, t);
+        }
+
+        thread_throughput /= m_workers.size();
+
+        results.set_value("throughput", throughput);
+        results.set_value("thread_throughput", thread_throughput);
+        results.set_value("min_thread_throughput", min_thread_throughput);
+
+        // The aggregate throughput relative to the threads each coding
+        // as fast as a single thread alone
+        results.set_value("efficiency",
+            throughput / (m_workers.size() * m_single_throughput));
+
+        // The counters follow the calling thread, which with more
+        // threads also waits for the other workers in run_workers(). The
+        // counters are therefore only reported for a single thread.
+        if(m_workers.size() == 1)
+        {
+            m_perf_counters.store(results, coded_bytes(m_workers[0]));
+        }
     }
 
     bool accept_measurement()
@@ -94,13 +326,17 @@ struct throughput_benchmark : public gauge::time_benchmark
         {
             // If we are benchmarking a decoder we only accept
             // the measurement if the decoding was successful
-            if(!m_decoder->is_complete())
+            for(const auto& w : m_workers)
             {
-                // We did not generate enough payloads to decode successfully,
-                // so we will generate more payloads for next run
-                m_factor++;
+                if(!w.m_decoder->is_complete())
+                {
+                    // We did not generate enough payloads to decode
+                    // successfully, so we will generate more payloads
+                    // for next run
+                    m_factor++;
 
-                return false;
+                    return false;
+                }
             }
         }
 
@@ -112,6 +348,41 @@ struct throughput_benchmark : public gauge::time_benchmark
         return "MB/s";
     }
 
+    /// Reads the options controlling the threads
+    void get_thread_options(gauge::po::variables_map& options)
+    {
+        m_thread_counts = options["threads"].as<std::vector<uint32_t> >();
+        m_factory_types = options["factory"].as<std::vector<std::string> >();
+        m_pin = options["pin"].as<bool>();
+
+        assert(m_thread_counts.size() > 0);
+        assert(m_factory_types.size() > 0);
+    }
+
+    /// Adds the configuration for every number of threads and type of
+    /// factory. The SIMD backend used by the binary and binary8 stacks
+    /// is stored with the configuration so it is part of the results.
+    /// @param cs The configuration without the thread options
+    void add_thread_configurations(gauge::config_set cs)
+    {
+        cs.set_value<std::string>("simd",
+            kodo::simd_backend_name(kodo::cpu_simd_backend()));
+
+        for(const auto& n : m_thread_counts)
+        {
+            for(const auto& f : m_factory_types)
+            {
+                assert(n > 0);
+                assert(f == "shared" || f == "thread");
+
+                cs.set_value<uint32_t>("threads", n);
+                cs.set_value<std::string>("factory", f);
+
+                add_configuration(cs);
+            }
+        }
+    }
+
     void get_options(gauge::po::variables_map& options)
     {
         auto symbols = options["symbols"].as<std::vector<uint32_t> >();
@@ -122,6 +393,8 @@ struct throughput_benchmark : public gauge::time_benchmark
         assert(symbol_size.size() > 0);
         assert(types.size() > 0);
 
+        get_thread_options(options);
+
         for(uint32_t i = 0; i < symbols.size(); ++i)
         {
             for(uint32_t j = 0; j < symbol_size.size(); ++j)
@@ -133,7 +406,7 @@ struct throughput_benchmark : public gauge::time_benchmark
                     cs.set_value<uint32_t>("symbol_size", symbol_size[j]);
                     cs.set_value<std::string>("type", types[u]);
 
-                    add_configuration(cs);
+                    add_thread_configurations(cs);
                 }
             }
         }
@@ -145,133 +418,216 @@ struct throughput_benchmark : public gauge::time_benchmark
 
         uint32_t symbols = cs.get_value<uint32_t>("symbols");
         uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        uint32_t threads = cs.get_value<uint32_t>("threads");
+        std::string factory = cs.get_value<std::string>("factory");
 
-        // Make the factories fit perfectly otherwise there seems to
-        // be problems with memory access i.e. when using a factory
-        // with max symbols 1024 with a symbols 16
-        m_decoder_factory = std::make_shared<decoder_factory>(
-            symbols, symbol_size);
+        uint32_t factories = factory == "shared" ? 1 : threads;
 
-        m_encoder_factory = std::make_shared<encoder_factory>(
-            symbols, symbol_size);
+        m_encoder_factories.resize(factories);
+        m_decoder_factories.resize(factories);
 
-        m_decoder_factory->set_symbols(symbols);
-        m_decoder_factory->set_symbol_size(symbol_size);
+        for(uint32_t i = 0; i < factories; ++i)
+        {
+            // Make the factories fit perfectly otherwise there seems to
+            // be problems with memory access i.e. when using a factory
+            // with max symbols 1024 with a symbols 16
+            m_decoder_factories[i] = std::make_shared<decoder_factory>(
+                symbols, symbol_size);
 
-        m_encoder_factory->set_symbols(symbols);
-        m_encoder_factory->set_symbol_size(symbol_size);
+            m_encoder_factories[i] = std::make_shared<encoder_factory>(
+                symbols, symbol_size);
 
-        m_encoder = m_encoder_factory->build();
-        m_decoder = m_decoder_factory->build();
+            m_decoder_factories[i]->set_symbols(symbols);
+            m_decoder_factories[i]->set_symbol_size(symbol_size);
 
-        // Prepare the data to be encoded
-        m_encoded_data.resize(m_encoder->block_size());
+            m_encoder_factories[i]->set_symbols(symbols);
+            m_encoder_factories[i]->set_symbol_size(symbol_size);
+        }
 
-        for(uint8_t &e : m_encoded_data)
+        // The coders are built here by a single thread, the shared
+        // factories are then only read by the threads
+        m_workers.resize(threads);
+
+        for(uint32_t i = 0; i < threads; ++i)
         {
-            e = rand() % 256;
+            m_workers[i].setup(m_encoder_factories[i % factories],
+                               m_decoder_factories[i % factories],
+                               symbols * m_factor);
         }
+    }
 
-        m_encoder->set_symbols(sak::storage(m_encoded_data));
+    /// Runs the workers for one block each, the calling thread runs the
+    /// first worker
+    void run_workers()
+    {
+        m_done = 0;
+        ++m_generation;
 
-        // Prepare storage to the encoded payloads
-        uint32_t payload_count = symbols * m_factor;
+        run_worker(0);
 
-        m_payloads.resize(payload_count);
-        for(uint32_t i = 0; i < payload_count; ++i)
+        while(m_done.load() < m_workers.size() - 1)
         {
-            m_payloads[i].resize( m_encoder->payload_size() );
+            std::this_thread::yield();
         }
-
-        m_temp_payload.resize( m_encoder->payload_size() );
     }
 
-    void encode_payloads()
+    /// Runs a worker for one block
+    /// @param index The index of the worker
+    void run_worker(uint32_t index)
     {
-        m_encoder->set_symbols(sak::storage(m_encoded_data));
+        if(m_encode)
+        {
+            m_workers[index].run_encode();
+        }
+        else
+        {
+            m_workers[index].run_decode();
+        }
+    }
 
-        // We switch any systematic operations off so we code
-        // symbols from the beginning
-        if(kodo::is_systematic_encoder(m_encoder))
-            kodo::set_systematic_off(m_encoder);
+    /// The function run by the threads of all but the first worker. The
+    /// threads wait for the generation to change between blocks, they
+    /// spin so the wake up latency does not distort small blocks.
+    /// @param index The index of the worker
+    void thread_main(uint32_t index)
+    {
+        pin_thread(index);
 
-        uint32_t payload_count = m_payloads.size();
+        uint32_t generation = 0;
 
-        for(uint32_t i = 0; i < payload_count; ++i)
+        while(true)
         {
-            std::vector<uint8_t> &payload = m_payloads[i];
-            m_encoder->encode(&payload[0]);
+            while(m_generation.load() == generation)
+            {
+                if(m_stop.load())
+                    return;
 
-            ++m_encoded_symbols;
+                std::this_thread::yield();
+            }
+
+            ++generation;
+
+            run_worker(index);
+            ++m_done;
         }
     }
 
-    void decode_payloads()
+    /// Pins the calling thread to a core if pinning is enabled and
+    /// supported by the platform
+    /// @param index The index of the worker running on the thread
+    void pin_thread(uint32_t index)
     {
-        uint32_t payload_count = m_payloads.size();
+#if defined(__linux__)
+        uint32_t cores = std::thread::hardware_concurrency();
 
-        for(uint32_t i = 0; i < payload_count; ++i)
-        {
-            std::copy(m_payloads[i].begin(),
-                      m_payloads[i].end(),
-                      m_temp_payload.begin());
+        if(!m_pin || cores == 0)
+            return;
 
-            m_decoder->decode(&m_temp_payload[0]);
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(index % cores, &cpus);
 
-            ++m_decoded_symbols;
-
-            if(m_decoder->is_complete())
-            {
-                return;
-            }
-        }
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+        (void) index;
+#endif
     }
 
-    /// Run the encoder
-    void run_encode()
+    /// Runs the workers for every iteration of the benchmark
+    void run_threads()
     {
-        gauge::config_set cs = get_current_configuration();
+#if defined(__linux__)
+        // The calling thread runs the first worker, its affinity is
+        // restored afterwards
+        cpu_set_t affinity;
+        pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+#endif
 
-        uint32_t symbols = cs.get_value<uint32_t>("symbols");
-        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        pin_thread(0);
+
+        m_generation = 0;
+        m_done = 0;
+        m_stop = false;
 
-        m_encoder_factory->set_symbols(symbols);
-        m_encoder_factory->set_symbol_size(symbol_size);
+        std::vector<std::thread> threads;
+        for(uint32_t i = 1; i < m_workers.size(); ++i)
+        {
+            threads.push_back(std::thread(
+                &throughput_benchmark::thread_main, this, i));
+        }
 
         // The clock is running
         RUN{
-            // We have to make sure the encoder is in a "clean" state
-            m_encoder->initialize(*m_encoder_factory);
+            run_workers();
+        }
+
+        m_stop = true;
 
-            encode_payloads();
+        for(auto& t : threads)
+        {
+            t.join();
         }
+
+        measure_single_throughput();
+
+#if defined(__linux__)
+        pthread_setaffinity_np(pthread_self(), sizeof(affinity), &affinity);
+#endif
     }
 
-    /// Run the decoder
-    void run_decode()
+    /// Measures the throughput of the first worker running alone for as
+    /// many blocks as in the benchmark, used as the reference of the
+    /// scaling efficiency
+    void measure_single_throughput()
     {
-        // Encode some data
-        encode_payloads();
+        worker_type& w = m_workers[0];
 
-        gauge::config_set cs = get_current_configuration();
+        if(m_workers.size() == 1)
+        {
+            m_single_throughput = coded_bytes(w) / w.m_time;
+            return;
+        }
 
-        uint32_t symbols = cs.get_value<uint32_t>("symbols");
-        uint32_t symbol_size = cs.get_value<uint32_t>("symbol_size");
+        // Keep the counters of the benchmark run
+        uint64_t encoded_symbols = w.m_encoded_symbols;
+        uint64_t decoded_symbols = w.m_decoded_symbols;
+        double time = w.m_time;
 
-        m_decoder_factory->set_symbols(symbols);
-        m_decoder_factory->set_symbol_size(symbol_size);
+        w.reset();
 
-        // The clock is running
-        RUN{
-            // We have to make sure the decoder is in a "clean" state
-            // i.e. no symbols already decoded.
-            m_decoder->initialize(*m_decoder_factory);
+        uint64_t iterations = gauge::time_benchmark::iteration_count();
 
-            // Decode the payloads
-            decode_payloads();
+        for(uint64_t i = 0; i < iterations; ++i)
+        {
+            run_worker(0);
         }
+
+        m_single_throughput = coded_bytes(w) / w.m_time;
+
+        w.m_encoded_symbols = encoded_symbols;
+        w.m_decoded_symbols = decoded_symbols;
+        w.m_time = time;
     }
 
+    /// Run the encoder
+    void run_encode()
+    {
+        m_encode = true;
+        run_threads();
+    }
+
+    /// Run the decoder
+    void run_decode()
+    {
+        // Encode some data
+        for(auto& w : m_workers)
+        {
+            w.encode_payloads();
+        }
+
+        m_encode = false;
+        run_threads();
+    }
 
     void run_benchmark()
     {
@@ -296,37 +652,46 @@ struct throughput_benchmark : public gauge::time_benchmark
 
 protected:
 
-    /// The decoder factory
-    std::shared_ptr<decoder_factory> m_decoder_factory;
+    /// The encoder factories, one per thread or one shared
+    std::vector<std::shared_ptr<encoder_factory> > m_encoder_factories;
 
-    /// The encoder factory
-    std::shared_ptr<encoder_factory> m_encoder_factory;
+    /// The decoder factories, one per thread or one shared
+    std::vector<std::shared_ptr<decoder_factory> > m_decoder_factories;
 
-    /// The encoder to use
-    encoder_ptr m_encoder;
+    /// The coders of each thread
+    std::vector<worker_type> m_workers;
 
-    /// The number of symbols encoded
-    uint32_t m_encoded_symbols;
+    /// The numbers of threads benchmarked
+    std::vector<uint32_t> m_thread_counts;
 
-    /// The encoder to use
-    decoder_ptr m_decoder;
+    /// The types of factories benchmarked [shared|thread]
+    std::vector<std::string> m_factory_types;
 
-    /// The number of symbols decoded
-    uint32_t m_decoded_symbols;
+    /// True if the threads are pinned to cores
+    bool m_pin;
 
-    /// The data encoded
-    std::vector<uint8_t> m_encoded_data;
+    /// True if the workers encode, false if they decode
+    bool m_encode;
 
-    /// Temporary payload to not destroy the already encoded payloads
-    /// when decoding
-    std::vector<uint8_t> m_temp_payload;
+    /// Incremented to start the threads on a block
+    std::atomic<uint32_t> m_generation;
 
-    /// Storage for encoded symbols
-    std::vector< std::vector<uint8_t> > m_payloads;
+    /// The number of threads which finished the block
+    std::atomic<uint32_t> m_done;
+
+    /// Set to stop the threads
+    std::atomic<bool> m_stop;
+
+    /// The throughput of a single thread coding alone
+    double m_single_throughput;
 
     /// Multiplication factor for payload_count
     uint32_t m_factor;
 
+    /// The hardware counters of the calling thread, only reported when
+    /// a single thread is benchmarked
+    perf_counters m_perf_counters;
+
 };
 
 
@@ -340,8 +705,8 @@ public:
     /// The type of the base benchmark
     typedef throughput_benchmark<Encoder,Decoder> Super;
 
-    /// We need access to the encoder built to adjust the density
-    using Super::m_encoder;
+    /// We need access to the encoders built to adjust the density
+    using Super::m_workers;
 
 public:
 
@@ -357,6 +722,8 @@ public:
         assert(types.size() > 0);
         assert(density.size() > 0);
 
+        Super::get_thread_options(options);
+
         for(const auto& s : symbols)
         {
             for(const auto& p : symbol_size)
@@ -371,7 +738,7 @@ public:
                         cs.set_value<std::string>("type", t);
                         cs.set_value<double>("density", d);
 
-                        Super::add_configuration(cs);
+                        Super::add_thread_configurations(cs);
                     }
                 }
             }
@@ -385,7 +752,11 @@ public:
         gauge::config_set cs = Super::get_current_configuration();
 
         double density = cs.get_value<double>("density");
-        m_encoder->set_density(density);
+
+        for(auto& w : m_workers)
+        {
+            w.m_encoder->set_density(density);
+        }
     }
 
 };
@@ -430,9 +801,36 @@ BENCHMARK_OPTION(throughput_options)
     options.add_options()
         ("symbol_size", default_symbol_size, "Set the symbol size in bytes");
 
+    std::vector<uint32_t> threads;
+    threads.push_back(1);
+
+    auto default_threads =
+        gauge::po::value<std::vector<uint32_t> >()->default_value(
+            threads, "")->multitoken();
+
+    std::vector<std::string> factory;
+    factory.push_back("shared");
+
+    auto default_factory =
+        gauge::po::value<std::vector<std::string> >()->default_value(
+            factory, "")->multitoken();
+
     options.add_options()
         ("type", default_types, "Set type [encoder|decoder]");
 
+    options.add_options()
+        ("threads", default_threads,
+         "Set the number of threads coding in parallel");
+
+    options.add_options()
+        ("factory", default_factory,
+         "Set whether the threads use shared factories or a factory "
+         "each [shared|thread]");
+
+    options.add_options()
+        ("pin", gauge::po::value<bool>()->default_value(false, ""),
+         "Pin each thread to a core");
+
     gauge::runner::instance().register_options(options);
 }
 
@@ -0,0 +1,105 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include <kodo/decoder_trace.hpp>
+#include <kodo/trace_file.hpp>
+
+/// @example trace_decoder.cpp
+///
+/// Simple example showing how to record the events of a decoder with
+/// the decoder_trace layer. The events are saved to the file
+/// decoder.trace, which is printed as a timeline by running:
+///
+///     trace_dump decoder.trace
+
+namespace kodo
+{
+    template<class Field>
+    class trace_full_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 decoder_trace<               // <-- Trace layer
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 trace_full_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > >
+    { };
+}
+
+int main()
+{
+    // Seed rand
+    srand(time(0));
+
+    // Set the number of symbols (i.e. the generation size in RLNC
+    // terminology) and the size of a symbol in bytes
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 1400;
+
+    // Typdefs for the encoder/decoder type we wish to use
+    typedef kodo::full_rlnc_encoder<fifi::binary8> rlnc_encoder;
+    typedef kodo::trace_full_rlnc_decoder<fifi::binary8> rlnc_decoder;
+
+    rlnc_encoder::factory encoder_factory(symbols, symbol_size);
+
+    // The decoders keep the latest 1024 events
+    rlnc_decoder::factory decoder_factory(symbols, symbol_size);
+    decoder_factory.set_trace_capacity(1024);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in(encoder->block_size());
+
+    for(auto &e: data_in)
+        e = rand() % 256;
+
+    encoder->set_symbols(sak::storage(data_in));
+
+    while( !decoder->is_complete() )
+    {
+        encoder->encode( &payload[0] );
+
+        // Here we "simulate" a packet loss of approximately 50%
+        if((rand() % 2) == 0)
+            continue;
+
+        decoder->decode( &payload[0] );
+    }
+
+    // The buffer may be saved at any time, also from another thread
+    // while the decoder is in use
+    std::ofstream trace("decoder.trace", std::ios::binary);
+    kodo::trace_file(*decoder->get_trace_buffer()).write(trace);
+
+    std::cout << "Saved " << decoder->get_trace_buffer()->written()
+              << " events to decoder.trace" << std::endl;
+}
@@ -12,11 +12,14 @@
 #include <sak/aligned_allocator.hpp>
 #include <sak/is_aligned.hpp>
 
+#include "coder_arena.hpp"
+
 namespace kodo
 {
     /// @brief Helper layer for layers that require a buffer for storing
-    ///        symbol coefficients. The storage is uninitialized. The
-    ///        buffer is guaranteed to be aligned (on a 16 byte boundary).
+    ///        symbol coefficients. The buffer is reserved in the coder
+    ///        arena and is guaranteed to be aligned (on a 16 byte
+    ///        boundary).
     template<class SuperCoder>
     class aligned_coefficients_buffer : public SuperCoder
     {
@@ -31,22 +34,47 @@ namespace kodo
 
     public:
 
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                return SuperCoder::factory::arena_size() +
+                    coder_arena::aligned_size(
+                        SuperCoder::factory::max_coefficients_size());
+            }
+        };
+
+    public:
+
+        /// Constructor
+        aligned_coefficients_buffer()
+            : m_coefficients(0)
+        { }
+
         /// @copydoc layer::construct(Factory&)
         template<class Factory>
         void construct(Factory &the_factory)
         {
             SuperCoder::construct(the_factory);
-            m_coefficients.resize(the_factory.max_coefficients_size());
+
+            m_coefficients = SuperCoder::arena_allocate(
+                the_factory.max_coefficients_size());
         }
 
     protected:
 
-        /// The storage type
-        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
-            aligned_vector;
-
         /// Temp symbol id (with aligned memory)
-        aligned_vector m_coefficients;
+        uint8_t *m_coefficients;
 
     };
 }
@@ -42,7 +42,7 @@ namespace kodo
                 uint32_t coefficients_size = Super::coefficients_size();
 
                 auto src = sak::storage(coefficients, coefficients_size);
-                auto dest = sak::storage(m_coefficients);
+                auto dest = sak::storage(m_coefficients, coefficients_size);
 
                 sak::copy_storage(dest, src);
 
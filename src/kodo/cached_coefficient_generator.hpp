@@ -0,0 +1,176 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "coefficient_cache.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup coefficient_generator_layers
+    /// @brief Caches the coefficients produced by a seeded coefficient
+    ///        generator.
+    ///
+    /// Whenever layer::generate(uint8_t*) is called directly after
+    /// layer::seed(seed_type) the coefficients are looked up in a
+    /// bounded LRU cache before the underlying generator is invoked.
+    /// This avoids regenerating the coefficients of retransmitted
+    /// symbols and of the seeds which are reused in every generation.
+    ///
+    /// The cache is owned by the coder and is therefore kept when a
+    /// coder is recycled by the factory. On a cache hit the state of
+    /// the underlying generator is not advanced, layers should
+    /// therefore always reseed before generating.
+    template<class SuperCoder>
+    class cached_coefficient_generator : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::seed_type
+        typedef typename SuperCoder::seed_type seed_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_coefficient_cache_size(max_symbols)
+            { }
+
+            /// Sets the number of coefficient vectors cached by coders
+            /// constructed after the call, zero disables the cache.
+            /// @param cache_size The number of coefficient vectors
+            void set_coefficient_cache_size(uint32_t cache_size)
+            {
+                m_coefficient_cache_size = cache_size;
+            }
+
+            /// @return The number of coefficient vectors cached per coder
+            uint32_t coefficient_cache_size() const
+            {
+                return m_coefficient_cache_size;
+            }
+
+        private:
+
+            /// The number of coefficient vectors cached per coder
+            uint32_t m_coefficient_cache_size;
+        };
+
+    public:
+
+        /// Constructor
+        cached_coefficient_generator()
+            : m_seed(0),
+              m_seeded(false)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_cache = boost::make_shared<coefficient_cache>(
+                the_factory.coefficient_cache_size(),
+                the_factory.max_coefficients_size());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            assert(m_cache);
+            return SuperCoder::memory_usage() + m_cache->memory_usage();
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+            m_seeded = false;
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            SuperCoder::seed(seed_value);
+
+            m_seed = seed_value;
+            m_seeded = true;
+        }
+
+        /// @copydoc layer::generate(uint8_t*)
+        void generate(uint8_t *coefficients)
+        {
+            assert(coefficients != 0);
+            assert(m_cache);
+
+            if(!m_seeded)
+            {
+                SuperCoder::generate(coefficients);
+                return;
+            }
+
+            m_seeded = false;
+
+            uint32_t size = SuperCoder::coefficients_size();
+            const uint8_t *cached = m_cache->find(m_seed, size);
+
+            if(cached)
+            {
+                std::copy_n(cached, size, coefficients);
+            }
+            else
+            {
+                SuperCoder::generate(coefficients);
+                m_cache->insert(m_seed, coefficients, size);
+            }
+        }
+
+        /// @copydoc layer::generate_partial(uint8_t*)
+        void generate_partial(uint8_t *coefficients)
+        {
+            // Partial coefficients depend on the coder state and are
+            // therefore never cached
+            m_seeded = false;
+            SuperCoder::generate_partial(coefficients);
+        }
+
+        /// @return The coefficient cache used by this coder
+        const coefficient_cache& cached_coefficients() const
+        {
+            assert(m_cache);
+            return *m_cache;
+        }
+
+    private:
+
+        /// The cached coefficient vectors
+        boost::shared_ptr<coefficient_cache> m_cache;
+
+        /// The last seed passed to the generator
+        seed_type m_seed;
+
+        /// True if the generator was seeded since the last generate
+        bool m_seeded;
+
+    };
+
+}
+
@@ -55,6 +55,13 @@ namespace kodo
             m_coefficients.resize(the_factory.max_coefficients_size());
         }
 
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + m_data.capacity() +
+                m_coefficients.capacity();
+        }
+
         /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
         void decode_symbol(uint8_t *symbol_data,
                            uint8_t *symbol_coefficients)
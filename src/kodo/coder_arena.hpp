@@ -0,0 +1,110 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <boost/noncopyable.hpp>
+
+#include "memory_policy.hpp"
+#include "page_memory.hpp"
+
+namespace kodo
+{
+
+    /// @brief Single memory block from which the layers of a coder
+    ///        reserve their buffers.
+    ///
+    /// The arena is owned by the final factory layer of a stack. It is
+    /// sized when the coder is constructed using the
+    /// layer::factory::arena_size() function, to which every layer
+    /// reserving memory adds the space it needs. During
+    /// layer::construct(Factory&) the layers then reserve their regions
+    /// using layer::arena_allocate(uint32_t). Every region starts on a
+    /// 16 byte boundary and is zero initialized. The memory of the arena
+    /// is allocated according to the memory_policy set on the factory.
+    class coder_arena : boost::noncopyable
+    {
+    public:
+
+        /// The alignment of the regions in bytes
+        static const uint32_t alignment = 16;
+
+    public:
+
+        /// Constructor
+        coder_arena()
+            : m_used(0)
+        { }
+
+        /// Allocates the memory of the arena, should only be called once
+        /// @param size The size of the arena in bytes
+        /// @param policy The policy used to allocate the memory
+        void resize(uint32_t size,
+                    const memory_policy &policy = memory_policy())
+        {
+            assert(m_memory.size() == 0);
+            assert((size % alignment) == 0);
+
+            if(size > 0)
+                m_memory.allocate(size, policy);
+        }
+
+        /// Reserves a region of the arena
+        /// @param size The size of the region in bytes
+        /// @return Pointer to the region
+        uint8_t* allocate(uint32_t size)
+        {
+            assert(size > 0);
+
+            uint32_t reserve = aligned_size(size);
+            assert(m_used + reserve <= m_memory.size());
+
+            uint8_t *region = m_memory.data() + m_used;
+            m_used += reserve;
+
+            return region;
+        }
+
+        /// @return The size of the arena in bytes
+        uint32_t size() const
+        {
+            return m_memory.size();
+        }
+
+        /// @return The memory of the arena
+        const page_memory& memory() const
+        {
+            return m_memory;
+        }
+
+        /// @return The number of bytes reserved
+        uint32_t used() const
+        {
+            return m_used;
+        }
+
+        /// @param size A size in bytes
+        /// @return The number of bytes the arena uses for a region of
+        ///         the given size
+        static uint32_t aligned_size(uint32_t size)
+        {
+            return ((size + alignment - 1) / alignment) * alignment;
+        }
+
+    private:
+
+        /// The number of bytes reserved
+        uint32_t m_used;
+
+        /// The memory of the arena
+        page_memory m_memory;
+
+    };
+
+}
+
@@ -0,0 +1,337 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+namespace kodo
+{
+
+    /// @brief Bounded least-recently-used cache mapping a generator seed
+    ///        to the coefficient vector it produces.
+    ///
+    /// All coefficient vectors are stored in a single buffer allocated
+    /// up-front, so once the cache is full an insert recycles the slot
+    /// of the least recently used entry. The usage list is linked
+    /// through the slot indices and the lookup is an open addressing
+    /// table sized for the capacity, so neither find() nor insert()
+    /// allocates memory. Every slot starts on a 16 byte boundary
+    /// provided the slot size is a multiple of 16.
+    class coefficient_cache : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param capacity The maximum number of coefficient vectors
+        ///        the cache may hold, zero disables the cache
+        /// @param max_coefficients_size The maximum size in bytes of a
+        ///        coefficient vector
+        coefficient_cache(uint32_t capacity, uint32_t max_coefficients_size)
+            : m_capacity(capacity),
+              m_slot_size(((max_coefficients_size + 15) / 16) * 16),
+              m_size(0),
+              m_head(npos),
+              m_tail(npos),
+              m_hits(0),
+              m_misses(0)
+        {
+            assert(max_coefficients_size > 0);
+
+            m_data.resize(m_capacity * m_slot_size);
+            m_entries.resize(m_capacity);
+
+            // Keep the load factor at or below one half
+            uint32_t buckets = 1;
+            while(buckets < 2 * m_capacity)
+                buckets <<= 1;
+
+            m_buckets.resize(buckets, uint32_t(npos));
+        }
+
+        /// Looks up a coefficient vector and marks it as the most
+        /// recently used entry.
+        /// @param seed The seed used to generate the coefficients
+        /// @param size The size in bytes of the coefficient vector
+        /// @return Pointer to the cached coefficients or zero if the
+        ///         vector is not in the cache
+        const uint8_t* find(uint64_t seed, uint32_t size)
+        {
+            assert(size <= m_slot_size);
+
+            uint32_t index = lookup(seed, size);
+
+            if(index == npos)
+            {
+                ++m_misses;
+                return 0;
+            }
+
+            ++m_hits;
+
+            // Move the entry to the front of the usage list
+            unlink(index);
+            push_front(index);
+
+            return slot(index);
+        }
+
+        /// Inserts a coefficient vector evicting the least recently
+        /// used entry if the cache is full.
+        /// @param seed The seed used to generate the coefficients
+        /// @param coefficients The coefficient vector
+        /// @param size The size in bytes of the coefficient vector
+        void insert(uint64_t seed, const uint8_t *coefficients,
+                    uint32_t size)
+        {
+            assert(coefficients != 0);
+            assert(size <= m_slot_size);
+
+            if(m_capacity == 0)
+                return;
+
+            assert(lookup(seed, size) == npos);
+
+            uint32_t index;
+
+            if(m_size < m_capacity)
+            {
+                index = m_size;
+                ++m_size;
+            }
+            else
+            {
+                // Recycle the least recently used entry
+                index = m_tail;
+                erase(index);
+                unlink(index);
+            }
+
+            m_entries[index].m_seed = seed;
+            m_entries[index].m_size = size;
+            push_front(index);
+            add(index);
+
+            std::copy_n(coefficients, size, slot(index));
+        }
+
+        /// @return The number of coefficient vectors in the cache
+        uint32_t size() const
+        {
+            return m_size;
+        }
+
+        /// @return The maximum number of coefficient vectors in the cache
+        uint32_t capacity() const
+        {
+            return m_capacity;
+        }
+
+        /// @return The number of lookups served from the cache
+        uint64_t hits() const
+        {
+            return m_hits;
+        }
+
+        /// @return The number of lookups not found in the cache
+        uint64_t misses() const
+        {
+            return m_misses;
+        }
+
+        /// @return The number of bytes used by the cache including the
+        ///         cache object itself
+        uint64_t memory_usage() const
+        {
+            return sizeof(coefficient_cache) +
+                m_entries.capacity() * sizeof(entry) +
+                m_buckets.capacity() * sizeof(uint32_t) +
+                m_data.capacity();
+        }
+
+    private:
+
+        /// Marks an unused bucket or the end of the usage list
+        static const uint32_t npos = 0xffffffffU;
+
+        /// The key of an entry is the seed and the vector size. The
+        /// size is part of the key since coders built by the same
+        /// factory may use a different number of symbols. Both are
+        /// compared in full, the hash only selects the home bucket.
+        /// @return The home bucket of a key
+        uint32_t bucket(uint64_t seed, uint32_t size) const
+        {
+            // Fibonacci hashing spreads consecutive seeds
+            uint64_t hash = (seed + size * 0xC2B2AE3D27D4EB4FULL) *
+                0x9E3779B97F4A7C15ULL;
+
+            return uint32_t(hash >> 32) & (uint32_t(m_buckets.size()) - 1);
+        }
+
+        /// @return The home bucket of the key of a slot
+        uint32_t bucket(uint32_t index) const
+        {
+            return bucket(m_entries[index].m_seed, m_entries[index].m_size);
+        }
+
+        /// @return The slot of a key or npos if the key is not cached
+        uint32_t lookup(uint64_t seed, uint32_t size) const
+        {
+            if(m_capacity == 0)
+                return npos;
+
+            uint32_t mask = uint32_t(m_buckets.size()) - 1;
+
+            for(uint32_t b = bucket(seed, size); m_buckets[b] != npos;
+                b = (b + 1) & mask)
+            {
+                const entry &e = m_entries[m_buckets[b]];
+
+                if(e.m_seed == seed && e.m_size == size)
+                    return m_buckets[b];
+            }
+
+            return npos;
+        }
+
+        /// Adds the key of a slot to the lookup table
+        void add(uint32_t index)
+        {
+            uint32_t mask = uint32_t(m_buckets.size()) - 1;
+            uint32_t b = bucket(index);
+
+            while(m_buckets[b] != npos)
+                b = (b + 1) & mask;
+
+            m_buckets[b] = index;
+        }
+
+        /// Removes the key of a slot from the lookup table, shifting the
+        /// following keys of the probe sequence back
+        void erase(uint32_t index)
+        {
+            uint32_t mask = uint32_t(m_buckets.size()) - 1;
+            uint32_t b = bucket(index);
+
+            while(m_buckets[b] != index)
+            {
+                b = (b + 1) & mask;
+                assert(m_buckets[b] != npos);
+            }
+
+            uint32_t hole = b;
+
+            for(uint32_t next = (b + 1) & mask; m_buckets[next] != npos;
+                next = (next + 1) & mask)
+            {
+                uint32_t home = bucket(m_buckets[next]);
+
+                // Move the key if its home is not between the hole and
+                // its current bucket
+                if(((next - home) & mask) >= ((next - hole) & mask))
+                {
+                    m_buckets[hole] = m_buckets[next];
+                    hole = next;
+                }
+            }
+
+            m_buckets[hole] = npos;
+        }
+
+        /// Removes a slot from the usage list
+        void unlink(uint32_t index)
+        {
+            entry &e = m_entries[index];
+
+            if(e.m_prev != npos)
+                m_entries[e.m_prev].m_next = e.m_next;
+            else
+                m_head = e.m_next;
+
+            if(e.m_next != npos)
+                m_entries[e.m_next].m_prev = e.m_prev;
+            else
+                m_tail = e.m_prev;
+        }
+
+        /// Makes a slot the most recently used
+        void push_front(uint32_t index)
+        {
+            entry &e = m_entries[index];
+            e.m_prev = npos;
+            e.m_next = m_head;
+
+            if(m_head != npos)
+                m_entries[m_head].m_prev = index;
+            else
+                m_tail = index;
+
+            m_head = index;
+        }
+
+        /// @return Pointer to the storage of a specific slot
+        uint8_t* slot(uint32_t index)
+        {
+            assert(index < m_capacity);
+            return &m_data[index * m_slot_size];
+        }
+
+    private:
+
+        /// The key of a slot and its links in the usage list
+        struct entry
+        {
+            /// The seed of the entry
+            uint64_t m_seed;
+
+            /// The size of the coefficient vector of the entry
+            uint32_t m_size;
+
+            /// The more recently used slot
+            uint32_t m_prev;
+
+            /// The less recently used slot
+            uint32_t m_next;
+        };
+
+        /// The maximum number of entries
+        uint32_t m_capacity;
+
+        /// The size of a slot in bytes
+        uint32_t m_slot_size;
+
+        /// The number of slots used
+        uint32_t m_size;
+
+        /// The most recently used slot
+        uint32_t m_head;
+
+        /// The least recently used slot
+        uint32_t m_tail;
+
+        /// The number of cache hits
+        uint64_t m_hits;
+
+        /// The number of cache misses
+        uint64_t m_misses;
+
+        /// The entries of the slots
+        std::vector<entry> m_entries;
+
+        /// Open addressing table of slot indices
+        std::vector<uint32_t> m_buckets;
+
+        /// Storage for the coefficient vectors
+        std::vector<uint8_t, sak::aligned_allocator<uint8_t> > m_data;
+    };
+
+}
@@ -9,12 +9,19 @@
 #include <fifi/fifi_utils.hpp>
 #include <sak/storage.hpp>
 
+#include "coder_arena.hpp"
+
 namespace kodo
 {
 
     /// @ingroup coefficient_storage_layers
     /// @brief Provides storage and access to the coding coefficients
     ///        used during encoding and decoding.
+    ///
+    /// The coefficient vectors are stored as the rows of one contiguous
+    /// matrix reserved in the coder arena. The rows are padded to a
+    /// multiple of 16 bytes so every row is properly aligned for SSE etc.
+    /// instructions.
     template<class SuperCoder>
     class coefficient_storage : public SuperCoder
     {
@@ -29,38 +36,63 @@ namespace kodo
         /// Pointer to coder produced by the factories
         typedef typename SuperCoder::pointer pointer;
 
-        /// The factory type
-        typedef typename SuperCoder::factory factory;
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                uint32_t stride = coder_arena::aligned_size(
+                    SuperCoder::factory::max_coefficients_size());
+
+                return SuperCoder::factory::arena_size() +
+                    SuperCoder::factory::max_symbols() * stride;
+            }
+        };
 
     public:
 
+        /// Constructor
+        coefficient_storage()
+            : m_coefficients_storage(0),
+              m_stride(0)
+        { }
+
         /// @copydoc layer::construct(Factory&)
         template<class Factory>
         void construct(Factory &the_factory)
         {
             SuperCoder::construct(the_factory);
 
-            m_coefficients_storage.resize(the_factory.max_symbols());
-            for(uint32_t i = 0; i < the_factory.max_symbols(); ++i)
-            {
-                m_coefficients_storage[i].resize(
-                    the_factory.max_coefficients_size());
-            }
+            m_stride = coder_arena::aligned_size(
+                the_factory.max_coefficients_size());
 
+            m_coefficients_storage = SuperCoder::arena_allocate(
+                the_factory.max_symbols() * m_stride);
         }
 
         /// @copydoc layer::coefficients(uint32_t)
         uint8_t* coefficients(uint32_t index)
         {
             assert(index < SuperCoder::symbols());
-            return &(m_coefficients_storage[index])[0];
+            return m_coefficients_storage + index * m_stride;
         }
 
         /// @copydoc layer::coefficients(uint32_t) const
         const uint8_t* coefficients(uint32_t index) const
         {
             assert(index < SuperCoder::symbols());
-            return &(m_coefficients_storage[index])[0];
+            return m_coefficients_storage + index * m_stride;
         }
 
         /// @copydoc layer::coefficients_value(uint32_t)
@@ -93,11 +125,11 @@ namespace kodo
 
     private:
 
-        /// Stores the encoding vectors, we do a vector of vectors
-        /// to maximize chances of proper alignment of individual
-        /// coefficient vectors. This is needed when using SSE etc.
-        /// instructions for fast computations with the coefficients
-        std::vector< std::vector<uint8_t> > m_coefficients_storage;
+        /// Stores the encoding vectors as the rows of a matrix
+        uint8_t *m_coefficients_storage;
+
+        /// The distance in bytes between two rows
+        uint32_t m_stride;
 
     };
 }
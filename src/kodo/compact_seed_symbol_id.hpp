@@ -0,0 +1,135 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include <sak/convert_endian.hpp>
+
+#include "aligned_coefficients_buffer.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup symbol_id_layers
+    /// @brief Base layer for the compact seed symbol id reader and
+    ///        writers.
+    ///
+    /// Instead of sending the full generator seed a smaller id of type
+    /// IdType (e.g. uint16_t) is sent. The generator seed is derived
+    /// from the id and a per-generation nonce, which must be set to the
+    /// same value on the encoder and decoder using set_seed_nonce().
+    /// Using a different nonce for every generation ensures that
+    /// generations do not reuse the same coefficients even though the
+    /// ids repeat.
+    template<class IdType, class SuperCoder>
+    class compact_seed_symbol_id
+        : public aligned_coefficients_buffer<SuperCoder>
+    {
+    public:
+
+        /// Type of SuperCoder with injected aligned_coefficient_buffer
+        typedef aligned_coefficients_buffer<SuperCoder> Super;
+
+        /// The seed type from the generator used
+        typedef typename Super::seed_type seed_type;
+
+        /// The type of the id written to the symbol header
+        typedef IdType id_type;
+
+        /// The id and seed should be integral
+        static_assert(std::is_integral<id_type>::value,
+                      "Id must have an integral type");
+
+        static_assert(std::is_integral<seed_type>::value,
+                      "Seed must have an integral type");
+
+        static_assert(sizeof(id_type) <= sizeof(seed_type),
+                      "Id must not be larger than the seed");
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public Super::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : Super::factory(max_symbols, max_symbol_size)
+                { }
+
+            /// @copydoc layer::factory::max_id_size() const
+            uint32_t max_id_size() const
+                {
+                    return sizeof(id_type);
+                }
+
+        };
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+            {
+                Super::initialize(the_factory);
+                m_nonce = 0;
+            }
+
+        /// @copydoc layer::id_size() const
+        uint32_t id_size() const
+            {
+                return sizeof(id_type);
+            }
+
+        /// Sets the nonce of the current generation. The nonce is reset
+        /// to zero whenever the coder is initialized.
+        /// @param nonce The nonce shared by the encoder and decoder
+        void set_seed_nonce(uint32_t nonce)
+            {
+                m_nonce = nonce;
+            }
+
+        /// @return The nonce of the current generation
+        uint32_t seed_nonce() const
+            {
+                return m_nonce;
+            }
+
+        /// Reads the generator seed derived from a symbol id without
+        /// generating any coefficients
+        /// @param symbol_id The buffer containing the symbol id
+        /// @return The seed used to generate the symbol coefficients
+        seed_type read_seed(const uint8_t *symbol_id) const
+            {
+                assert(symbol_id != 0);
+                return id_seed(sak::big_endian::get<id_type>(symbol_id));
+            }
+
+    protected:
+
+        /// Maps an id to a generator seed. For a fixed nonce the mapping
+        /// is one-to-one, the multiplication spreads consecutive ids
+        /// over the full seed range.
+        /// @param id The id written in the symbol header
+        /// @return The generator seed
+        seed_type id_seed(id_type id) const
+            {
+                return (seed_type)(m_nonce ^ (uint32_t(id) * 0x9E3779B1U));
+            }
+
+    protected:
+
+        /// The nonce of the current generation
+        uint32_t m_nonce;
+
+    };
+
+}
+
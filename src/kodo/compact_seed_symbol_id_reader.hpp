@@ -0,0 +1,55 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "compact_seed_symbol_id.hpp"
+
+namespace kodo
+{
+
+    /// @brief Reads a compact id from the symbol_id buffer, derives the
+    ///        generator seed using the generation nonce and uses it to
+    ///        produce the corresponding coding coefficients.
+    ///
+    /// @ingroup symbol_id_layers
+    template<class IdType, class SuperCoder>
+    class compact_seed_symbol_id_reader
+        : public compact_seed_symbol_id<IdType, SuperCoder>
+    {
+    public:
+
+        /// Type of SuperCoder with injected compact_seed_symbol_id
+        typedef compact_seed_symbol_id<IdType, SuperCoder> Super;
+
+        /// @copydoc compact_seed_symbol_id::seed_type
+        typedef typename Super::seed_type seed_type;
+
+    public:
+
+        /// @copydoc layer::read_id(uint8_t*, uint8_t**)
+        void read_id(uint8_t *symbol_id, uint8_t **symbol_coefficients)
+        {
+            assert(symbol_id != 0);
+            assert(symbol_coefficients != 0);
+
+            Super::seed(Super::read_seed(symbol_id));
+            Super::generate(&m_coefficients[0]);
+
+            *symbol_coefficients = &m_coefficients[0];
+        }
+
+    private:
+
+        /// Access the buffer in the coefficients buffer
+        /// layer used by the compact_seed_symbol_id layer
+        using Super::m_coefficients;
+
+    };
+
+}
+
@@ -0,0 +1,67 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <sak/convert_endian.hpp>
+
+#include "compact_seed_symbol_id.hpp"
+
+namespace kodo
+{
+
+    /// @brief Writes a compact id as the symbol id. The generator seed is
+    ///        derived from the id and the generation nonce, see
+    ///        compact_seed_symbol_id. The current symbol count truncated
+    ///        to IdType is used as the id, so the coefficients repeat
+    ///        after 2^(8*sizeof(IdType)) symbols.
+    ///
+    /// @ingroup symbol_id_layers
+    template<class IdType, class SuperCoder>
+    class compact_seed_symbol_id_writer
+        : public compact_seed_symbol_id<IdType, SuperCoder>
+    {
+    public:
+
+        /// Type of SuperCoder with injected compact_seed_symbol_id
+        typedef compact_seed_symbol_id<IdType, SuperCoder> Super;
+
+        /// @copydoc compact_seed_symbol_id::seed_type
+        typedef typename Super::seed_type seed_type;
+
+        /// @copydoc compact_seed_symbol_id::id_type
+        typedef typename Super::id_type id_type;
+
+    public:
+
+        /// @copydoc layer::write_id(uint8_t*, uint8_t**)
+        uint32_t write_id(uint8_t *symbol_id, uint8_t **coefficients)
+            {
+                assert(symbol_id != 0);
+                assert(coefficients != 0);
+
+                id_type id = (id_type) Super::encode_symbol_count();
+
+                Super::seed(Super::id_seed(id));
+                Super::generate(&m_coefficients[0]);
+
+                sak::big_endian::put<id_type>(id, symbol_id);
+                *coefficients = &m_coefficients[0];
+
+                return sizeof(id_type);
+            }
+
+    private:
+
+        /// Access the buffer in the coefficients buffer
+        /// layer used by the compact_seed_symbol_id layer
+        using Super::m_coefficients;
+
+    };
+
+}
+
@@ -0,0 +1,511 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "control_block_slot.hpp"
+
+namespace kodo
+{
+
+    /// @brief Statistics reported by a concurrent_resource_pool
+    struct concurrent_pool_statistics
+    {
+        /// The number of resources constructed by the pool
+        uint32_t m_allocated;
+
+        /// The number of requests served with a recycled resource
+        uint64_t m_reused;
+
+        /// The number of resources currently handed out
+        uint32_t m_in_use;
+
+        /// The maximum number of resources handed out at the same time
+        uint32_t m_high_water;
+    };
+
+    /// @brief Resource pool which may be used from several threads.
+    ///
+    /// Released resources are first kept in a small cache owned by the
+    /// releasing thread, from where they are handed out again without
+    /// any synchronization. When the thread cache is full the resources
+    /// are pushed to a global lock-free free list from which all threads
+    /// may recycle them.
+    ///
+    /// The global free list is a Treiber stack over resource indices. The
+    /// head is a 64 bit word holding the index of the top resource and a
+    /// tag which is incremented on every update to avoid the ABA problem.
+    /// The resources are never freed before the pool itself is destroyed,
+    /// so a thread may safely read the next index of a resource popped
+    /// by a different thread.
+    ///
+    /// The pool is kept alive by the resources handed out, it is therefore
+    /// safe to release a resource after the pool object is destroyed.
+    ///
+    /// The control blocks of the handed out pointers are placed in a
+    /// control_block_slot of the resource, so handing out a recycled
+    /// resource does not use the heap once the thread cache exists.
+    template<class Value>
+    class concurrent_resource_pool : boost::noncopyable
+    {
+    public:
+
+        /// Pointer to a resource
+        typedef boost::shared_ptr<Value> value_ptr;
+
+        /// The number of resources cached by every thread
+        static const uint32_t thread_cache_size = 4;
+
+    private:
+
+        /// Index used to mark the end of a free list
+        static const uint32_t npos = 0xffffffffU;
+
+        /// The maximum number of resource chunks, chunk c holds 2^c
+        /// resources
+        static const uint32_t max_chunks = 32;
+
+        /// A resource and its link in the global free list
+        struct node
+        {
+            /// The resource
+            Value *m_value;
+
+            /// The memory of the control block
+            control_block_slot *m_slot;
+
+            /// The next resource in the free list
+            std::atomic<uint32_t> m_next;
+        };
+
+        /// The shared state of the pool
+        struct impl : boost::noncopyable
+        {
+            impl()
+                : m_id(next_pool_id()),
+                  m_head(npos),
+                  m_size(0),
+                  m_ready(0),
+                  m_reused(0),
+                  m_in_use(0),
+                  m_high_water(0),
+                  m_resource_size(0)
+                {
+                    for(uint32_t i = 0; i < max_chunks; ++i)
+                        m_chunks[i].store(0, std::memory_order_relaxed);
+                }
+
+            ~impl()
+                {
+                    uint32_t size = m_size.load();
+
+                    for(uint32_t i = 0; i < size; ++i)
+                    {
+                        delete at(i).m_value;
+                        at(i).m_slot->release();
+                    }
+
+                    for(uint32_t i = 0; i < max_chunks; ++i)
+                        delete[] m_chunks[i].load();
+                }
+
+            /// @return The node with the given index
+            node& at(uint32_t index)
+                {
+                    uint32_t chunk = chunk_index(index);
+                    node *n = m_chunks[chunk].load(std::memory_order_acquire);
+
+                    assert(n != 0);
+                    return n[index + 1 - (1U << chunk)];
+                }
+
+            /// Adds a new node for a resource
+            /// @return The index of the new node
+            uint32_t add(Value *value)
+                {
+                    uint32_t index = m_size.fetch_add(1);
+                    uint32_t chunk = chunk_index(index);
+
+                    assert(chunk < max_chunks);
+
+                    if(m_chunks[chunk].load(std::memory_order_acquire) == 0)
+                    {
+                        node *n = new node[1U << chunk];
+                        node *expected = 0;
+
+                        if(!m_chunks[chunk].compare_exchange_strong(
+                               expected, n, std::memory_order_acq_rel))
+                        {
+                            // Another thread installed the chunk
+                            delete[] n;
+                        }
+                    }
+
+                    at(index).m_value = value;
+                    at(index).m_slot = control_block_slot::create();
+
+                    // Only the first resource built sets the size, the
+                    // resource is not yet shared with any other thread
+                    uint64_t expected_size = 0;
+                    m_resource_size.compare_exchange_strong(
+                        expected_size, resource_size(value, 0),
+                        std::memory_order_relaxed);
+
+                    m_ready.fetch_add(1, std::memory_order_release);
+
+                    return index;
+                }
+
+            /// Pushes a node to the global free list
+            void push(uint32_t index)
+                {
+                    node &n = at(index);
+                    uint64_t head = m_head.load(std::memory_order_relaxed);
+
+                    do
+                    {
+                        n.m_next.store(uint32_t(head),
+                                       std::memory_order_relaxed);
+                    }
+                    while(!m_head.compare_exchange_weak(
+                              head, make_head(head, index),
+                              std::memory_order_release,
+                              std::memory_order_relaxed));
+                }
+
+            /// Pops a node from the global free list
+            /// @return The index of the node or npos if the list is empty
+            uint32_t pop()
+                {
+                    uint64_t head = m_head.load(std::memory_order_acquire);
+
+                    while(uint32_t(head) != npos)
+                    {
+                        uint32_t next = at(uint32_t(head)).m_next.load(
+                            std::memory_order_relaxed);
+
+                        if(m_head.compare_exchange_weak(
+                               head, make_head(head, next),
+                               std::memory_order_acquire,
+                               std::memory_order_acquire))
+                        {
+                            return uint32_t(head);
+                        }
+                    }
+
+                    return npos;
+                }
+
+            /// Updates the in use counter and the high water mark
+            void acquired()
+                {
+                    uint32_t in_use = m_in_use.fetch_add(1) + 1;
+                    uint32_t high = m_high_water.load();
+
+                    while(in_use > high &&
+                          !m_high_water.compare_exchange_weak(high, in_use))
+                    { }
+                }
+
+            /// @return The memory used by a resource providing a
+            ///         memory_usage() function
+            template<class Resource>
+            static auto resource_size(Resource *resource, int)
+                -> decltype(uint64_t(resource->memory_usage()))
+                {
+                    return resource->memory_usage();
+                }
+
+            /// @return Zero for resources without a memory_usage()
+            ///         function
+            template<class Resource>
+            static uint64_t resource_size(Resource*, ...)
+                {
+                    return 0;
+                }
+
+            /// Builds a new head word with an incremented tag
+            static uint64_t make_head(uint64_t old_head, uint32_t index)
+                {
+                    return (((old_head >> 32) + 1) << 32) | index;
+                }
+
+            /// @return The chunk holding the given index
+            static uint32_t chunk_index(uint32_t index)
+                {
+                    uint32_t chunk = 0;
+                    for(uint32_t i = index + 1; i > 1; i >>= 1)
+                        ++chunk;
+
+                    return chunk;
+                }
+
+            /// @return A process wide unique id for a pool
+            static uint64_t next_pool_id()
+                {
+                    static std::atomic<uint64_t> id(0);
+                    return ++id;
+                }
+
+            /// The unique id of the pool
+            uint64_t m_id;
+
+            /// The head of the global free list
+            std::atomic<uint64_t> m_head;
+
+            /// The number of nodes
+            std::atomic<uint32_t> m_size;
+
+            /// The number of nodes with a resource set
+            std::atomic<uint32_t> m_ready;
+
+            /// The number of reused resources
+            std::atomic<uint64_t> m_reused;
+
+            /// The number of resources handed out
+            std::atomic<uint32_t> m_in_use;
+
+            /// The maximum number of resources handed out
+            std::atomic<uint32_t> m_high_water;
+
+            /// The memory used by the first resource built
+            std::atomic<uint64_t> m_resource_size;
+
+            /// The node chunks
+            std::atomic<node*> m_chunks[max_chunks];
+        };
+
+        /// The per-thread cache of a single pool
+        struct cache_entry
+        {
+            /// The id of the pool
+            uint64_t m_id;
+
+            /// The pool owning the cached resources
+            boost::weak_ptr<impl> m_pool;
+
+            /// The number of cached resources
+            uint32_t m_count;
+
+            /// The indices of the cached resources
+            uint32_t m_indices[thread_cache_size];
+        };
+
+        /// The caches of a single thread. When the thread exits any
+        /// cached resources are returned to the global free lists.
+        struct thread_cache
+        {
+            ~thread_cache()
+                {
+                    for(uint32_t i = 0; i < m_entries.size(); ++i)
+                        flush(m_entries[i]);
+                }
+
+            /// Returns the cached resources to the global free list
+            void flush(cache_entry &entry)
+                {
+                    boost::shared_ptr<impl> pool = entry.m_pool.lock();
+
+                    if(pool)
+                    {
+                        for(uint32_t i = 0; i < entry.m_count; ++i)
+                            pool->push(entry.m_indices[i]);
+                    }
+
+                    entry.m_count = 0;
+                }
+
+            /// @return The cache entry of the pool, creating it if needed
+            cache_entry& find(const boost::shared_ptr<impl> &pool)
+                {
+                    for(uint32_t i = 0; i < m_entries.size(); ++i)
+                    {
+                        if(m_entries[i].m_id == pool->m_id)
+                            return m_entries[i];
+                    }
+
+                    // Drop the entries of destroyed pools
+                    for(uint32_t i = 0; i < m_entries.size();)
+                    {
+                        if(m_entries[i].m_pool.expired())
+                        {
+                            m_entries[i] = m_entries.back();
+                            m_entries.pop_back();
+                        }
+                        else
+                        {
+                            ++i;
+                        }
+                    }
+
+                    cache_entry entry;
+                    entry.m_id = pool->m_id;
+                    entry.m_pool = pool;
+                    entry.m_count = 0;
+
+                    m_entries.push_back(entry);
+                    return m_entries.back();
+                }
+
+            /// The cache entries
+            std::vector<cache_entry> m_entries;
+        };
+
+        /// Returns the resource to the pool when the last reference
+        /// is released
+        struct recycler
+        {
+            recycler(const boost::shared_ptr<impl> &pool, uint32_t index)
+                : m_pool(pool),
+                  m_index(index)
+                { }
+
+            void operator()(Value*)
+                {
+                    assert(m_pool);
+
+                    m_pool->m_in_use.fetch_sub(1);
+
+                    cache_entry &entry = local_cache().find(m_pool);
+
+                    if(entry.m_count < thread_cache_size)
+                    {
+                        entry.m_indices[entry.m_count++] = m_index;
+                    }
+                    else
+                    {
+                        m_pool->push(m_index);
+                    }
+
+                    m_pool.reset();
+                }
+
+            /// The pool owning the resource
+            boost::shared_ptr<impl> m_pool;
+
+            /// The index of the resource
+            uint32_t m_index;
+        };
+
+    public:
+
+        /// Constructor
+        concurrent_resource_pool()
+            : m_pool(boost::make_shared<impl>())
+            { }
+
+        /// Hands out a recycled resource if one is available, otherwise
+        /// a new resource is built.
+        /// @param make Function returning a pointer to a new resource
+        ///        allocated with new
+        /// @return Pointer to the resource
+        template<class MakeFunction>
+        value_ptr allocate(MakeFunction make)
+            {
+                uint32_t index = npos;
+
+                cache_entry &entry = local_cache().find(m_pool);
+
+                if(entry.m_count > 0)
+                {
+                    index = entry.m_indices[--entry.m_count];
+                }
+                else
+                {
+                    index = m_pool->pop();
+                }
+
+                if(index != npos)
+                {
+                    m_pool->m_reused.fetch_add(1,
+                                               std::memory_order_relaxed);
+                }
+                else
+                {
+                    index = m_pool->add(make());
+                }
+
+                m_pool->acquired();
+
+                node &n = m_pool->at(index);
+
+                return value_ptr(n.m_value, recycler(m_pool, index),
+                                 control_block_allocator<Value>(n.m_slot));
+            }
+
+        /// @return The statistics of the pool
+        concurrent_pool_statistics statistics() const
+            {
+                concurrent_pool_statistics stats;
+                stats.m_allocated = m_pool->m_ready.load();
+                stats.m_reused = m_pool->m_reused.load();
+                stats.m_in_use = m_pool->m_in_use.load();
+                stats.m_high_water = m_pool->m_high_water.load();
+
+                return stats;
+            }
+
+        /// The memory used by the pool, i.e. its bookkeeping, the control
+        /// blocks of the resources and the resources not handed out. The
+        /// resources handed out are accounted for by their users. Since
+        /// the resources are not synchronized with the calling thread the
+        /// memory of every unused resource is taken to be that of the
+        /// first resource built, which is recorded when it is added to
+        /// the pool. The Value type must provide a memory_usage()
+        /// function.
+        /// @return The number of bytes used by the pool
+        uint64_t memory_usage() const
+            {
+                impl &pool = *m_pool;
+
+                uint32_t size = pool.m_ready.load(std::memory_order_acquire);
+                uint32_t in_use = std::min(size, pool.m_in_use.load());
+
+                uint64_t usage = sizeof(impl) +
+                    uint64_t(size) * sizeof(control_block_slot);
+
+                for(uint32_t i = 0; i < max_chunks; ++i)
+                {
+                    if(pool.m_chunks[i].load() != 0)
+                        usage += uint64_t(1U << i) * sizeof(node);
+                }
+
+                if(size > in_use)
+                {
+                    usage += uint64_t(size - in_use) *
+                        pool.m_resource_size.load(std::memory_order_relaxed);
+                }
+
+                return usage;
+            }
+
+    private:
+
+        /// @return The caches of the calling thread
+        static thread_cache& local_cache()
+            {
+                static thread_local thread_cache cache;
+                return cache;
+            }
+
+    private:
+
+        /// The shared state of the pool
+        boost::shared_ptr<impl> m_pool;
+
+    };
+
+}
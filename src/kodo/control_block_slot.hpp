@@ -0,0 +1,186 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace kodo
+{
+
+    /// @brief Memory for the shared pointer control block of a pooled
+    ///        resource.
+    ///
+    /// Handing out a pooled resource as a boost::shared_ptr with a
+    /// deleter allocates a control block. The pools therefore create one
+    /// slot per resource when the resource is constructed and place the
+    /// control block in the slot using the control_block_allocator, so
+    /// handing out a recycled resource does not use the heap.
+    ///
+    /// The slot is reference counted since the pool may be destroyed
+    /// while a control block is alive and a control block may outlive
+    /// the hand-out of its resource if weak pointers remain. The pool
+    /// holds one reference, a control block placed in the slot holds
+    /// another.
+    class control_block_slot
+    {
+    public:
+
+        /// The bytes available for a control block
+        static const uint32_t capacity = 128;
+
+    public:
+
+        /// @return A new slot referenced by the caller
+        static control_block_slot* create()
+        {
+            return new control_block_slot();
+        }
+
+        /// Places a control block in the slot
+        /// @return The memory of the slot or zero if the slot is used by
+        ///         a control block which is still alive
+        void* acquire()
+        {
+            uint32_t expected = 1;
+
+            if(m_references.compare_exchange_strong(expected, 2))
+                return m_data;
+
+            return 0;
+        }
+
+        /// Releases a reference, the slot is destroyed by the last one
+        void release()
+        {
+            if(m_references.fetch_sub(1) == 1)
+                delete this;
+        }
+
+        /// @param pointer The memory of a control block
+        /// @return True if the memory belongs to the slot
+        bool owns(const void *pointer) const
+        {
+            return pointer == m_data;
+        }
+
+    private:
+
+        /// Constructor
+        control_block_slot()
+            : m_references(1)
+        { }
+
+        /// Destructor
+        ~control_block_slot()
+        { }
+
+    private:
+
+        /// The number of references
+        std::atomic<uint32_t> m_references;
+
+        /// The memory of the control block
+        alignas(std::max_align_t) unsigned char m_data[capacity];
+    };
+
+    /// @brief Allocator placing a shared pointer control block in a
+    ///        control_block_slot.
+    ///
+    /// Falls back to the heap if the slot is in use or too small.
+    template<class T>
+    class control_block_allocator
+    {
+    public:
+
+        /// The allocated type
+        typedef T value_type;
+
+        /// Rebinds the allocator to another type
+        template<class U>
+        struct rebind
+        {
+            typedef control_block_allocator<U> other;
+        };
+
+    public:
+
+        /// Constructor
+        /// @param slot The slot used for the control block
+        explicit control_block_allocator(control_block_slot *slot)
+            : m_slot(slot)
+        {
+            assert(m_slot);
+        }
+
+        /// Converting constructor used when the allocator is rebound
+        template<class U>
+        control_block_allocator(const control_block_allocator<U> &other)
+            : m_slot(other.slot())
+        { }
+
+        /// @copydoc std::allocator::allocate(std::size_t)
+        T* allocate(std::size_t n)
+        {
+            if(n * sizeof(T) <= control_block_slot::capacity)
+            {
+                void *memory = m_slot->acquire();
+
+                if(memory)
+                    return static_cast<T*>(memory);
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        }
+
+        /// @copydoc std::allocator::deallocate(T*, std::size_t)
+        void deallocate(T *pointer, std::size_t n)
+        {
+            (void) n;
+
+            if(m_slot->owns(pointer))
+            {
+                m_slot->release();
+            }
+            else
+            {
+                ::operator delete(pointer);
+            }
+        }
+
+        /// @return The slot used for the control block
+        control_block_slot* slot() const
+        {
+            return m_slot;
+        }
+
+    private:
+
+        /// The slot used for the control block
+        control_block_slot *m_slot;
+    };
+
+    /// @return True if the allocators use the same slot
+    template<class T, class U>
+    inline bool operator==(const control_block_allocator<T> &a,
+                           const control_block_allocator<U> &b)
+    {
+        return a.slot() == b.slot();
+    }
+
+    /// @return True if the allocators use different slots
+    template<class T, class U>
+    inline bool operator!=(const control_block_allocator<T> &a,
+                           const control_block_allocator<U> &b)
+    {
+        return !(a == b);
+    }
+
+}
+
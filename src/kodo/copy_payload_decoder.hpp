@@ -25,6 +25,23 @@ namespace kodo
     {
     public:
 
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            // Reserve the largest payload so initialize does not
+            // allocate
+            m_payload_copy.reserve(the_factory.max_payload_size());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + m_payload_copy.capacity();
+        }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
@@ -48,6 +65,25 @@ namespace kodo
             SuperCoder::decode(&m_payload_copy[0]);
         }
 
+        /// Copy the symbol data and header to ensure that they aren't
+        /// overwritten during decoding
+        /// @copydoc layer::decode(uint8_t*, uint8_t*)
+        void decode(const uint8_t *symbol_data,
+                    const uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            std::copy_n(symbol_data, symbol_size, &m_payload_copy[0]);
+            std::copy_n(symbol_header, SuperCoder::header_size(),
+                        &m_payload_copy[symbol_size]);
+
+            SuperCoder::decode(&m_payload_copy[0],
+                               &m_payload_copy[symbol_size]);
+        }
+
     private:
 
         /// Copy of payload
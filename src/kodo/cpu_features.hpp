@@ -0,0 +1,85 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(KODO_DISABLE_SIMD)
+    #define KODO_SIMD_X86 1
+#endif
+
+namespace kodo
+{
+
+    /// The instruction sets for which the simd_finite_field_math layer
+    /// provides region kernels, ordered from the least to the most
+    /// capable.
+    enum simd_backend
+    {
+        /// Plain C++, used on all platforms
+        simd_scalar,
+
+        /// 128 bit additions
+        simd_sse2,
+
+        /// 128 bit additions and table look-up multiplications
+        simd_ssse3,
+
+        /// 256 bit additions and table look-up multiplications
+        simd_avx2
+    };
+
+    /// @param backend The backend
+    /// @return The name of the backend, e.g. for benchmark reports
+    inline const char* simd_backend_name(simd_backend backend)
+    {
+        switch(backend)
+        {
+        case simd_scalar:
+            return "scalar";
+        case simd_sse2:
+            return "sse2";
+        case simd_ssse3:
+            return "ssse3";
+        case simd_avx2:
+            return "avx2";
+        }
+
+        return "unknown";
+    }
+
+    /// Probes the CPU for the supported instruction sets
+    /// @return The most capable backend supported by the CPU
+    inline simd_backend detect_simd_backend()
+    {
+#if defined(KODO_SIMD_X86)
+        __builtin_cpu_init();
+
+        // The check includes the operating system support for saving
+        // the AVX registers
+        if(__builtin_cpu_supports("avx2"))
+            return simd_avx2;
+
+        if(__builtin_cpu_supports("ssse3"))
+            return simd_ssse3;
+
+        if(__builtin_cpu_supports("sse2"))
+            return simd_sse2;
+#endif
+        return simd_scalar;
+    }
+
+    /// The CPU is only probed once per process
+    /// @return The most capable backend supported by the CPU
+    inline simd_backend cpu_simd_backend()
+    {
+        static const simd_backend backend = detect_simd_backend();
+        return backend;
+    }
+
+}
+
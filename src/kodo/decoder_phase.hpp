@@ -0,0 +1,65 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+
+namespace kodo
+{
+
+    /// The phases of the linear_block_decoder which the
+    /// finite_field_volume_counter attributes the finite field
+    /// operations to
+    struct decoder_phase
+    {
+        enum type
+        {
+            /// Operations outside the decoding, e.g. encoding or recoding
+            other = 0,
+
+            /// Eliminating the pivots held by the decoder from a
+            /// received symbol
+            forward_substitution,
+
+            /// Scaling a received symbol so its pivot is one
+            normalization,
+
+            /// Eliminating a new pivot from the symbols held by the
+            /// decoder
+            backward_substitution,
+
+            /// Replacing a coded symbol by an uncoded symbol with the
+            /// same pivot
+            swap_decoding,
+
+            /// The number of phases
+            phase_count
+        };
+
+        /// @param phase The decoder phase
+        /// @return The name of the phase
+        static const char* name(type phase)
+        {
+            switch(phase)
+            {
+            case other:
+                return "other";
+            case forward_substitution:
+                return "forward_substitution";
+            case normalization:
+                return "normalization";
+            case backward_substitution:
+                return "backward_substitution";
+            case swap_decoding:
+                return "swap_decoding";
+            default:
+                assert(0);
+                return "";
+            }
+        }
+    };
+
+}
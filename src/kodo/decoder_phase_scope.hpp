@@ -0,0 +1,78 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include "decoder_phase.hpp"
+#include "has_finite_field_volume_counter.hpp"
+
+namespace kodo
+{
+
+    /// Attributes the finite field operations performed during its
+    /// lifetime to a decoder phase, and restores the previous phase when
+    /// it goes out of scope. If the stack does not contain the
+    /// finite_field_volume_counter the scope does nothing, so the
+    /// decoders may use it without a cost.
+    ///
+    /// Example:
+    ///
+    /// decoder_phase_scope<SuperCoder> scope(
+    ///     *this, decoder_phase::backward_substitution);
+    ///
+    template
+    <
+        class Coder,
+        bool Counted = has_finite_field_volume_counter<Coder>::value
+    >
+    class decoder_phase_scope : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param coder The stack performing the operations
+        /// @param phase The decoder phase of the operations
+        decoder_phase_scope(Coder &coder, decoder_phase::type phase)
+            : m_coder(coder),
+              m_previous(coder.current_decoder_phase())
+        {
+            m_coder.set_decoder_phase(phase);
+        }
+
+        /// Destructor
+        ~decoder_phase_scope()
+        {
+            m_coder.set_decoder_phase(m_previous);
+        }
+
+    private:
+
+        /// The stack performing the operations
+        Coder &m_coder;
+
+        /// The phase restored by the destructor
+        decoder_phase::type m_previous;
+    };
+
+    /// Specialization for the stacks without the
+    /// finite_field_volume_counter
+    template<class Coder>
+    class decoder_phase_scope<Coder, false> : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param coder The stack performing the operations
+        /// @param phase The decoder phase of the operations
+        decoder_phase_scope(Coder &coder, decoder_phase::type phase)
+        {
+            (void) coder;
+            (void) phase;
+        }
+    };
+
+}
@@ -0,0 +1,128 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/make_shared.hpp>
+
+#include "trace_buffer.hpp"
+#include "trace_event.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup debug
+    /// Records the events of the linear_block_decoder in a binary
+    /// trace_buffer. Unlike the debug layers, which print the state of
+    /// the decoder to an ostream, writing an event only stores a time
+    /// stamp, the event and a value in a ring buffer, so the layer may be
+    /// used in decoders under load. The trace_file of a buffer is
+    /// printed as a timeline by the trace_dump tool.
+    ///
+    /// The layer must be placed below the linear_block_decoder, which
+    /// writes the events if the stack contains this layer (see
+    /// decoder_trace_event). The buffer is owned by the coder and kept
+    /// when the coder is recycled by the factory, the events of
+    /// consecutive generations are separated by a
+    /// trace_event::initialized event. A coder is only used by one
+    /// thread at a time, so the buffer has a single writer and other
+    /// threads may read it through get_trace_buffer().
+    template<class SuperCoder>
+    class decoder_trace : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_trace_capacity(4096)
+            { }
+
+            /// Sets the number of events kept by coders constructed
+            /// after the call
+            /// @param capacity The number of events, rounded up to a
+            ///        power of two
+            void set_trace_capacity(uint32_t capacity)
+            {
+                assert(capacity > 0);
+                m_trace_capacity = capacity;
+            }
+
+            /// @return The number of events kept per coder
+            uint32_t trace_capacity() const
+            {
+                return m_trace_capacity;
+            }
+
+        private:
+
+            /// The number of events kept per coder
+            uint32_t m_trace_capacity;
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_trace = boost::make_shared<trace_buffer>(
+                the_factory.trace_capacity());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            assert(m_trace);
+            m_trace->write(trace_event::initialized, the_factory.symbols());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            assert(m_trace);
+            return SuperCoder::memory_usage() + m_trace->memory_usage();
+        }
+
+        /// Writes an event to the trace
+        /// @param event The event
+        /// @param value The value of the event
+        void write_trace_event(trace_event::type event, uint32_t value)
+        {
+            assert(m_trace);
+            m_trace->write(event, value);
+        }
+
+        /// @return The buffer holding the events, which stays valid
+        ///         after the coder has been released
+        const boost::shared_ptr<trace_buffer>& get_trace_buffer() const
+        {
+            assert(m_trace);
+            return m_trace;
+        }
+
+    private:
+
+        /// The events of the coder
+        boost::shared_ptr<trace_buffer> m_trace;
+
+    };
+
+}
@@ -0,0 +1,61 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "trace_event.hpp"
+#include "has_decoder_trace.hpp"
+
+namespace kodo
+{
+
+    /// Writes the events of a decoder to the decoder_trace layer. If
+    /// the stack does not contain the decoder_trace the events are
+    /// discarded at compile time, so the decoders may write them
+    /// without a cost.
+    ///
+    /// Example:
+    ///
+    /// decoder_trace_event<SuperCoder>::write(
+    ///     *this, trace_event::pivot_found, pivot_index);
+    ///
+    template
+    <
+        class Coder,
+        bool Traced = has_decoder_trace<Coder>::value
+    >
+    struct decoder_trace_event
+    {
+        /// Writes an event
+        /// @param coder The stack writing the event
+        /// @param event The event
+        /// @param value The value of the event
+        static void write(Coder &coder, trace_event::type event,
+                          uint32_t value)
+        {
+            coder.write_trace_event(event, value);
+        }
+    };
+
+    /// Specialization for the stacks without the decoder_trace
+    template<class Coder>
+    struct decoder_trace_event<Coder, false>
+    {
+        /// Discards an event
+        /// @param coder The stack writing the event
+        /// @param event The event
+        /// @param value The value of the event
+        static void write(Coder &coder, trace_event::type event,
+                          uint32_t value)
+        {
+            (void) coder;
+            (void) event;
+            (void) value;
+        }
+    };
+
+}
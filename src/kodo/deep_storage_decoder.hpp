@@ -13,6 +13,8 @@
 
 #include <sak/storage.hpp>
 
+#include "memory_policy.hpp"
+#include "page_memory.hpp"
 #include "object_decoder.hpp"
 #include "rfc5052_partitioning_scheme.hpp"
 #include "has_shallow_symbol_storage.hpp"
@@ -57,14 +59,26 @@ namespace kodo
         /// Constructs a new storage decoder
         /// @param factory The decoder factory to use
         /// @param object_size The size of the object to be decoded in bytes
-        /// @param decoding_buffer The storage where the object will be
-        ///        decoded
-        deep_storage_decoder(factory &factory, uint32_t object_size) :
-            base_decoder(factory, object_size)
+        /// @param policy The policy used to allocate the decoding buffer,
+        ///        by default the buffer is allocated from the heap
+        deep_storage_decoder(factory &factory, uint32_t object_size,
+                             const memory_policy &policy = memory_policy()) :
+            base_decoder(factory, object_size),
+            m_decoding_data(0),
+            m_decoding_size(m_partitioning.total_block_size())
         {
-            // Resize the decoding storage buffer to be large enough
-            m_decoding_storage.resize(
-                m_partitioning.total_block_size(), '\0');
+            if(policy.m_huge_pages == memory_policy::huge_pages_none &&
+               !policy.m_numa_local)
+            {
+                // Resize the decoding storage buffer to be large enough
+                m_decoding_storage.resize(m_decoding_size, '\0');
+                m_decoding_data = &m_decoding_storage[0];
+            }
+            else
+            {
+                m_decoding_memory.allocate(m_decoding_size, policy);
+                m_decoding_data = m_decoding_memory.data();
+            }
         }
 
         /// @copydoc object_decoder::build(uint32_t)
@@ -75,7 +89,8 @@ namespace kodo
             uint32_t offset = m_partitioning.byte_offset(decoder_id);
             uint32_t block_size = m_partitioning.block_size(decoder_id);
 
-            sak::mutable_storage data = sak::storage(m_decoding_storage);
+            sak::mutable_storage data =
+                sak::storage(m_decoding_data, m_decoding_size);
             data += offset;
 
             assert(data.m_size >= block_size);
@@ -95,26 +110,40 @@ namespace kodo
         /// @return A pointer to the decoded storage class
         const uint8_t* data() const
             {
-                return &m_decoding_storage[0];
+                return m_decoding_data;
             }
 
         /// @copydoc data() const
         uint8_t* data()
             {
-                return &m_decoding_storage[0];
+                return m_decoding_data;
             }
 
         /// If you wish to take ownership of the decoded data you may
         /// you the swap function to get the std::vector. This should
-        /// not be called until all decoders have completed.
+        /// not be called until all decoders have completed. If the
+        /// decoding buffer was allocated using a huge page or NUMA
+        /// policy the decoded data is copied to the vector instead.
         ///
         /// @param decoding_storage The vector two swap with the internal
         ///        vector
         void swap(std::vector<uint8_t> &decoding_storage)
             {
+                if(m_decoding_memory.size() > 0)
+                {
+                    decoding_storage.assign(
+                        m_decoding_data,
+                        m_decoding_data + base_decoder::object_size());
+                    return;
+                }
+
                 // Resize the storage buffer to have the object size
                 m_decoding_storage.resize(base_decoder::object_size());
                 m_decoding_storage.swap(decoding_storage);
+
+                m_decoding_size = m_decoding_storage.size();
+                m_decoding_data = m_decoding_size > 0 ?
+                    &m_decoding_storage[0] : 0;
             }
 
     private:
@@ -122,6 +151,16 @@ namespace kodo
         /// The storage where the decoded data should be placed
         std::vector<uint8_t> m_decoding_storage;
 
+        /// The storage used instead of the vector if a huge page or
+        /// NUMA policy was requested
+        page_memory m_decoding_memory;
+
+        /// Pointer to the decoding buffer
+        uint8_t *m_decoding_data;
+
+        /// The size of the decoding buffer in bytes
+        uint32_t m_decoding_size;
+
     };
 
 }
@@ -5,12 +5,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
 #include <fifi/fifi_utils.hpp>
 #include <sak/storage.hpp>
 
+#include "coder_arena.hpp"
+
 namespace kodo
 {
 
@@ -20,7 +23,12 @@ namespace kodo
     ///        buffer internally.
     ///
     /// This is useful in cases where incoming data is to be
-    /// decoded and no existing decoding buffer exist.
+    /// decoded and no existing decoding buffer exist. The coding buffer
+    /// is reserved in the coder arena.
+    ///
+    /// When a coder is recycled only the part of the buffer used by the
+    /// previous block is cleared, so re-initializing a coder built by a
+    /// factory with large maximum values is cheap for small blocks.
     template<class SuperCoder>
     class deep_symbol_storage : public SuperCoder
     {
@@ -31,6 +39,37 @@ namespace kodo
 
     public:
 
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                return SuperCoder::factory::arena_size() +
+                    coder_arena::aligned_size(
+                        SuperCoder::factory::max_symbols() *
+                        SuperCoder::factory::max_symbol_size());
+            }
+        };
+
+    public:
+
+        /// Constructor
+        deep_symbol_storage()
+            : m_data(0),
+              m_data_size(0),
+              m_dirty_size(0),
+              m_dirty_symbols(0)
+        { }
+
         /// @copydoc layer::construct(Factory&)
         template<class Factory>
         void construct(Factory& the_factory)
@@ -43,13 +82,20 @@ namespace kodo
             assert(max_data_needed > 0);
 
             // Construct should only be called once so
-            // m_data.size() should be zero
-            assert(m_data.size() == 0);
-            m_data.resize(max_data_needed, 0);
+            // m_data should be zero
+            assert(m_data == 0);
+            m_data = SuperCoder::arena_allocate(max_data_needed);
+            m_data_size = max_data_needed;
 
             m_symbols.resize(the_factory.max_symbols(), false);
         }
 
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + (m_symbols.capacity() + 7) / 8;
+        }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
@@ -59,8 +105,14 @@ namespace kodo
             /// @todo This should not be necessary - we should not
             ///       use data which has not been initialized yet
             ///       anyway
-            std::fill(m_data.begin(), m_data.end(), 0);
-            std::fill(m_symbols.begin(), m_symbols.end(), false);
+            ///
+            /// Everything beyond the dirty region is still zero, so we
+            /// only clear what the previous block used
+            std::fill_n(m_data, m_dirty_size, 0);
+            std::fill_n(m_symbols.begin(), m_dirty_symbols, false);
+
+            m_dirty_size = SuperCoder::block_size();
+            m_dirty_symbols = SuperCoder::symbols();
 
             m_symbols_count = 0;
         }
@@ -91,14 +143,20 @@ namespace kodo
             return reinterpret_cast<const value_type*>(symbol(index));
         }
 
+        /// Exchanges the symbol data with the contents of the vector.
+        /// The symbol data lives in the coder arena, so unlike swapping
+        /// two vectors this copies the whole block both ways, i.e. the
+        /// cost is O(block_size). Use set_symbols() if the data of the
+        /// vector is not needed afterwards, which copies it only once.
         /// @copydoc layer::swap_symbols(std::vector<uint8_t> &)
         void swap_symbols(std::vector<uint8_t> &symbols)
         {
-            assert(m_data.size() == symbols.size());
-            m_data.swap(symbols);
+            assert(m_data_size == symbols.size());
+            std::swap_ranges(symbols.begin(), symbols.end(), m_data);
+            m_dirty_size = m_data_size;
 
             m_symbols_count = SuperCoder::symbols();
-            std::fill(m_symbols.begin(), m_symbols.end(), true);
+            std::fill_n(m_symbols.begin(), m_symbols_count, true);
         }
 
         /// @copydoc layer::set_symbols(const sak::const_storage&)
@@ -110,13 +168,13 @@ namespace kodo
                    SuperCoder::symbols() * SuperCoder::symbol_size());
 
             // Use the copy function
-            copy_storage(sak::storage(m_data), symbol_storage);
+            copy_storage(sak::storage(m_data, m_data_size), symbol_storage);
 
             // This will specify all symbols, also in the case
             // of partial data. If this is not desired then the
             // symbols need to be set individually.
             m_symbols_count = SuperCoder::symbols();
-            std::fill(m_symbols.begin(), m_symbols.end(), true);
+            std::fill_n(m_symbols.begin(), m_symbols_count, true);
         }
 
         /// @copydoc layer::set_symbol(uint32_t, const sak::const_storage&)
@@ -126,7 +184,8 @@ namespace kodo
             assert(symbol.m_size == SuperCoder::symbol_size());
             assert(index < SuperCoder::symbols());
 
-            sak::mutable_storage dest_data = sak::storage(m_data);
+            sak::mutable_storage dest_data =
+                sak::storage(m_data, m_data_size);
 
             uint32_t offset = index * SuperCoder::symbol_size();
             dest_data += offset;
@@ -216,8 +275,19 @@ namespace kodo
 
     private:
 
-        /// Storage for the symbol data
-        std::vector<uint8_t> m_data;
+        /// Storage for the symbol data, reserved in the coder arena
+        uint8_t *m_data;
+
+        /// The size of the symbol data storage in bytes
+        uint32_t m_data_size;
+
+        /// The number of bytes at the start of the buffer which may have
+        /// been written since it was last cleared
+        uint32_t m_dirty_size;
+
+        /// The number of symbol flags which may have been set since they
+        /// were last cleared
+        uint32_t m_dirty_symbols;
 
         /// Symbols count
         uint32_t m_symbols_count;
@@ -0,0 +1,107 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace kodo
+{
+
+    /// @ingroup codec_header_layers
+    ///
+    /// @brief Drops coded symbols carrying a seed which was already
+    ///        received in the current generation.
+    ///
+    /// A symbol generated from a known seed is a linear combination
+    /// of an already received symbol and cannot increase the rank. The
+    /// check is done on the seed in the symbol header before any
+    /// coefficients are generated and before any elimination work is
+    /// done. The layer must be placed above a Symbol ID layer
+    /// providing the read_seed(const uint8_t*) function, e.g.
+    /// seed_symbol_id_reader.
+    template<class SuperCoder>
+    class duplicate_seed_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::seed_type
+        typedef typename SuperCoder::seed_type seed_type;
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            // Room for the seeds of the non-innovative symbols, once
+            // full further seeds are not recorded so decode does not
+            // allocate
+            m_seeds.reserve(2 * the_factory.max_symbols());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                m_seeds.capacity() * sizeof(seed_type);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_seeds.clear();
+            m_duplicate_seeds = 0;
+        }
+
+        /// @copydoc layer::decode(uint8_t*, uint8_t*)
+        void decode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            seed_type seed = SuperCoder::read_seed(symbol_header);
+
+            typename std::vector<seed_type>::iterator it =
+                std::lower_bound(m_seeds.begin(), m_seeds.end(), seed);
+
+            if(it != m_seeds.end() && *it == seed)
+            {
+                ++m_duplicate_seeds;
+                return;
+            }
+
+            if(m_seeds.size() < m_seeds.capacity())
+                m_seeds.insert(it, seed);
+
+            SuperCoder::decode(symbol_data, symbol_header);
+        }
+
+        /// @return The number of symbols dropped in the current
+        ///         generation because their seed was already received
+        uint32_t duplicate_seeds() const
+        {
+            return m_duplicate_seeds;
+        }
+
+    private:
+
+        /// The seeds received in the current generation kept sorted
+        std::vector<seed_type> m_seeds;
+
+        /// The number of dropped symbols
+        uint32_t m_duplicate_seeds;
+
+    };
+
+}
+
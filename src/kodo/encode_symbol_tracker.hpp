@@ -7,6 +7,8 @@
 
 #include <cstdint>
 
+#include <sak/storage.hpp>
+
 namespace kodo
 {
 
@@ -44,6 +46,13 @@ namespace kodo
             ++m_counter;
         }
 
+        /// @copydoc layer::encode_symbol_view(uint32_t)
+        sak::const_storage encode_symbol_view(uint32_t symbol_index)
+        {
+            ++m_counter;
+            return SuperCoder::encode_symbol_view(symbol_index);
+        }
+
         /// @return the symbol encoded counter
         uint32_t encode_symbol_count() const
         {
@@ -41,7 +41,8 @@ namespace kodo
         /// Construct a new file reader
         /// @param filename of the file to use
         /// @param data_size the number of bytes needed by the temporary
-        ///        memory buffer to be used with encoder->swap_symbols()
+        ///        memory buffer to be used with encoder->swap_symbols(),
+        ///        which copies the buffer into the encoder storage
         file_reader(const std::string &filename,
                     uint32_t data_size)
         {
@@ -10,6 +10,9 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/make_shared.hpp>
 
+#include "coder_arena.hpp"
+#include "memory_policy.hpp"
+
 namespace kodo
 {
 
@@ -58,6 +61,36 @@ namespace kodo
                 return coder;
             }
 
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                // The layers reserving memory in the arena add
+                // their size to this
+                return 0;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                // The layers holding memory add their usage to this
+                return 0;
+            }
+
+            /// Sets the policy used to allocate the memory of the coders
+            /// built by the factory
+            /// @param policy The memory policy
+            void set_memory_policy(const kodo::memory_policy &policy)
+            {
+                m_memory_policy = policy;
+            }
+
+            /// @return The policy used to allocate the memory of the
+            ///         coders built by the factory
+            const kodo::memory_policy& memory_policy() const
+            {
+                return m_memory_policy;
+            }
+
         private: // Make non-copyable
 
             /// Copy constructor
@@ -66,6 +99,11 @@ namespace kodo
             /// Copy assignment
             const factory& operator=(const factory&);
 
+        private:
+
+            /// The memory policy of the coders
+            kodo::memory_policy m_memory_policy;
+
         };
 
     public:
@@ -74,8 +112,10 @@ namespace kodo
         template<class Factory>
         void construct(Factory &the_factory)
         {
-            /// This is the final factory layer so we do nothing
-            (void) the_factory;
+            /// This is the final factory layer so we only prepare the
+            /// arena used by the other layers
+            m_arena.resize(the_factory.arena_size(),
+                           the_factory.memory_policy());
         }
 
         /// @copydoc layer::initialize(Factory&)
@@ -86,6 +126,30 @@ namespace kodo
             (void) the_factory;
         }
 
+        /// @copydoc layer::arena_allocate(uint32_t)
+        uint8_t* arena_allocate(uint32_t size)
+        {
+            return m_arena.allocate(size);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            // The layers holding memory outside the arena add their
+            // usage to this
+            return sizeof(FinalType) + m_arena.memory().allocated_size();
+        }
+
+        /// @copydoc layer::adopt_symbol(uint32_t, const uint8_t*)
+        bool adopt_symbol(uint32_t index, const uint8_t *symbol_data)
+        {
+            /// This is the final layer so the symbol data is copied
+            (void) index;
+            (void) symbol_data;
+
+            return false;
+        }
+
     protected:
 
         /// Constructor
@@ -104,6 +168,11 @@ namespace kodo
         /// Copy assignment
         const final_coder_factory& operator=(
             const final_coder_factory&);
+
+    private:
+
+        /// The memory shared by the layers of the coder
+        coder_arena m_arena;
     };
 }
 
@@ -0,0 +1,216 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <boost/shared_ptr.hpp>
+
+#include "coder_arena.hpp"
+#include "memory_policy.hpp"
+#include "concurrent_resource_pool.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup factory_layers
+    /// Terminates the layered coder and contains the coder final
+    /// factory. Like the final_coder_factory_pool this factory recycles
+    /// encoders/decoders, however the build() function may be called
+    /// concurrently from several threads and coders may be released by
+    /// a different thread than the one which built them. This allows a
+    /// single factory, and thereby a single copy of e.g. the finite field
+    /// tables, to serve all threads.
+    ///
+    /// Note that the other factory layers must not be modified e.g. using
+    /// set_symbols() while coders are built concurrently.
+    template<class FinalType>
+    class final_coder_factory_concurrent_pool
+    {
+    public:
+
+        /// Pointer type to the constructed coder
+        typedef boost::shared_ptr<FinalType> pointer;
+
+        /// @ingroup factory_layers
+        /// The final factory
+        class factory
+        {
+        public:
+
+            /// The factory type
+            typedef typename FinalType::factory factory_type;
+
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+            {
+                (void) max_symbols;
+                (void) max_symbol_size;
+            }
+
+            /// @copydoc layer::factory::build()
+            pointer build()
+            {
+                factory_type *this_factory =
+                    static_cast<factory_type*>(this);
+
+                pointer coder = m_pool.allocate(coder_maker(this_factory));
+                coder->initialize(*this_factory);
+
+                return coder;
+            }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                // The layers reserving memory in the arena add
+                // their size to this
+                return 0;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                // The layers holding memory add their usage to this,
+                // here the coders kept in the pool are accounted for
+                return m_pool.memory_usage();
+            }
+
+            /// Sets the policy used to allocate the memory of the coders
+            /// built by the factory
+            /// @param policy The memory policy
+            void set_memory_policy(const kodo::memory_policy &policy)
+            {
+                m_memory_policy = policy;
+            }
+
+            /// @return The policy used to allocate the memory of the
+            ///         coders built by the factory
+            const kodo::memory_policy& memory_policy() const
+            {
+                return m_memory_policy;
+            }
+
+            /// @return The allocation, reuse and high-water statistics of
+            ///         the coder pool
+            concurrent_pool_statistics pool_statistics() const
+            {
+                return m_pool.statistics();
+            }
+
+        private: // Make non-copyable
+
+            /// Copy constructor
+            factory(const factory&);
+
+            /// Copy assignment
+            const factory& operator=(const factory&);
+
+        private:
+
+            /// Function object used by the pool to build new coders
+            /// if needed.
+            struct coder_maker
+            {
+                coder_maker(factory_type *the_factory)
+                    : m_factory(the_factory)
+                { }
+
+                FinalType* operator()() const
+                {
+                    FinalType *coder = new FinalType();
+                    coder->construct(*m_factory);
+
+                    return coder;
+                }
+
+                factory_type *m_factory;
+            };
+
+        private:
+
+            /// Resource pool for the coders
+            concurrent_resource_pool<FinalType> m_pool;
+
+            /// The memory policy of the coders
+            kodo::memory_policy m_memory_policy;
+
+        };
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            // This is the final factory layer so we only prepare the
+            // arena used by the other layers
+            m_arena.resize(the_factory.arena_size(),
+                           the_factory.memory_policy());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            // This is the final factory layer so we do nothing
+            (void) the_factory;
+        }
+
+        /// @copydoc layer::arena_allocate(uint32_t)
+        uint8_t* arena_allocate(uint32_t size)
+        {
+            return m_arena.allocate(size);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            // The layers holding memory outside the arena add their
+            // usage to this
+            return sizeof(FinalType) + m_arena.memory().allocated_size();
+        }
+
+        /// @copydoc layer::adopt_symbol(uint32_t, const uint8_t*)
+        bool adopt_symbol(uint32_t index, const uint8_t *symbol_data)
+        {
+            /// This is the final layer so the symbol data is copied
+            (void) index;
+            (void) symbol_data;
+
+            return false;
+        }
+
+    protected:
+
+        /// Constructor
+        final_coder_factory_concurrent_pool()
+        { }
+
+        /// Destructor
+        ~final_coder_factory_concurrent_pool()
+        { }
+
+    private: // Make non-copyable
+
+        /// Copy constructor
+        final_coder_factory_concurrent_pool(
+            const final_coder_factory_concurrent_pool&);
+
+        /// Copy assignment
+        const final_coder_factory_concurrent_pool& operator=(
+            const final_coder_factory_concurrent_pool&);
+
+    private:
+
+        /// The memory shared by the layers of the coder
+        coder_arena m_arena;
+
+    };
+}
+
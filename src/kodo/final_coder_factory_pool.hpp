@@ -7,10 +7,12 @@
 
 #include <cstdint>
 
+#include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/make_shared.hpp>
 
-#include <sak/resource_pool.hpp>
+#include "coder_arena.hpp"
+#include "memory_policy.hpp"
+#include "recycling_pool.hpp"
 
 namespace kodo
 {
@@ -19,6 +21,7 @@ namespace kodo
     /// Terminates the layered coder and contains the coder final
     /// factory. The pool factory uses a memory pool to recycle
     /// encoders/decoders, and thereby minimize memory consumption.
+    /// Building a recycled coder does not use the heap.
     template<class FinalType>
     class final_coder_factory_pool
     {
@@ -56,14 +59,45 @@ namespace kodo
                 return coder;
             }
 
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                // The layers reserving memory in the arena add
+                // their size to this
+                return 0;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                // The layers holding memory add their usage to this,
+                // here the coders kept in the pool are accounted for
+                return m_pool.memory_usage();
+            }
+
+            /// Sets the policy used to allocate the memory of the coders
+            /// built by the factory
+            /// @param policy The memory policy
+            void set_memory_policy(const kodo::memory_policy &policy)
+            {
+                m_memory_policy = policy;
+            }
+
+            /// @return The policy used to allocate the memory of the
+            ///         coders built by the factory
+            const kodo::memory_policy& memory_policy() const
+            {
+                return m_memory_policy;
+            }
+
             /// @return A reference to the internal resource pool
-            const sak::resource_pool<FinalType>& pool() const
+            const recycling_pool<FinalType>& pool() const
             {
                 return m_pool;
             }
 
             /// @return A reference to the internal resource pool
-            sak::resource_pool<FinalType>& pool()
+            recycling_pool<FinalType>& pool()
             {
                 return m_pool;
             }
@@ -84,12 +118,12 @@ namespace kodo
             /// @param max_symbols The maximum symbols that are supported
             /// @param max_symbol_size The maximum size of a symbol in
             ///        bytes
-            static pointer make_coder(factory *f_ptr)
+            static FinalType* make_coder(factory *f_ptr)
             {
                 factory_type *this_factory =
                     static_cast<factory_type*>(f_ptr);
 
-                pointer coder = boost::make_shared<FinalType>();
+                FinalType *coder = new FinalType();
                 coder->construct(*this_factory);
 
                 return coder;
@@ -98,7 +132,10 @@ namespace kodo
         private:
 
             /// Resource pool for the coders
-            sak::resource_pool<FinalType> m_pool;
+            recycling_pool<FinalType> m_pool;
+
+            /// The memory policy of the coders
+            kodo::memory_policy m_memory_policy;
 
         };
 
@@ -108,8 +145,10 @@ namespace kodo
         template<class Factory>
         void construct(Factory& the_factory)
         {
-            // This is the final factory layer so we do nothing
-            (void) the_factory;
+            // This is the final factory layer so we only prepare the
+            // arena used by the other layers
+            m_arena.resize(the_factory.arena_size(),
+                           the_factory.memory_policy());
         }
 
         /// @copydoc layer::initialize(Factory&)
@@ -120,6 +159,30 @@ namespace kodo
             (void) the_factory;
         }
 
+        /// @copydoc layer::arena_allocate(uint32_t)
+        uint8_t* arena_allocate(uint32_t size)
+        {
+            return m_arena.allocate(size);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            // The layers holding memory outside the arena add their
+            // usage to this
+            return sizeof(FinalType) + m_arena.memory().allocated_size();
+        }
+
+        /// @copydoc layer::adopt_symbol(uint32_t, const uint8_t*)
+        bool adopt_symbol(uint32_t index, const uint8_t *symbol_data)
+        {
+            /// This is the final layer so the symbol data is copied
+            (void) index;
+            (void) symbol_data;
+
+            return false;
+        }
+
     protected:
 
         /// Constructor
@@ -139,6 +202,11 @@ namespace kodo
         const final_coder_factory_pool& operator=(
             const final_coder_factory_pool&);
 
+    private:
+
+        /// The memory shared by the layers of the coder
+        coder_arena m_arena;
+
     };
 }
 
@@ -61,6 +61,16 @@ namespace kodo
                 m_field = boost::make_shared<field_impl>();
             }
 
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                // Only the field object itself is visible here, any
+                // tables the field implementation allocates on the heap
+                // are not accounted for
+                return SuperCoder::factory::memory_usage() +
+                    sizeof(field_impl);
+            }
+
         private:
 
             /// Give the layer access
@@ -104,6 +114,13 @@ namespace kodo
             m_field = the_factory.field();
         }
 
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                m_temp_symbol.capacity() * sizeof(value_type);
+        }
+
         /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
         void multiply(value_type *symbol_dest, value_type coefficient,
                       uint32_t symbol_length)
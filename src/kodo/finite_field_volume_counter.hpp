@@ -0,0 +1,187 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "decoder_phase.hpp"
+#include "operations_volume.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup debug
+    /// This layer "intercepts" all calls to the finite_field_math
+    /// layer counting the calls and the bytes processed by the
+    /// different operations.
+    ///
+    /// Unlike the finite_field_counter an operation on a 16 byte
+    /// coefficient vector and one on a 64 KB symbol are told apart: the
+    /// operations are counted separately for the coding coefficients and
+    /// the symbol data, and for each decoder_phase. The
+    /// linear_block_decoder sets the phase of the operations it performs
+    /// if the stack contains this layer (see decoder_phase_scope), all
+    /// other operations are counted in decoder_phase::other. In the same
+    /// way it marks the operations on the coding coefficients (see
+    /// operations_buffer_scope), all other operations are counted as
+    /// symbol data.
+    template<class SuperCoder>
+    class finite_field_volume_counter : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// @copydoc layer::factory
+        typedef typename SuperCoder::factory factory;
+
+    public:
+
+        /// Constructor
+        finite_field_volume_counter()
+            : m_phase(decoder_phase::other),
+              m_buffer(operations_volume::symbol_data)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_phase = decoder_phase::other;
+            m_buffer = operations_volume::symbol_data;
+            m_volume.reset();
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        void multiply(value_type *symbol_dest, value_type coefficient,
+                      uint32_t symbol_length)
+        {
+            count(operations_volume::multiply, symbol_length);
+            SuperCoder::multiply(symbol_dest, coefficient, symbol_length);
+        }
+
+        /// @copydoc layer::multipy_add(value_type *, const value_type*,
+        ///                             value_type, uint32_t)
+        void multiply_add(value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient, uint32_t symbol_length)
+        {
+            count(operations_volume::multiply_add, symbol_length);
+            SuperCoder::multiply_add(symbol_dest, symbol_src,
+                                     coefficient, symbol_length);
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length)
+        {
+            count(operations_volume::add, symbol_length);
+            SuperCoder::add(symbol_dest, symbol_src, symbol_length);
+        }
+
+        /// @copydoc layer::multiply_subtract(
+        ///              value_type*, const value_type*,
+        ///              value_type, uint32_t)
+        void multiply_subtract(value_type *symbol_dest,
+                               const value_type *symbol_src,
+                               value_type coefficient,
+                               uint32_t symbol_length)
+        {
+            count(operations_volume::multiply_subtract, symbol_length);
+            SuperCoder::multiply_subtract(symbol_dest, symbol_src,
+                                          coefficient, symbol_length);
+        }
+
+        /// @copydoc layer::subtract(
+        ///              value_type*,const value_type*, uint32_t)
+        void subtract(value_type *symbol_dest, const value_type *symbol_src,
+                      uint32_t symbol_length)
+        {
+            count(operations_volume::subtract, symbol_length);
+            SuperCoder::subtract(symbol_dest, symbol_src, symbol_length);
+        }
+
+        /// @copydoc layer::invert(value_type)
+        value_type invert(value_type value)
+        {
+            m_volume.count_invert(m_phase);
+            return SuperCoder::invert(value);
+        }
+
+        /// Sets the decoder phase the following operations are
+        /// attributed to
+        /// @param phase The decoder phase
+        void set_decoder_phase(decoder_phase::type phase)
+        {
+            assert(phase < decoder_phase::phase_count);
+            m_phase = phase;
+        }
+
+        /// @return The decoder phase the operations are attributed to
+        decoder_phase::type current_decoder_phase() const
+        {
+            return m_phase;
+        }
+
+        /// Sets the buffer the following operations are attributed to
+        /// @param buffer The buffer
+        void set_operations_buffer(operations_volume::buffer buffer)
+        {
+            assert(buffer < operations_volume::buffer_count);
+            m_buffer = buffer;
+        }
+
+        /// @return The buffer the operations are attributed to
+        operations_volume::buffer current_operations_buffer() const
+        {
+            return m_buffer;
+        }
+
+        /// @return The calls and bytes of the operations counted
+        const operations_volume& get_operations_volume() const
+        {
+            return m_volume;
+        }
+
+        /// Reset the counted calls and bytes
+        void reset_operations_volume()
+        {
+            m_volume.reset();
+        }
+
+    private:
+
+        /// Counts an operation in the current phase and buffer
+        /// @param op The operation
+        /// @param length The length of the destination buffer in
+        ///        value_type elements
+        void count(operations_volume::operation op, uint32_t length)
+        {
+            m_volume.count(m_phase, op, m_buffer,
+                           uint64_t(length) * sizeof(value_type));
+        }
+
+    private:
+
+        /// The calls and bytes counted
+        operations_volume m_volume;
+
+        /// The decoder phase of the operations
+        decoder_phase::type m_phase;
+
+        /// The buffer of the operations
+        operations_volume::buffer m_buffer;
+
+    };
+
+}
@@ -0,0 +1,156 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup symbol_storage_layers
+    ///
+    /// @brief Same as the storage_block_info but with the number of
+    ///        symbols and the symbol size fixed at compile time.
+    ///
+    /// Since layer::symbols(), layer::symbol_size() and
+    /// layer::symbol_length() return constants, the compiler may unroll
+    /// and vectorize the loops of the codec layers and the finite field
+    /// kernels for the geometry. A coder using this layer can only code
+    /// blocks of exactly Symbols symbols of SymbolSize bytes, other
+    /// geometries should use a stack with the storage_block_info, see
+    /// also the geometry_registry.
+    template<uint32_t Symbols, uint32_t SymbolSize, class SuperCoder>
+    class fixed_storage_block_info : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+        /// The number of symbols of the geometry
+        static const uint32_t fixed_symbols = Symbols;
+
+        /// The symbol size in bytes of the geometry
+        static const uint32_t fixed_symbol_size = SymbolSize;
+
+        static_assert(Symbols > 0, "The geometry must have symbols");
+
+        static_assert(SymbolSize > 0 &&
+                      (SymbolSize % sizeof(value_type)) == 0,
+                      "The symbol size must be a multiple of the size "
+                      "of the field values");
+
+    public:
+
+        /// @ingroup factory_layers
+        /// @brief Provides the fixed symbol and symbol size information.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// Constructor, the values must match the fixed geometry
+            /// @param max_symbols the maximum symbols this coder can expect
+            /// @param max_symbol_size the maximum size of a symbol in bytes
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            {
+                assert(max_symbols == Symbols);
+                assert(max_symbol_size == SymbolSize);
+            }
+
+            /// @copydoc layer::factory::max_symbols() const
+            uint32_t max_symbols() const
+            {
+                return Symbols;
+            }
+
+            /// @copydoc layer::factory::max_symbol_size() const
+            uint32_t max_symbol_size() const
+            {
+                return SymbolSize;
+            }
+
+            /// @copydoc layer::factory::max_block_size() const
+            uint32_t max_block_size() const
+            {
+                return Symbols * SymbolSize;
+            }
+
+            /// @copydoc layer::factory::symbols() const;
+            uint32_t symbols() const
+            {
+                return Symbols;
+            }
+
+            /// @copydoc layer::factory::symbol_size() const;
+            uint32_t symbol_size() const
+            {
+                return SymbolSize;
+            }
+
+            /// The number of symbols is fixed, so it may only be set to
+            /// the fixed value
+            /// @copydoc layer::factory::set_symbols(uint32_t)
+            void set_symbols(uint32_t symbols)
+            {
+                assert(symbols == Symbols);
+                (void) symbols;
+            }
+
+            /// The symbol size is fixed, so it may only be set to the
+            /// fixed value
+            /// @copydoc layer::factory::set_symbol_size(uint32_t)
+            void set_symbol_size(uint32_t symbol_size)
+            {
+                assert(symbol_size == SymbolSize);
+                (void) symbol_size;
+            }
+        };
+
+    public:
+
+        /// @copydoc layer::symbols() const
+        uint32_t symbols() const
+        {
+            return Symbols;
+        }
+
+        /// @copydoc layer::symbol_size() const
+        uint32_t symbol_size() const
+        {
+            return SymbolSize;
+        }
+
+        /// @copydoc layer::symbol_length() const
+        uint32_t symbol_length() const
+        {
+            return fifi::size_to_length<field_type>(SymbolSize);
+        }
+
+        /// @copydoc layer::block_size() const
+        uint32_t block_size() const
+        {
+            return Symbols * SymbolSize;
+        }
+    };
+
+    template<uint32_t Symbols, uint32_t SymbolSize, class SuperCoder>
+    const uint32_t
+    fixed_storage_block_info<Symbols, SymbolSize, SuperCoder>::fixed_symbols;
+
+    template<uint32_t Symbols, uint32_t SymbolSize, class SuperCoder>
+    const uint32_t
+    fixed_storage_block_info<Symbols, SymbolSize, SuperCoder>::
+        fixed_symbol_size;
+
+}
+
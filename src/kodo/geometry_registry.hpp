@@ -0,0 +1,237 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <tuple>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <fifi/field_types.hpp>
+
+#include "polymorphic_coder.hpp"
+
+namespace kodo
+{
+
+    /// Identifies a finite field at runtime
+    enum field_id
+    {
+        field_binary,
+        field_binary8,
+        field_binary16,
+        field_prime2325
+    };
+
+    /// Maps a finite field type to its field_id
+    template<class Field>
+    struct field_id_of;
+
+    /// @copydoc field_id_of
+    template<>
+    struct field_id_of<fifi::binary>
+    {
+        static const field_id value = field_binary;
+    };
+
+    /// @copydoc field_id_of
+    template<>
+    struct field_id_of<fifi::binary8>
+    {
+        static const field_id value = field_binary8;
+    };
+
+    /// @copydoc field_id_of
+    template<>
+    struct field_id_of<fifi::binary16>
+    {
+        static const field_id value = field_binary16;
+    };
+
+    /// @copydoc field_id_of
+    template<>
+    struct field_id_of<fifi::prime2325>
+    {
+        static const field_id value = field_prime2325;
+    };
+
+    /// @brief Builds coders for a geometry requested at runtime.
+    ///
+    /// Stacks specialized for a fixed number of symbols and symbol size,
+    /// e.g. the fixed_full_rlnc_encoder, are registered for their
+    /// geometry. A generic stack may be registered per field and is used
+    /// for every geometry without a specialized stack.
+    ///
+    /// Example:
+    ///
+    /// @code
+    /// kodo::geometry_registry<kodo::encoder_interface> registry;
+    ///
+    /// kodo::add_fixed<kodo::polymorphic_encoder<
+    ///     kodo::fixed_full_rlnc_encoder<fifi::binary8, 32, 1400> > >(
+    ///         registry);
+    ///
+    /// kodo::add_generic<kodo::polymorphic_encoder<
+    ///     kodo::full_rlnc_encoder<fifi::binary8> > >(
+    ///         registry, 256, 8192);
+    ///
+    /// auto encoder = registry.build(kodo::field_binary8, 32, 1400);
+    /// @endcode
+    ///
+    /// The builders use the factories of the stacks, which are not
+    /// thread safe. Each thread should therefore use its own registry.
+    template<class Interface>
+    class geometry_registry
+    {
+    public:
+
+        /// Pointer to the coders built
+        typedef boost::shared_ptr<Interface> pointer;
+
+        /// Builds a coder for the given number of symbols and symbol size
+        typedef std::function<pointer (uint32_t, uint32_t)> builder;
+
+    public:
+
+        /// Registers a stack specialized for a geometry
+        /// @param field The field of the stack
+        /// @param symbols The number of symbols of the geometry
+        /// @param symbol_size The symbol size of the geometry
+        /// @param the_builder Builds coders using the stack
+        void add_fixed(field_id field, uint32_t symbols,
+                       uint32_t symbol_size, const builder &the_builder)
+        {
+            assert(the_builder);
+            m_fixed[key_type(field, symbols, symbol_size)] = the_builder;
+        }
+
+        /// Registers the stack used for geometries without a specialized
+        /// stack
+        /// @param field The field of the stack
+        /// @param the_builder Builds coders using the stack
+        void add_generic(field_id field, const builder &the_builder)
+        {
+            assert(the_builder);
+            m_generic[field] = the_builder;
+        }
+
+        /// @param field The field
+        /// @param symbols The number of symbols
+        /// @param symbol_size The symbol size in bytes
+        /// @return True if a specialized stack is registered for the
+        ///         geometry
+        bool is_fixed(field_id field, uint32_t symbols,
+                      uint32_t symbol_size) const
+        {
+            return m_fixed.count(key_type(field, symbols, symbol_size)) > 0;
+        }
+
+        /// Builds a coder using the specialized stack of the geometry if
+        /// one is registered and otherwise the generic stack of the field
+        /// @param field The field
+        /// @param symbols The number of symbols
+        /// @param symbol_size The symbol size in bytes
+        /// @return The coder or an empty pointer if no stack was
+        ///         registered for the request or the stack does not
+        ///         support the geometry
+        pointer build(field_id field, uint32_t symbols,
+                      uint32_t symbol_size) const
+        {
+            auto fixed = m_fixed.find(key_type(field, symbols, symbol_size));
+
+            if(fixed != m_fixed.end())
+                return fixed->second(symbols, symbol_size);
+
+            auto generic = m_generic.find(field);
+
+            if(generic != m_generic.end())
+                return generic->second(symbols, symbol_size);
+
+            return pointer();
+        }
+
+    private:
+
+        /// The field, symbols and symbol size of a geometry
+        typedef std::tuple<field_id, uint32_t, uint32_t> key_type;
+
+        /// The specialized stacks
+        std::map<key_type, builder> m_fixed;
+
+        /// The generic stacks
+        std::map<field_id, builder> m_generic;
+    };
+
+    /// Registers a stack with a fixed geometry. The coders are built
+    /// using a factory shared by all coders of the geometry.
+    /// @param registry The registry
+    template<class Polymorphic>
+    inline void add_fixed(
+        geometry_registry<typename Polymorphic::interface_type> &registry)
+    {
+        typedef typename Polymorphic::coder_type coder_type;
+        typedef typename Polymorphic::factory factory;
+        typedef typename coder_type::field_type field_type;
+
+        uint32_t symbols = coder_type::fixed_symbols;
+        uint32_t symbol_size = coder_type::fixed_symbol_size;
+
+        auto the_factory = boost::make_shared<factory>(symbols, symbol_size);
+
+        registry.add_fixed(field_id_of<field_type>::value, symbols,
+            symbol_size, [the_factory](uint32_t, uint32_t)
+            {
+                return boost::make_shared<Polymorphic>(the_factory);
+            });
+    }
+
+    /// Registers a generic stack. The coders are built using a factory
+    /// shared by all geometries of the field. Geometries larger than
+    /// the maximums of the factory are not supported and build an
+    /// empty pointer.
+    /// @param registry The registry
+    /// @param max_symbols The maximum number of symbols supported
+    /// @param max_symbol_size The maximum symbol size supported
+    template<class Polymorphic>
+    inline void add_generic(
+        geometry_registry<typename Polymorphic::interface_type> &registry,
+        uint32_t max_symbols, uint32_t max_symbol_size)
+    {
+        typedef typename Polymorphic::coder_type coder_type;
+        typedef typename Polymorphic::factory factory;
+        typedef typename coder_type::field_type field_type;
+
+        auto the_factory =
+            boost::make_shared<factory>(max_symbols, max_symbol_size);
+
+        typedef typename geometry_registry<
+            typename Polymorphic::interface_type>::pointer pointer;
+
+        registry.add_generic(field_id_of<field_type>::value,
+            [the_factory](uint32_t symbols, uint32_t symbol_size)
+                -> pointer
+            {
+                // The geometry is requested at runtime so a geometry
+                // larger than the factory supports is not an error
+                if(symbols > the_factory->max_symbols())
+                    return pointer();
+
+                if(symbol_size > the_factory->max_symbol_size())
+                    return pointer();
+
+                the_factory->set_symbols(symbols);
+                the_factory->set_symbol_size(symbol_size);
+
+                return boost::make_shared<Polymorphic>(the_factory);
+            });
+    }
+
+}
+
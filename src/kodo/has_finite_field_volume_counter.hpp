@@ -0,0 +1,38 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include "finite_field_volume_counter.hpp"
+
+namespace kodo
+{
+
+    /// Type trait helper allows compile time detection of whether an
+    /// encoder / decoder contains the finite_field_volume_counter layer
+    ///
+    /// Example:
+    ///
+    /// typedef kodo::full_rlnc_decoder<fifi::binary8> decoder_t;
+    ///
+    /// if(kodo::has_finite_field_volume_counter<decoder_t>::value)
+    /// {
+    ///     // Do something here
+    /// }
+    ///
+    template<class T>
+    struct has_finite_field_volume_counter
+    {
+        template<class U>
+        static uint8_t test(const kodo::finite_field_volume_counter<U> *);
+
+        static uint32_t test(...);
+
+        static const bool value = sizeof(test(static_cast<T*>(0))) == 1;
+    };
+
+}
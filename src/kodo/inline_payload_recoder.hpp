@@ -0,0 +1,277 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <sak/convert_endian.hpp>
+#include <sak/storage.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include "coder_arena.hpp"
+#include "systematic_base_coder.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup payload_codec_layers
+    /// @brief Implements the recode function directly in the decoder
+    ///        stack.
+    ///
+    /// Produces the same recoded symbols as the payload_recoder with the
+    /// recoding_stack, i.e. a non-systematic header with the recoded
+    /// coding coefficients followed by a random combination of the
+    /// symbols held by the decoder. However the decoder storage and
+    /// finite field math are accessed directly instead of through a
+    /// proxy_layer, and no separate recoding stack and factory are
+    /// needed. The only memory used is a buffer for the recoded coding
+    /// coefficients and the list of symbols combined.
+    template<class SuperCoder>
+    class inline_payload_recoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The flag type of the codec header
+        typedef systematic_base_coder::flag_type flag_type;
+
+        /// The random generator used
+        typedef boost::random::mt19937 generator_type;
+
+        /// @copydoc layer::seed_type
+        typedef generator_type::result_type seed_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                return SuperCoder::factory::arena_size() +
+                    coder_arena::aligned_size(
+                        SuperCoder::factory::max_coefficients_size());
+            }
+
+        };
+
+    public:
+
+        /// Constructor
+        inline_payload_recoder()
+            : m_value_distribution(field_type::min_value,
+                                   field_type::max_value),
+              m_recode_id(0),
+              m_random_bits(0),
+              m_random_bits_left(0)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            // Reserved aligned in the arena since the coefficients may
+            // be multibyte data types
+            m_recode_id = SuperCoder::arena_allocate(
+                the_factory.max_coefficients_size());
+
+            m_indices.resize(the_factory.max_symbols());
+            m_values.resize(the_factory.max_symbols());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                m_indices.capacity() * sizeof(uint32_t) +
+                m_values.capacity() * sizeof(value_type);
+        }
+
+        /// @copydoc layer::recode(uint8_t*)
+        void recode(uint8_t *payload)
+        {
+            assert(payload != 0);
+            recode(payload, payload + SuperCoder::symbol_size());
+        }
+
+        /// Recodes a symbol into separate symbol data and header buffers
+        /// @param symbol_data The buffer for the symbol data, must be
+        ///        symbol_size() bytes
+        /// @param symbol_header The buffer for the symbol header, must
+        ///        be at least header_size() bytes
+        /// @return The number of bytes used in the symbol header buffer
+        uint32_t recode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            uint32_t id_size = SuperCoder::coefficients_size();
+
+            assert(sizeof(flag_type) + id_size <= SuperCoder::header_size());
+
+            sak::big_endian::put<flag_type>(
+                systematic_base_coder::non_systematic_flag, symbol_header);
+
+            value_type *symbol = reinterpret_cast<value_type*>(symbol_data);
+            value_type *recode_id =
+                reinterpret_cast<value_type*>(m_recode_id);
+
+            std::fill_n(symbol_data, SuperCoder::symbol_size(), 0);
+            std::fill_n(m_recode_id, id_size, 0);
+
+            uint32_t symbols = SuperCoder::symbols();
+            bool complete = SuperCoder::is_complete();
+
+            // Draw the coefficients first, combining the coefficients
+            // and the symbol data in separate passes keeps the finite
+            // field kernels working on buffers of the same size
+            uint32_t count = 0;
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                if(!complete && !SuperCoder::symbol_pivot(i))
+                {
+                    continue;
+                }
+
+                value_type c = coefficient();
+
+                if(!c)
+                {
+                    continue;
+                }
+
+                m_indices[count] = i;
+                m_values[count] = c;
+                ++count;
+            }
+
+            for(uint32_t j = 0; j < count; ++j)
+            {
+                mix(recode_id, SuperCoder::coefficients_value(m_indices[j]),
+                    m_values[j], SuperCoder::coefficients_length());
+            }
+
+            for(uint32_t j = 0; j < count; ++j)
+            {
+                mix(symbol, SuperCoder::symbol_value(m_indices[j]),
+                    m_values[j], SuperCoder::symbol_length());
+            }
+
+            sak::copy_storage(
+                sak::storage(symbol_header + sizeof(flag_type), id_size),
+                sak::storage(m_recode_id, id_size));
+
+            return sizeof(flag_type) + id_size;
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            m_random_generator.seed(seed_value);
+            m_random_bits_left = 0;
+        }
+
+    protected:
+
+        /// Adds the source multiplied by the coefficient to the
+        /// destination
+        /// @param dest The destination buffer
+        /// @param src The source buffer
+        /// @param c The coefficient
+        /// @param length The length of the buffers in value_type elements
+        void mix(value_type *dest, const value_type *src, value_type c,
+                 uint32_t length)
+        {
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::add(dest, src, length);
+            }
+            else
+            {
+                SuperCoder::multiply_add(dest, src, c, length);
+            }
+        }
+
+        /// @return A uniform random coefficient for a symbol held by the
+        ///         decoder
+        value_type coefficient()
+        {
+            if(fifi::is_binary<field_type>::value)
+            {
+                // Draw the binary coefficients from the bits of one
+                // random number at a time
+                if(m_random_bits_left == 0)
+                {
+                    m_random_bits = m_random_generator();
+                    m_random_bits_left = 32;
+                }
+
+                value_type c = m_random_bits & 1U;
+
+                m_random_bits >>= 1;
+                --m_random_bits_left;
+
+                return c;
+            }
+
+            return m_value_distribution(m_random_generator);
+        }
+
+    protected:
+
+        /// The type of the value_type distribution
+        typedef boost::random::uniform_int_distribution<value_type>
+            value_type_distribution;
+
+        /// Distribution that generates random values from a finite field
+        value_type_distribution m_value_distribution;
+
+        /// The random generator
+        generator_type m_random_generator;
+
+        /// Buffer for the recoded coding coefficients
+        uint8_t *m_recode_id;
+
+        /// The symbols combined by a recoded symbol
+        std::vector<uint32_t> m_indices;
+
+        /// The coefficients of the symbols combined
+        std::vector<value_type> m_values;
+
+        /// Random bits used for the binary coefficients
+        uint32_t m_random_bits;
+
+        /// The number of unused random bits
+        uint32_t m_random_bits_left;
+    };
+
+}
+
@@ -0,0 +1,80 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace kodo
+{
+
+    /// @ingroup payload_codec_layers
+    /// @brief Decodes payloads from buffers lent by the application.
+    ///
+    /// Used together with the lending_symbol_storage. Instead of copying
+    /// an innovative symbol into the symbol storage the decoder keeps the
+    /// lent buffer as the row of the symbol, saving a symbol sized copy
+    /// per innovative payload. The buffer must not be touched by the
+    /// application until it is handed back through the release callback
+    /// of the storage. Layers copying the payload, such as the
+    /// copy_payload_decoder, should not be used in the same stack since
+    /// a copied payload cannot be adopted.
+    ///
+    /// Example using a pool of receive buffers:
+    ///
+    /// @code
+    /// decoder->set_release_callback(
+    ///     [&pool](uint8_t *buffer) { pool.push_back(buffer); });
+    ///
+    /// uint8_t *buffer = pool.back();
+    /// pool.pop_back();
+    ///
+    /// receive(buffer);
+    /// decoder->decode_lent(buffer);
+    /// @endcode
+    template<class SuperCoder>
+    class lending_payload_decoder : public SuperCoder
+    {
+    public:
+
+        /// Decodes a payload from a lent buffer. The buffer is either
+        /// adopted by the decoder or handed back before returning.
+        /// @param payload The buffer holding the payload, at least
+        ///        payload_size() bytes
+        /// @return True if the decoder adopted the buffer
+        bool decode_lent(uint8_t *payload)
+        {
+            assert(payload != 0);
+
+            // The symbol data is the first part of the payload
+            SuperCoder::lend_symbol(payload);
+            SuperCoder::decode(payload);
+
+            return SuperCoder::reclaim_symbol();
+        }
+
+        /// Decodes a symbol received in separate symbol data and header
+        /// buffers, where the symbol data buffer is lent. The header
+        /// buffer is not kept by the decoder.
+        /// @param symbol_data The buffer holding the symbol data, at
+        ///        least symbol_size() bytes
+        /// @param symbol_header The symbol header, must be header_size()
+        ///        bytes
+        /// @return True if the decoder adopted the symbol data buffer
+        bool decode_lent(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            SuperCoder::lend_symbol(symbol_data);
+            SuperCoder::decode(symbol_data, symbol_header);
+
+            return SuperCoder::reclaim_symbol();
+        }
+    };
+
+}
+
@@ -0,0 +1,233 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+
+#include <sak/storage.hpp>
+
+#include "coder_arena.hpp"
+#include "shallow_symbol_storage.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup symbol_storage_layers
+    /// @brief Symbol storage where the application may lend its receive
+    ///        buffers to the decoder.
+    ///
+    /// The symbols are kept in a table of row pointers. Initially every
+    /// row points into a buffer reserved in the coder arena, like the
+    /// deep storage. When a symbol is decoded from a lent buffer the
+    /// decoder adopts the buffer as the row of its pivot instead of
+    /// copying the symbol data, see layer::adopt_symbol(uint32_t,
+    /// const uint8_t*). A lent buffer is handed back through the release
+    /// callback when it is superseded, when the coder is initialized for
+    /// a new block or when release_symbols() is called. Buffers which
+    /// were not adopted, e.g. because the symbol was not innovative, are
+    /// handed back by reclaim_symbol().
+    ///
+    /// Lent buffers must be at least symbol_size() bytes and aligned as
+    /// required by the finite field implementation. Since the decoder
+    /// does not know when the application releases its pool, buffers
+    /// still held must be released explicitly before the pool goes away.
+    template<class SuperCoder>
+    class lending_symbol_storage :
+        public mutable_shallow_symbol_storage<SuperCoder>
+    {
+    public:
+
+        /// The actual SuperCoder type
+        typedef mutable_shallow_symbol_storage<SuperCoder> Super;
+
+        /// The release callback, invoked with a lent buffer when the
+        /// decoder no longer uses it
+        typedef std::function<void (uint8_t*)> release_callback;
+
+    protected:
+
+        /// Access to the symbol pointers
+        using Super::m_data;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public Super::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : Super::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                return Super::factory::arena_size() +
+                    coder_arena::aligned_size(
+                        Super::factory::max_symbols() *
+                        Super::factory::max_symbol_size());
+            }
+        };
+
+    public:
+
+        /// Constructor
+        lending_symbol_storage()
+            : m_backing(0),
+              m_dirty_size(0),
+              m_lent(0)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            Super::construct(the_factory);
+
+            assert(m_backing == 0);
+            m_backing = Super::arena_allocate(
+                the_factory.max_symbols() * the_factory.max_symbol_size());
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            // Hand back the buffers of the previous block while its
+            // geometry is still known
+            for(uint32_t i = 0; i < Super::symbols(); ++i)
+            {
+                if(is_lent(i))
+                    m_release(m_data[i]);
+            }
+
+            assert(m_lent == 0);
+
+            Super::initialize(the_factory);
+
+            std::fill_n(m_backing, m_dirty_size, 0);
+            m_dirty_size = Super::block_size();
+
+            Super::set_symbols(
+                sak::storage(m_backing, Super::block_size()));
+        }
+
+        /// Sets the callback handing lent buffers back to the
+        /// application
+        /// @param callback The release callback
+        void set_release_callback(const release_callback &callback)
+        {
+            assert(callback);
+            m_release = callback;
+        }
+
+        /// Lends the buffer of the next symbol to the decoder. Must be
+        /// followed by decoding the symbol from this buffer and a call
+        /// to reclaim_symbol().
+        /// @param symbol_data The buffer holding the symbol data
+        void lend_symbol(uint8_t *symbol_data)
+        {
+            assert(symbol_data != 0);
+            assert(m_lent == 0);
+            assert(m_release);
+
+            m_lent = symbol_data;
+        }
+
+        /// Hands the lent buffer back to the application if the decoder
+        /// did not adopt it
+        /// @return True if the decoder adopted the buffer
+        bool reclaim_symbol()
+        {
+            if(m_lent == 0)
+                return true;
+
+            m_release(m_lent);
+            m_lent = 0;
+
+            return false;
+        }
+
+        /// @copydoc layer::adopt_symbol(uint32_t, const uint8_t*)
+        bool adopt_symbol(uint32_t index, const uint8_t *symbol_data)
+        {
+            assert(index < Super::symbols());
+            assert(symbol_data != 0);
+
+            if(m_lent == 0 || symbol_data != m_lent)
+                return false;
+
+            // The row held a symbol which has now been superseded
+            if(is_lent(index))
+                m_release(m_data[index]);
+
+            m_data[index] = m_lent;
+            m_lent = 0;
+
+            return true;
+        }
+
+        /// Copies the symbols held in lent buffers into the internal
+        /// storage and hands the buffers back to the application. The
+        /// decoder may be used as before afterwards.
+        void release_symbols()
+        {
+            for(uint32_t i = 0; i < Super::symbols(); ++i)
+            {
+                if(!is_lent(i))
+                    continue;
+
+                uint8_t *lent = m_data[i];
+
+                std::copy(lent, lent + Super::symbol_size(),
+                          backing_symbol(i));
+
+                m_data[i] = backing_symbol(i);
+                m_release(lent);
+            }
+        }
+
+        /// @param index The index of a symbol
+        /// @return True if the symbol is held in a lent buffer
+        bool is_lent(uint32_t index) const
+        {
+            assert(index < Super::symbols());
+            return m_data[index] != backing_symbol(index);
+        }
+
+    private:
+
+        /// @param index The index of a symbol
+        /// @return The internal storage of the symbol
+        uint8_t* backing_symbol(uint32_t index) const
+        {
+            return m_backing + index * Super::symbol_size();
+        }
+
+    private:
+
+        /// The internal storage used for rows not held in lent buffers
+        uint8_t *m_backing;
+
+        /// The number of bytes of the internal storage which may have
+        /// been written since it was last cleared
+        uint32_t m_dirty_size;
+
+        /// The buffer lent for the symbol currently being decoded
+        uint8_t *m_lent;
+
+        /// Hands lent buffers back to the application
+        release_callback m_release;
+
+    };
+
+}
+
@@ -17,6 +17,10 @@
 #include <fifi/is_binary.hpp>
 #include <fifi/fifi_utils.hpp>
 
+#include "decoder_phase_scope.hpp"
+#include "operations_buffer_scope.hpp"
+#include "decoder_trace_event.hpp"
+
 namespace kodo
 {
 
@@ -46,7 +50,8 @@ namespace kodo
         /// Constructor
         linear_block_decoder()
             : m_rank(0),
-              m_maximum_pivot(0)
+              m_maximum_pivot(0),
+              m_dirty_symbols(0)
         { }
 
         /// @copydoc layer::construct(Factory&)
@@ -59,14 +64,25 @@ namespace kodo
             m_coded.resize(the_factory.max_symbols(), false);
         }
 
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                (m_uncoded.capacity() + 7) / 8 +
+                (m_coded.capacity() + 7) / 8;
+        }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
         {
             SuperCoder::initialize(the_factory);
 
-            std::fill_n(m_uncoded.begin(), the_factory.symbols(), false);
-            std::fill_n(m_coded.begin(), the_factory.symbols(), false);
+            // Only the flags used by the previous block may be set
+            std::fill_n(m_uncoded.begin(), m_dirty_symbols, false);
+            std::fill_n(m_coded.begin(), m_dirty_symbols, false);
+
+            m_dirty_symbols = the_factory.symbols();
 
             m_rank = 0;
             m_maximum_pivot = 0;
@@ -85,7 +101,13 @@ namespace kodo
             value_type *coefficients
                 = reinterpret_cast<value_type*>(symbol_coefficients);
 
+            trace(trace_event::packet_received, trace_event::coded_symbol);
+
+            uint32_t rank = m_rank;
+
             decode_coefficients(symbol, coefficients);
+
+            trace_complete(rank);
         }
 
         /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
@@ -95,20 +117,27 @@ namespace kodo
             assert(symbol_index < SuperCoder::symbols());
             assert(symbol_data != 0);
 
+            trace(trace_event::packet_received, symbol_index);
+
             if(m_uncoded[symbol_index])
             {
+                trace(trace_event::non_innovative, symbol_index);
                 return;
             }
 
             const value_type *symbol
                 = reinterpret_cast<value_type*>( symbol_data );
 
+            uint32_t rank = m_rank;
+
             if(m_coded[symbol_index])
             {
                 swap_decode(symbol, symbol_index);
             }
             else
             {
+                trace(trace_event::pivot_found, symbol_index);
+
                 // Stores the symbol and updates the corresponding
                 // encoding vector
                 store_uncoded_symbol(symbol, symbol_index);
@@ -123,6 +152,8 @@ namespace kodo
                 // backwards substitution
                 ++m_rank;
 
+                trace_rank_changed();
+
                 m_uncoded[ symbol_index ] = true;
 
                 if(symbol_index > m_maximum_pivot)
@@ -131,6 +162,8 @@ namespace kodo
                 }
 
             }
+
+            trace_complete(rank);
         }
 
         /// @copydoc layer::is_complete() const
@@ -177,7 +210,13 @@ namespace kodo
                     symbol_data, symbol_coefficients);
 
             if(!pivot_index)
+            {
+                trace(trace_event::non_innovative,
+                      trace_event::coded_symbol);
                 return;
+            }
+
+            trace(trace_event::pivot_found, *pivot_index);
 
             if(!fifi::is_binary<field_type>::value)
             {
@@ -201,6 +240,8 @@ namespace kodo
             // We have increased the rank
             ++m_rank;
 
+            trace_rank_changed();
+
             m_coded[ *pivot_index ] = true;
 
             if(*pivot_index > m_maximum_pivot)
@@ -221,6 +262,11 @@ namespace kodo
             assert(m_coded[pivot_index] == true);
             assert(m_uncoded[pivot_index] == false);
 
+            trace(trace_event::swap_decode, pivot_index);
+
+            decoder_phase_scope<SuperCoder> phase(
+                *this, decoder_phase::swap_decoding);
+
             m_coded[pivot_index] = false;
 
             value_type *symbol_i =
@@ -280,12 +326,14 @@ namespace kodo
 
             assert(coefficient > 0);
 
+            decoder_phase_scope<SuperCoder> phase(
+                *this, decoder_phase::normalization);
+
             value_type inverted_coefficient =
                 SuperCoder::invert(coefficient);
 
             // Update symbol and corresponding vector
-            SuperCoder::multiply(symbol_id, inverted_coefficient,
-                                 SuperCoder::coefficients_length());
+            multiply_coefficients(symbol_id, inverted_coefficient);
 
             SuperCoder::multiply(symbol_data, inverted_coefficient,
                                  SuperCoder::symbol_length());
@@ -304,6 +352,9 @@ namespace kodo
             assert(symbol_id != 0);
             assert(symbol_data != 0);
 
+            decoder_phase_scope<SuperCoder> phase(
+                *this, decoder_phase::forward_substitution);
+
             for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
             {
 
@@ -323,9 +374,7 @@ namespace kodo
 
                         if(fifi::is_binary<field_type>::value)
                         {
-                            SuperCoder::subtract(
-                                symbol_id, vector_i,
-                                SuperCoder::coefficients_length());
+                            subtract_coefficients(symbol_id, vector_i);
 
                             SuperCoder::subtract(
                                 symbol_data, symbol_i,
@@ -333,10 +382,8 @@ namespace kodo
                         }
                         else
                         {
-                            SuperCoder::multiply_subtract(
-                                symbol_id, vector_i,
-                                current_coefficient,
-                                SuperCoder::coefficients_length());
+                            multiply_subtract_coefficients(
+                                symbol_id, vector_i, current_coefficient);
 
                             SuperCoder::multiply_subtract(
                                 symbol_data, symbol_i,
@@ -375,6 +422,9 @@ namespace kodo
             assert(m_uncoded[pivot_index] == false);
             assert(m_coded[pivot_index] == false);
 
+            decoder_phase_scope<SuperCoder> phase(
+                *this, decoder_phase::forward_substitution);
+
             // If this pivot index was smaller than the maximum pivot
             // index we have, we might also need to backward
             // substitute the higher pivot values into the new packet
@@ -401,9 +451,7 @@ namespace kodo
 
                     if(fifi::is_binary<field_type>::value)
                     {
-                        SuperCoder::subtract(
-                            symbol_id, vector_i,
-                            SuperCoder::coefficients_length());
+                        subtract_coefficients(symbol_id, vector_i);
 
                         SuperCoder::subtract(
                             symbol_data, symbol_i,
@@ -411,9 +459,8 @@ namespace kodo
                     }
                     else
                     {
-                        SuperCoder::multiply_subtract(
-                            symbol_id, vector_i, value,
-                            SuperCoder::coefficients_length());
+                        multiply_subtract_coefficients(
+                            symbol_id, vector_i, value);
 
                         SuperCoder::multiply_subtract(
                             symbol_data, symbol_i, value,
@@ -438,6 +485,9 @@ namespace kodo
 
             assert(pivot_index < SuperCoder::symbols());
 
+            decoder_phase_scope<SuperCoder> phase(
+                *this, decoder_phase::backward_substitution);
+
             // We found a "1" that nobody else had as pivot, we now
             // substract this packet from other coded packets
             // - if they have a "1" on our pivot place
@@ -473,9 +523,7 @@ namespace kodo
 
                         if(fifi::is_binary<field_type>::value)
                         {
-                            SuperCoder::subtract(
-                                vector_i, symbol_id,
-                                SuperCoder::coefficients_length());
+                            subtract_coefficients(vector_i, symbol_id);
 
                             SuperCoder::subtract(
                                 symbol_i, symbol_data,
@@ -485,9 +533,8 @@ namespace kodo
                         {
 
                             // Update symbol and corresponding vector
-                            SuperCoder::multiply_subtract(
-                                vector_i, symbol_id, value,
-                                SuperCoder::coefficients_length());
+                            multiply_subtract_coefficients(
+                                vector_i, symbol_id, value);
 
                             SuperCoder::multiply_subtract(
                                 symbol_i, symbol_data, value,
@@ -521,15 +568,7 @@ namespace kodo
             SuperCoder::set_coefficients(
                 pivot_index, coefficient_storage);
 
-            // Copy it into the symbol storage
-            sak::mutable_storage dest =
-                sak::storage(SuperCoder::symbol(pivot_index),
-                             SuperCoder::symbol_size());
-
-            sak::const_storage src =
-                sak::storage(symbol_data, SuperCoder::symbol_size());
-
-            sak::copy_storage(dest, src);
+            store_symbol_data(symbol_data, pivot_index);
         }
 
         /// Stores an uncoded or fully decoded symbol
@@ -552,16 +591,108 @@ namespace kodo
 
             fifi::set_value<field_type>(vector_dest, pivot_index, 1U);
 
+            store_symbol_data(symbol_data, pivot_index);
+        }
+
+        /// Places the symbol data in the symbol storage. If the storage
+        /// adopts the buffer holding the data, e.g. when the buffer was
+        /// lent by the application, the copy is avoided.
+        /// @param symbol_data the data for the symbol
+        /// @param pivot_index the pivot index of the symbol
+        void store_symbol_data(const value_type *symbol_data,
+                               uint32_t pivot_index)
+        {
+            const uint8_t *data =
+                reinterpret_cast<const uint8_t*>(symbol_data);
+
+            if(SuperCoder::adopt_symbol(pivot_index, data))
+                return;
+
             // Copy it into the symbol storage
             sak::mutable_storage dest =
                 sak::storage(SuperCoder::symbol(pivot_index),
                              SuperCoder::symbol_size());
 
             sak::const_storage src =
-                sak::storage(symbol_data, SuperCoder::symbol_size());
+                sak::storage(data, SuperCoder::symbol_size());
 
             sak::copy_storage(dest, src);
+        }
+
+        /// Multiplies a coefficient vector, the operation is counted on
+        /// the coefficients if the stack contains the
+        /// finite_field_volume_counter
+        /// @param vector_dest The coefficient vector
+        /// @param coefficient The value multiplied
+        void multiply_coefficients(value_type *vector_dest,
+                                   value_type coefficient)
+        {
+            operations_buffer_scope<SuperCoder> buffer(
+                *this, operations_volume::coefficients);
+
+            SuperCoder::multiply(vector_dest, coefficient,
+                                 SuperCoder::coefficients_length());
+        }
+
+        /// Subtracts a coefficient vector from another, the operation is
+        /// counted on the coefficients if the stack contains the
+        /// finite_field_volume_counter
+        /// @param vector_dest The coefficient vector subtracted from
+        /// @param vector_src The coefficient vector subtracted
+        void subtract_coefficients(value_type *vector_dest,
+                                   const value_type *vector_src)
+        {
+            operations_buffer_scope<SuperCoder> buffer(
+                *this, operations_volume::coefficients);
+
+            SuperCoder::subtract(vector_dest, vector_src,
+                                 SuperCoder::coefficients_length());
+        }
+
+        /// Subtracts a multiple of a coefficient vector from another,
+        /// the operation is counted on the coefficients if the stack
+        /// contains the finite_field_volume_counter
+        /// @param vector_dest The coefficient vector subtracted from
+        /// @param vector_src The coefficient vector subtracted
+        /// @param coefficient The value vector_src is multiplied by
+        void multiply_subtract_coefficients(value_type *vector_dest,
+                                            const value_type *vector_src,
+                                            value_type coefficient)
+        {
+            operations_buffer_scope<SuperCoder> buffer(
+                *this, operations_volume::coefficients);
+
+            SuperCoder::multiply_subtract(vector_dest, vector_src,
+                                          coefficient,
+                                          SuperCoder::coefficients_length());
+        }
+
+        /// Writes an event to the trace if the stack contains the
+        /// decoder_trace layer
+        /// @param event The event
+        /// @param value The value of the event
+        void trace(trace_event::type event, uint32_t value)
+        {
+            decoder_trace_event<SuperCoder>::write(*this, event, value);
+        }
 
+        /// Writes the rank_changed event to the trace
+        void trace_rank_changed()
+        {
+            trace(trace_event::rank_changed, m_rank);
+        }
+
+        /// Writes the complete event to the trace if the symbol just
+        /// decoded brought the decoder to full rank. Called once the
+        /// symbol is fully processed, since a swap decodes the coded
+        /// symbol it replaces before storing the uncoded symbol.
+        /// @param old_rank The rank before the symbol was decoded
+        void trace_complete(uint32_t old_rank)
+        {
+            if(old_rank < m_rank && m_rank == SuperCoder::symbols())
+            {
+                trace(trace_event::complete, m_rank);
+            }
         }
 
     protected:
@@ -578,6 +709,10 @@ namespace kodo
 
         /// Tracks whether a symbol is partially decoded
         std::vector<bool> m_coded;
+
+        /// The number of symbol flags which may have been set since
+        /// they were last cleared
+        uint32_t m_dirty_symbols;
     };
 
 }
@@ -12,6 +12,8 @@
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 
+#include "trace_event.hpp"
+
 namespace kodo
 {
 
@@ -47,7 +49,15 @@ namespace kodo
             value_type *c =
                 reinterpret_cast<value_type*>(coefficients);
 
+            SuperCoder::trace(trace_event::packet_received,
+                              trace_event::coded_symbol);
+
+            uint32_t rank = m_rank;
+
             decode_coefficients(s, c);
+
+            // Written after the final backward substitution
+            SuperCoder::trace_complete(rank);
         }
 
         /// @copydoc layer::decode_symbol(uint8_t*,uint32_t)
@@ -56,18 +66,27 @@ namespace kodo
             assert(symbol_index < SuperCoder::symbols());
             assert(symbol_data != 0);
 
+            SuperCoder::trace(trace_event::packet_received, symbol_index);
+
             if(m_uncoded[symbol_index])
+            {
+                SuperCoder::trace(trace_event::non_innovative, symbol_index);
                 return;
+            }
 
             const value_type *symbol
                 = reinterpret_cast<const value_type*>( symbol_data );
 
+            uint32_t rank = m_rank;
+
             if(m_coded[symbol_index])
             {
                 SuperCoder::swap_decode(symbol, symbol_index);
             }
             else
             {
+                SuperCoder::trace(trace_event::pivot_found, symbol_index);
+
                 // Stores the symbol and updates the corresponding
                 // encoding vector
                 SuperCoder::store_uncoded_symbol(symbol, symbol_index);
@@ -75,6 +94,8 @@ namespace kodo
                 // We have increased the rank
                 ++m_rank;
 
+                SuperCoder::trace_rank_changed();
+
                 m_uncoded[ symbol_index ] = true;
 
                 if(symbol_index > m_maximum_pivot)
@@ -89,6 +110,7 @@ namespace kodo
                 final_backward_substitute();
             }
 
+            SuperCoder::trace_complete(rank);
         }
 
     protected:
@@ -118,7 +140,13 @@ namespace kodo
                     symbol_data, coefficients);
 
             if(!pivot_index)
+            {
+                SuperCoder::trace(trace_event::non_innovative,
+                                  trace_event::coded_symbol);
                 return;
+            }
+
+            SuperCoder::trace(trace_event::pivot_found, *pivot_index);
 
             if(!fifi::is_binary<field_type>::value)
             {
@@ -134,6 +162,8 @@ namespace kodo
             // We have increased the rank
             ++m_rank;
 
+            SuperCoder::trace_rank_changed();
+
             m_coded[ *pivot_index ] = true;
 
             if(*pivot_index > m_maximum_pivot)
@@ -48,6 +48,18 @@ namespace kodo
             SuperCoder::copy_symbol(symbol_index, dest);
         }
 
+        /// Returns a view of the stored symbol instead of copying it, this
+        /// allows uncoded symbols to be sent without an intermediate copy.
+        ///
+        /// @copydoc layer::encode_symbol_view(uint32_t)
+        sak::const_storage encode_symbol_view(uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+
+            return sak::storage(SuperCoder::symbol(symbol_index),
+                                SuperCoder::symbol_size());
+        }
+
         /// @copydoc layer::encode_symbol(uint8_t*, uint8_t*)
         void encode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
         {
@@ -113,6 +113,13 @@ namespace kodo
             return reinterpret_cast<const value_type*>(row(index));
         }
 
+        /// @return The number of bytes used by the matrix including the
+        ///         matrix object itself
+        uint64_t memory_usage() const
+        {
+            return sizeof(matrix) + m_data.capacity();
+        }
+
         /// @return The number of rows
         uint32_t rows() const
         {
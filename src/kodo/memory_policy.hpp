@@ -0,0 +1,53 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+namespace kodo
+{
+
+    /// @brief Describes how the memory of the coder arena and the object
+    ///        storage should be allocated.
+    ///
+    /// The default policy allocates the memory from the heap. For large
+    /// blocks the memory may instead be backed by 2 MB huge pages, which
+    /// reduces the number of TLB misses when the decoder walks the
+    /// symbols, and placed on the NUMA node of the thread allocating it.
+    /// If a policy cannot be satisfied by the system the allocation falls
+    /// back to the nearest weaker policy, see page_memory.
+    struct memory_policy
+    {
+        /// The kind of pages backing the memory
+        enum huge_pages_type
+        {
+            /// Regular pages
+            huge_pages_none,
+
+            /// Transparent huge pages i.e. the memory is aligned to the
+            /// huge page size and the kernel is advised to back it with
+            /// huge pages
+            huge_pages_transparent,
+
+            /// Explicit huge pages from the pool reserved by the system
+            /// administrator e.g. via /proc/sys/vm/nr_hugepages
+            huge_pages_explicit
+        };
+
+        /// Constructor, creates the default heap policy
+        memory_policy()
+            : m_huge_pages(huge_pages_none),
+              m_numa_local(false)
+        { }
+
+        /// The kind of pages requested
+        huge_pages_type m_huge_pages;
+
+        /// If true the memory is bound to the NUMA node of the thread
+        /// allocating it
+        bool m_numa_local;
+    };
+
+}
+
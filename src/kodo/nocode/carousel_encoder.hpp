@@ -6,6 +6,7 @@
 #pragma once
 
 #include <sak/convert_endian.hpp>
+#include <sak/storage.hpp>
 
 #include "carousel_common.hpp"
 
@@ -80,6 +81,32 @@ namespace kodo
             return sizeof(id_type);
         }
 
+        /// Works like encode(uint8_t*, uint8_t*) but does not copy the
+        /// symbol data. Instead the returned view refers to the symbol
+        /// in the encoder storage.
+        ///
+        /// @copydoc layer::encode_view(uint8_t*, uint8_t*,
+        ///                             sak::const_storage&)
+        uint32_t encode_view(uint8_t *symbol_data, uint8_t *symbol_header,
+                             sak::const_storage &symbol)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            // Write the symbol id in the header
+            sak::big_endian::put<id_type>(
+                m_current_symbol, symbol_header);
+
+            assert(m_current_symbol < SuperCoder::symbols());
+
+            symbol = SuperCoder::encode_symbol_view(m_current_symbol);
+
+            m_current_symbol =
+                (m_current_symbol + 1) % SuperCoder::symbols();
+
+            return sizeof(id_type);
+        }
+
         /// @copydoc layer::header_size() const
         uint32_t header_size() const
         {
@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include <sak/storage.hpp>
@@ -25,6 +26,12 @@ namespace kodo
     {
     public:
 
+        /// Constructor
+        nocode_decoder()
+            : m_rank(0),
+              m_dirty_symbols(0)
+        { }
+
         /// @copydoc layer::construct(Factory&)
         template<class Factory>
         void construct(Factory &the_factory)
@@ -33,13 +40,22 @@ namespace kodo
             m_uncoded.resize(the_factory.max_symbols(), false);
         }
 
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + (m_uncoded.capacity() + 7) / 8;
+        }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory &the_factory)
         {
             SuperCoder::initialize(the_factory);
 
-            std::fill_n(m_uncoded.begin(), the_factory.symbols(), false);
+            // Only the flags used by the previous block may be set
+            std::fill_n(m_uncoded.begin(), m_dirty_symbols, false);
+            m_dirty_symbols = the_factory.symbols();
+
             m_rank = 0;
         }
 
@@ -86,6 +102,10 @@ namespace kodo
         /// is fully decoded
         std::vector<bool> m_uncoded;
 
+        /// The number of symbol flags which may have been set since
+        /// they were last cleared
+        uint32_t m_dirty_symbols;
+
     };
 
 }
@@ -32,6 +32,15 @@ namespace kodo
             SuperCoder::copy_symbol(symbol_index, dest);
         }
 
+        /// @copydoc layer::encode_symbol_view(uint32_t)
+        sak::const_storage encode_symbol_view(uint32_t symbol_index)
+        {
+            assert(symbol_index < SuperCoder::symbols());
+
+            return sak::storage(SuperCoder::symbol(symbol_index),
+                                SuperCoder::symbol_size());
+        }
+
     };
 
 }
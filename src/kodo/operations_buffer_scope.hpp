@@ -0,0 +1,80 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include "operations_volume.hpp"
+#include "has_finite_field_volume_counter.hpp"
+
+namespace kodo
+{
+
+    /// Attributes the finite field operations performed during its
+    /// lifetime to a buffer, e.g. the coding coefficients, and restores
+    /// the previous buffer when it goes out of scope. If the stack does
+    /// not contain the finite_field_volume_counter the scope does
+    /// nothing, so the decoders may use it without a cost.
+    ///
+    /// Example:
+    ///
+    /// operations_buffer_scope<SuperCoder> buffer(
+    ///     *this, operations_volume::coefficients);
+    ///
+    template
+    <
+        class Coder,
+        bool Counted = has_finite_field_volume_counter<Coder>::value
+    >
+    class operations_buffer_scope : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param coder The stack performing the operations
+        /// @param buffer The buffer the operations are performed on
+        operations_buffer_scope(Coder &coder,
+                                operations_volume::buffer buffer)
+            : m_coder(coder),
+              m_previous(coder.current_operations_buffer())
+        {
+            m_coder.set_operations_buffer(buffer);
+        }
+
+        /// Destructor
+        ~operations_buffer_scope()
+        {
+            m_coder.set_operations_buffer(m_previous);
+        }
+
+    private:
+
+        /// The stack performing the operations
+        Coder &m_coder;
+
+        /// The buffer restored by the destructor
+        operations_volume::buffer m_previous;
+    };
+
+    /// Specialization for the stacks without the
+    /// finite_field_volume_counter
+    template<class Coder>
+    class operations_buffer_scope<Coder, false> : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param coder The stack performing the operations
+        /// @param buffer The buffer the operations are performed on
+        operations_buffer_scope(Coder &coder,
+                                operations_volume::buffer buffer)
+        {
+            (void) coder;
+            (void) buffer;
+        }
+    };
+
+}
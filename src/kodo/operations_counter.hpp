@@ -27,22 +27,22 @@ namespace kodo
             { }
 
         /// Counter for dest[i] = dest[i] * constant
-        uint32_t m_multiply;
+        uint64_t m_multiply;
 
         /// Counter for dest[i] = dest[i] + (constant * src[i])
-        uint32_t m_multiply_add;
+        uint64_t m_multiply_add;
 
         /// Counter for dest[i] = dest[i] + src[i]
-        uint32_t m_add;
+        uint64_t m_add;
 
         /// Counter for dest[i] = dest[i] - (constant * src[i])
-        uint32_t m_multiply_subtract;
+        uint64_t m_multiply_subtract;
 
         /// Counter for dest[i] = dest[i] - src[i]
-        uint32_t m_subtract;
+        uint64_t m_subtract;
 
         /// Counter for invert(value)
-        uint32_t m_invert;
+        uint64_t m_invert;
 
     };
 
@@ -0,0 +1,234 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include "decoder_phase.hpp"
+
+namespace kodo
+{
+
+    /// Helper class which is used by the finite_field_volume_counter
+    /// layer to count the calls and the bytes processed by the finite
+    /// field operations. The operations are counted separately for the
+    /// coding coefficients and the symbol data, and for each phase of
+    /// the decoder.
+    struct operations_volume
+    {
+
+        /// The finite field operations on buffers
+        enum operation
+        {
+            /// dest[i] = dest[i] * constant
+            multiply = 0,
+
+            /// dest[i] = dest[i] + (constant * src[i])
+            multiply_add,
+
+            /// dest[i] = dest[i] + src[i]
+            add,
+
+            /// dest[i] = dest[i] - (constant * src[i])
+            multiply_subtract,
+
+            /// dest[i] = dest[i] - src[i]
+            subtract,
+
+            /// The number of operations
+            operation_count
+        };
+
+        /// The buffers the operations are performed on
+        enum buffer
+        {
+            /// The coding coefficients
+            coefficients = 0,
+
+            /// The symbol data
+            symbol_data,
+
+            /// The number of buffers
+            buffer_count
+        };
+
+        /// Constructs a new counter and zero initializes the
+        /// counters.
+        operations_volume()
+        {
+            reset();
+        }
+
+        /// Zeros the counters
+        void reset()
+        {
+            std::memset(m_calls, 0, sizeof(m_calls));
+            std::memset(m_bytes, 0, sizeof(m_bytes));
+            std::memset(m_invert, 0, sizeof(m_invert));
+        }
+
+        /// Counts an operation
+        /// @param phase The decoder phase of the operation
+        /// @param op The operation
+        /// @param buf The buffer operated on
+        /// @param bytes The bytes of the destination buffer
+        void count(decoder_phase::type phase, operation op, buffer buf,
+                   uint64_t bytes)
+        {
+            assert(phase < decoder_phase::phase_count);
+            assert(op < operation_count);
+            assert(buf < buffer_count);
+
+            ++m_calls[phase][op][buf];
+            m_bytes[phase][op][buf] += bytes;
+        }
+
+        /// Counts an invert(value)
+        /// @param phase The decoder phase of the operation
+        void count_invert(decoder_phase::type phase)
+        {
+            assert(phase < decoder_phase::phase_count);
+            ++m_invert[phase];
+        }
+
+        /// @param op The operation
+        /// @return The calls of the operation in all phases
+        uint64_t operation_calls(operation op) const
+        {
+            uint64_t calls = 0;
+
+            for(uint32_t p = 0; p < decoder_phase::phase_count; ++p)
+            {
+                for(uint32_t b = 0; b < buffer_count; ++b)
+                {
+                    calls += m_calls[p][op][b];
+                }
+            }
+
+            return calls;
+        }
+
+        /// @param op The operation
+        /// @return The bytes processed by the operation in all phases
+        uint64_t operation_bytes(operation op) const
+        {
+            uint64_t bytes = 0;
+
+            for(uint32_t p = 0; p < decoder_phase::phase_count; ++p)
+            {
+                for(uint32_t b = 0; b < buffer_count; ++b)
+                {
+                    bytes += m_bytes[p][op][b];
+                }
+            }
+
+            return bytes;
+        }
+
+        /// @param buf The buffer
+        /// @return The calls of all operations on the buffer
+        uint64_t buffer_calls(buffer buf) const
+        {
+            uint64_t calls = 0;
+
+            for(uint32_t p = 0; p < decoder_phase::phase_count; ++p)
+            {
+                for(uint32_t o = 0; o < operation_count; ++o)
+                {
+                    calls += m_calls[p][o][buf];
+                }
+            }
+
+            return calls;
+        }
+
+        /// @param buf The buffer
+        /// @return The bytes processed by all operations on the buffer
+        uint64_t buffer_bytes(buffer buf) const
+        {
+            uint64_t bytes = 0;
+
+            for(uint32_t p = 0; p < decoder_phase::phase_count; ++p)
+            {
+                for(uint32_t o = 0; o < operation_count; ++o)
+                {
+                    bytes += m_bytes[p][o][buf];
+                }
+            }
+
+            return bytes;
+        }
+
+        /// @param phase The decoder phase
+        /// @return The calls of all operations in the phase, not
+        ///         including invert(value)
+        uint64_t phase_calls(decoder_phase::type phase) const
+        {
+            uint64_t calls = 0;
+
+            for(uint32_t o = 0; o < operation_count; ++o)
+            {
+                for(uint32_t b = 0; b < buffer_count; ++b)
+                {
+                    calls += m_calls[phase][o][b];
+                }
+            }
+
+            return calls;
+        }
+
+        /// @param phase The decoder phase
+        /// @return The bytes processed by all operations in the phase
+        uint64_t phase_bytes(decoder_phase::type phase) const
+        {
+            uint64_t bytes = 0;
+
+            for(uint32_t o = 0; o < operation_count; ++o)
+            {
+                for(uint32_t b = 0; b < buffer_count; ++b)
+                {
+                    bytes += m_bytes[phase][o][b];
+                }
+            }
+
+            return bytes;
+        }
+
+        /// @return The calls of invert(value) in all phases
+        uint64_t inverts() const
+        {
+            uint64_t calls = 0;
+
+            for(uint32_t p = 0; p < decoder_phase::phase_count; ++p)
+            {
+                calls += m_invert[p];
+            }
+
+            return calls;
+        }
+
+        /// @return The bytes processed by all operations
+        uint64_t total_bytes() const
+        {
+            return buffer_bytes(coefficients) + buffer_bytes(symbol_data);
+        }
+
+        /// The calls per phase, operation and buffer
+        uint64_t m_calls[decoder_phase::phase_count][operation_count]
+                        [buffer_count];
+
+        /// The bytes processed per phase, operation and buffer
+        uint64_t m_bytes[decoder_phase::phase_count][operation_count]
+                        [buffer_count];
+
+        /// The calls of invert(value) per phase
+        uint64_t m_invert[decoder_phase::phase_count];
+
+    };
+
+}
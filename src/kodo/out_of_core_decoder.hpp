@@ -0,0 +1,348 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <fifi/arithmetics.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "has_deep_symbol_storage.hpp"
+
+namespace kodo
+{
+
+    /// @brief Decodes blocks whose symbols are too large to be kept in
+    ///        memory.
+    ///
+    /// The received symbols are expected to be spilled to files by the
+    /// caller, only their coding coefficients are passed to the decoder.
+    /// Decoding happens in two steps:
+    ///
+    /// 1) The coefficient system is solved in memory. For this a regular
+    ///    decoder is used where the symbol data of the i'th innovative
+    ///    symbol is the i'th unit vector. When the decoder is complete
+    ///    symbol i therefore holds the coefficients which combine the
+    ///    received symbols into the i'th original symbol.
+    ///
+    /// 2) The symbol data is processed one column chunk at a time. For
+    ///    every chunk the same byte range is read from every spill file,
+    ///    the original symbols are computed from the coefficients found
+    ///    in step 1 and written to the output file.
+    ///
+    /// The peak memory use is therefore O(symbols x chunk size) instead
+    /// of O(symbols x symbol size). Non-innovative symbols are detected
+    /// in step 1, so their spill files are never read.
+    ///
+    /// As for the other decoders the symbol data must contain valid
+    /// field elements, i.e. data for the prime2325 field must be mapped
+    /// before it is encoded.
+    template<class DecoderType>
+    class out_of_core_decoder
+    {
+    public:
+
+        static_assert(has_deep_symbol_storage<DecoderType>::value,
+                      "The out of core decoder only works with decoders "
+                      "using deep storage");
+
+        /// The decoder used to solve the coefficient system
+        typedef DecoderType decoder_type;
+
+        /// The factory of the decoder
+        typedef typename decoder_type::factory factory;
+
+        /// Pointer to the decoder
+        typedef typename decoder_type::pointer pointer;
+
+        /// The finite field type
+        typedef typename decoder_type::field_type field_type;
+
+        /// The value type of the field
+        typedef typename field_type::value_type value_type;
+
+        /// The field implementation used for the symbol data
+        typedef typename decoder_type::field_impl field_impl;
+
+    public:
+
+        /// @param symbols The number of symbols in the block
+        /// @return The symbol size needed by the factory of the decoder
+        ///         solving the coefficient system
+        static uint32_t solver_symbol_size(uint32_t symbols)
+        {
+            return fifi::elements_to_size<field_type>(symbols);
+        }
+
+        /// Constructs a new out of core decoder
+        /// @param the_factory The factory used to build the decoder
+        ///        solving the coefficient system. The factory must
+        ///        support the number of symbols and a symbol size of
+        ///        solver_symbol_size(symbols)
+        /// @param symbols The number of symbols in the block
+        /// @param symbol_size The size of a symbol in bytes
+        out_of_core_decoder(factory &the_factory, uint32_t symbols,
+                            uint64_t symbol_size)
+            : m_symbol_size(symbol_size),
+              m_field(boost::make_shared<field_impl>())
+        {
+            assert(symbols > 0);
+            assert(symbol_size > 0);
+            assert((symbol_size % sizeof(value_type)) == 0);
+
+            the_factory.set_symbols(symbols);
+            the_factory.set_symbol_size(solver_symbol_size(symbols));
+
+            m_decoder = the_factory.build();
+
+            m_unit.resize(m_decoder->symbol_size());
+            m_coefficients.resize(m_decoder->coefficients_size());
+
+            m_spill_files.resize(symbols);
+        }
+
+        /// Passes an encoded symbol to the decoder
+        /// @param spill_file The file holding the symbol data
+        /// @param coefficients The coding coefficients of the symbol
+        /// @return True if the symbol was innovative. Only then is the
+        ///         spill file needed when the data is written
+        bool decode_symbol(const std::string &spill_file,
+                           const uint8_t *coefficients)
+        {
+            assert(coefficients != 0);
+
+            std::copy(coefficients,
+                      coefficients + m_coefficients.size(),
+                      m_coefficients.begin());
+
+            uint32_t index = prepare_unit();
+
+            m_decoder->decode_symbol(&m_unit[0], &m_coefficients[0]);
+
+            return keep_if_innovative(index, spill_file);
+        }
+
+        /// Passes an uncoded symbol to the decoder
+        /// @param spill_file The file holding the symbol data
+        /// @param symbol_index The index of the symbol in the block
+        /// @return True if the symbol was innovative. Only then is the
+        ///         spill file needed when the data is written
+        bool decode_symbol(const std::string &spill_file,
+                           uint32_t symbol_index)
+        {
+            assert(symbol_index < symbols());
+
+            uint32_t index = prepare_unit();
+
+            m_decoder->decode_symbol(&m_unit[0], symbol_index);
+
+            return keep_if_innovative(index, spill_file);
+        }
+
+        /// Writes the decoded block to a file, symbol by symbol. The
+        /// decoding must be complete.
+        /// @param output_file The file to write
+        /// @param chunk_size The number of bytes of every symbol kept in
+        ///        memory at a time, must be a multiple of the field
+        ///        value size
+        /// @return True if the block was written. False if a spill file
+        ///         could not be opened or is shorter than a symbol, or
+        ///         if the output file could not be written, in which
+        ///         case the content of the output file is undefined
+        bool write(const std::string &output_file, uint32_t chunk_size)
+        {
+            assert(is_complete());
+            assert(chunk_size > 0);
+            assert((chunk_size % sizeof(value_type)) == 0);
+
+            chunk_size = static_cast<uint32_t>(
+                std::min<uint64_t>(chunk_size, m_symbol_size));
+
+            std::vector<boost::shared_ptr<std::ifstream> > inputs;
+
+            for(const auto &spill_file : m_spill_files)
+            {
+                auto input = boost::make_shared<std::ifstream>(
+                    spill_file.c_str(), std::ios::binary);
+
+                if(!input->is_open())
+                    return false;
+
+                inputs.push_back(input);
+            }
+
+            std::ofstream output(output_file.c_str(),
+                                 std::ios::binary | std::ios::trunc);
+
+            if(!output.is_open())
+                return false;
+
+            uint32_t symbols = m_spill_files.size();
+
+            aligned_vector chunks(std::size_t(symbols) * chunk_size);
+            aligned_vector result(chunk_size);
+            aligned_vector temp(chunk_size);
+
+            for(uint64_t offset = 0; offset < m_symbol_size;
+                offset += chunk_size)
+            {
+                uint32_t size = static_cast<uint32_t>(
+                    std::min<uint64_t>(chunk_size, m_symbol_size - offset));
+
+                uint32_t length = fifi::size_to_length<field_type>(size);
+
+                for(uint32_t j = 0; j < symbols; ++j)
+                {
+                    char *chunk = reinterpret_cast<char*>(
+                        &chunks[std::size_t(j) * chunk_size]);
+
+                    inputs[j]->read(chunk, size);
+
+                    if(inputs[j]->gcount() != size)
+                        return false;
+                }
+
+                for(uint32_t i = 0; i < symbols; ++i)
+                {
+                    std::fill_n(result.begin(), size, 0);
+
+                    value_type *dest =
+                        reinterpret_cast<value_type*>(&result[0]);
+
+                    const value_type *row = m_decoder->symbol_value(i);
+
+                    for(uint32_t j = 0; j < symbols; ++j)
+                    {
+                        value_type c = fifi::get_value<field_type>(row, j);
+
+                        if(c == 0)
+                            continue;
+
+                        const value_type *src =
+                            reinterpret_cast<const value_type*>(
+                                &chunks[std::size_t(j) * chunk_size]);
+
+                        fifi::multiply_add(
+                            *m_field, c, dest, src,
+                            reinterpret_cast<value_type*>(&temp[0]),
+                            length);
+                    }
+
+                    output.seekp(uint64_t(i) * m_symbol_size + offset);
+                    output.write(
+                        reinterpret_cast<const char*>(&result[0]), size);
+
+                    if(!output)
+                        return false;
+                }
+            }
+
+            output.close();
+            return !output.fail();
+        }
+
+        /// @return True if the coefficient system is solved
+        bool is_complete() const
+        {
+            return m_decoder->is_complete();
+        }
+
+        /// @return The number of innovative symbols received
+        uint32_t rank() const
+        {
+            return m_decoder->rank();
+        }
+
+        /// @return The number of symbols in the block
+        uint32_t symbols() const
+        {
+            return m_decoder->symbols();
+        }
+
+        /// @return The size of a symbol in bytes
+        uint64_t symbol_size() const
+        {
+            return m_symbol_size;
+        }
+
+        /// @return The size of the coefficients of a symbol in bytes
+        uint32_t coefficients_size() const
+        {
+            return m_decoder->coefficients_size();
+        }
+
+    private:
+
+        /// Vector type aligned for the field arithmetics
+        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            aligned_vector;
+
+        /// Sets the unit vector used as data of the next symbol. The
+        /// index is the current rank since a non-innovative symbol is
+        /// dropped and its index may then be reused.
+        /// @return The index of the next innovative symbol
+        uint32_t prepare_unit()
+        {
+            uint32_t index = m_decoder->rank();
+            assert(index < symbols());
+
+            std::fill(m_unit.begin(), m_unit.end(), 0);
+
+            fifi::set_value<field_type>(
+                reinterpret_cast<value_type*>(&m_unit[0]), index, 1U);
+
+            return index;
+        }
+
+        /// Keeps the spill file if the decoder rank increased
+        /// @return True if the symbol was innovative
+        bool keep_if_innovative(uint32_t index,
+                                const std::string &spill_file)
+        {
+            if(m_decoder->rank() == index)
+                return false;
+
+            assert(m_decoder->rank() == index + 1);
+            m_spill_files[index] = spill_file;
+
+            return true;
+        }
+
+    private:
+
+        /// The size of a symbol in bytes
+        uint64_t m_symbol_size;
+
+        /// The decoder solving the coefficient system
+        pointer m_decoder;
+
+        /// The field implementation used for the symbol data
+        boost::shared_ptr<field_impl> m_field;
+
+        /// The spill files of the innovative symbols
+        std::vector<std::string> m_spill_files;
+
+        /// The unit vector used as data of the incoming symbol
+        aligned_vector m_unit;
+
+        /// Copy of the coefficients of the incoming symbol
+        aligned_vector m_coefficients;
+
+    };
+
+}
+
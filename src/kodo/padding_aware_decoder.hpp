@@ -0,0 +1,104 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <fifi/fifi_utils.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Treats the zero padding symbols of a block as decoded.
+    ///
+    /// When the bytes used are set, see layer::set_bytes_used(uint32_t),
+    /// the symbols following the last used byte are known to be zero.
+    /// These symbols are passed to the decoder as uncoded zero symbols
+    /// and their coefficients are cleared in every incoming coded symbol.
+    /// A coded symbol therefore only causes arithmetics on the symbols
+    /// holding data and the decoder completes once it has received as
+    /// many symbols as hold data.
+    ///
+    /// The padding symbols must be zero at the encoder, as is the case
+    /// when the block is read from a storage or file but not for the
+    /// random annex coders.
+    template<class SuperCoder>
+    class padding_aware_decoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// Pull up the decode_symbol() functions
+        using SuperCoder::decode_symbol;
+
+    public:
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            m_zero_symbol.resize(the_factory.max_symbol_size(), 0);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + m_zero_symbol.capacity();
+        }
+
+        /// Decodes the padding symbols following the bytes used
+        /// @copydoc layer::set_bytes_used(uint32_t)
+        void set_bytes_used(uint32_t bytes_used)
+        {
+            SuperCoder::set_bytes_used(bytes_used);
+
+            for(uint32_t i = SuperCoder::symbols_used();
+                i < SuperCoder::symbols(); ++i)
+            {
+                SuperCoder::decode_symbol(&m_zero_symbol[0], i);
+            }
+        }
+
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            value_type *c = reinterpret_cast<value_type*>(coefficients);
+
+            // The padding symbols are zero so they do not contribute to
+            // the symbol data
+            for(uint32_t i = SuperCoder::symbols_used();
+                i < SuperCoder::symbols(); ++i)
+            {
+                fifi::set_value<field_type>(c, i, 0U);
+            }
+
+            SuperCoder::decode_symbol(symbol_data, coefficients);
+        }
+
+    private:
+
+        /// A zero symbol used as the data of the padding symbols
+        std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+            m_zero_symbol;
+
+    };
+
+}
+
@@ -0,0 +1,110 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Restricts the encoding arithmetics to the bytes used.
+    ///
+    /// When the data of a block is smaller than the block, e.g. the last
+    /// block of an object, the last symbol with data is only partially
+    /// used and the symbols following it are zero padding, see
+    /// layer::bytes_used(). This layer encodes the same symbols as the
+    /// linear_block_encoder but skips the padding symbols and only
+    /// combines the used part of the partial symbol. The cost of encoding
+    /// such a block is therefore proportional to the bytes used.
+    ///
+    /// The padding must be zero and the symbol data buffer must be
+    /// zeroed before encoding, e.g. by the zero_symbol_encoder. This is
+    /// not the case for the random annex coders which place symbols of
+    /// other blocks after the bytes used.
+    template<class SuperCoder>
+    class padding_aware_encoder : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// Pull up the encode_symbol() functions
+        using SuperCoder::encode_symbol;
+
+    public:
+
+        /// @copydoc layer::encode_symbol(uint8_t*, uint8_t*)
+        void encode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+
+            value_type *symbol =
+                reinterpret_cast<value_type*>(symbol_data);
+
+            const value_type *c =
+                reinterpret_cast<const value_type*>(coefficients);
+
+            uint32_t symbols = SuperCoder::symbols_used();
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                value_type value = fifi::get_value<field_type>(c, i);
+
+                if(!value)
+                {
+                    continue;
+                }
+
+                const value_type *symbol_i =
+                    SuperCoder::symbol_value(i);
+
+                // Did you forget to set the data on the encoder?
+                assert(symbol_i != 0);
+                assert(SuperCoder::symbol_pivot(i));
+
+                uint32_t length = symbol_length_used(i);
+
+                if(fifi::is_binary<field_type>::value)
+                {
+                    SuperCoder::add(symbol, symbol_i, length);
+                }
+                else
+                {
+                    SuperCoder::multiply_add(symbol, symbol_i, value, length);
+                }
+            }
+        }
+
+    protected:
+
+        /// @param index The index of a symbol
+        /// @return The number of field values covering the bytes used of
+        ///         the symbol
+        uint32_t symbol_length_used(uint32_t index) const
+        {
+            uint32_t size = SuperCoder::symbol_bytes_used(index);
+
+            // Round up to whole field values, the rest of the symbol
+            // is zero
+            size = ((size + sizeof(value_type) - 1) / sizeof(value_type)) *
+                sizeof(value_type);
+
+            return fifi::size_to_length<field_type>(size);
+        }
+
+    };
+
+}
+
@@ -0,0 +1,283 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <sak/aligned_allocator.hpp>
+
+#include "memory_policy.hpp"
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace kodo
+{
+
+    /// @brief Zero initialized memory allocated according to a
+    ///        memory_policy.
+    ///
+    /// On Linux a huge page or NUMA policy maps the memory directly
+    /// using mmap(). Explicit huge pages fall back to transparent huge
+    /// pages if the huge page pool is exhausted, and any policy falls
+    /// back to the heap if the memory cannot be mapped. NUMA binding uses
+    /// the preferred policy, so the kernel may still use a remote node
+    /// if the local node runs out of memory. The memory is touched by the
+    /// allocating thread so the pages are faulted in on its node. On other
+    /// platforms the memory is always allocated from the heap.
+    class page_memory : boost::noncopyable
+    {
+    public:
+
+        /// The size of a huge page in bytes
+        static const uint32_t huge_page_size = 2 * 1024 * 1024;
+
+        /// The size of a regular page in bytes
+        static const uint32_t page_size = 4096;
+
+    public:
+
+        /// Constructor
+        page_memory()
+            : m_data(0),
+              m_size(0),
+              m_mapping(0),
+              m_mapping_size(0),
+              m_huge_pages(memory_policy::huge_pages_none),
+              m_numa_node(-1)
+        { }
+
+        /// Destructor
+        ~page_memory()
+        {
+            release();
+        }
+
+        /// Allocates the memory, should only be called once
+        /// @param size The size of the memory in bytes
+        /// @param policy The policy used for the allocation
+        void allocate(uint32_t size, const memory_policy &policy)
+        {
+            assert(m_data == 0);
+            assert(size > 0);
+
+            m_size = size;
+
+            if(policy.m_huge_pages != memory_policy::huge_pages_none ||
+               policy.m_numa_local)
+            {
+                map(policy);
+            }
+
+            if(m_data == 0)
+            {
+                m_heap.resize(size, 0);
+                m_data = &m_heap[0];
+            }
+        }
+
+        /// @return Pointer to the memory
+        uint8_t* data()
+        {
+            return m_data;
+        }
+
+        /// @return The size of the memory in bytes
+        uint32_t size() const
+        {
+            return m_size;
+        }
+
+        /// @return The number of bytes allocated for the memory, which
+        ///        includes the rounding to whole pages if it is mapped
+        uint64_t allocated_size() const
+        {
+            if(m_mapping != 0)
+                return m_mapping_size;
+
+            return m_heap.capacity();
+        }
+
+        /// @return The kind of pages actually backing the memory
+        memory_policy::huge_pages_type huge_pages() const
+        {
+            return m_huge_pages;
+        }
+
+        /// @return The NUMA node the memory is bound to or -1 if the
+        ///         memory is not bound to a node
+        int32_t numa_node() const
+        {
+            return m_numa_node;
+        }
+
+    private:
+
+        /// @param size A size in bytes
+        /// @param alignment The alignment, must be a power of two
+        /// @return The size rounded up to a multiple of the alignment
+        static uint64_t round_up(uint64_t size, uint64_t alignment)
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+
+#if defined(__linux__)
+
+        /// Maps the memory according to the policy
+        void map(const memory_policy &policy)
+        {
+            uint64_t length = round_up(m_size, page_size);
+
+            if(policy.m_huge_pages == memory_policy::huge_pages_explicit)
+            {
+                length = round_up(m_size, huge_page_size);
+
+                void *mapping = mmap(0, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+                if(mapping != MAP_FAILED)
+                {
+                    m_mapping = mapping;
+                    m_mapping_size = length;
+                    m_data = static_cast<uint8_t*>(mapping);
+                    m_huge_pages = memory_policy::huge_pages_explicit;
+                }
+            }
+
+            if(m_data == 0 &&
+               policy.m_huge_pages != memory_policy::huge_pages_none)
+            {
+                // Over-allocate so the memory can start on a huge page
+                length = round_up(m_size, huge_page_size);
+                uint64_t mapping_size = length + huge_page_size;
+
+                void *mapping = mmap(0, mapping_size,
+                    PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                    -1, 0);
+
+                if(mapping != MAP_FAILED)
+                {
+                    m_mapping = mapping;
+                    m_mapping_size = mapping_size;
+
+                    uintptr_t start = round_up(
+                        reinterpret_cast<uintptr_t>(mapping),
+                        huge_page_size);
+
+                    m_data = reinterpret_cast<uint8_t*>(start);
+
+                    if(madvise(m_data, length, MADV_HUGEPAGE) == 0)
+                        m_huge_pages = memory_policy::huge_pages_transparent;
+                }
+            }
+
+            if(m_data == 0)
+            {
+                void *mapping = mmap(0, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if(mapping == MAP_FAILED)
+                    return;
+
+                m_mapping = mapping;
+                m_mapping_size = length;
+                m_data = static_cast<uint8_t*>(mapping);
+            }
+
+            if(policy.m_numa_local)
+                bind_local(length);
+
+            // Fault the pages in from this thread, the memory is already
+            // zero so this only decides where the pages are placed
+            std::memset(m_data, 0, m_size);
+        }
+
+        /// Prefers the NUMA node of the calling thread for the memory
+        /// @param length The length of the mapped memory in bytes
+        void bind_local(uint64_t length)
+        {
+            // The mempolicy constant from <linux/mempolicy.h>
+            const int mpol_preferred = 1;
+
+            unsigned cpu = 0;
+            unsigned node = 0;
+
+            if(syscall(SYS_getcpu, &cpu, &node, 0) != 0)
+                return;
+
+            const uint32_t mask_words = 16;
+            const uint32_t word_bits = 8 * sizeof(unsigned long);
+
+            if(node >= mask_words * word_bits)
+                return;
+
+            unsigned long mask[mask_words] = { 0 };
+            mask[node / word_bits] = 1UL << (node % word_bits);
+
+            if(syscall(SYS_mbind, m_data, length, mpol_preferred, mask,
+                       mask_words * word_bits, 0) == 0)
+            {
+                m_numa_node = node;
+            }
+        }
+
+        /// Unmaps the memory
+        void release()
+        {
+            if(m_mapping != 0)
+                munmap(m_mapping, m_mapping_size);
+        }
+
+#else
+
+        /// Maps the memory according to the policy, only supported on
+        /// Linux so the heap is used
+        void map(const memory_policy &policy)
+        {
+            (void) policy;
+        }
+
+        /// Unmaps the memory
+        void release()
+        { }
+
+#endif
+
+    private:
+
+        /// Pointer to the memory
+        uint8_t *m_data;
+
+        /// The size of the memory in bytes
+        uint32_t m_size;
+
+        /// The start of the mapping if the memory was mapped
+        void *m_mapping;
+
+        /// The size of the mapping in bytes
+        uint64_t m_mapping_size;
+
+        /// The kind of pages backing the memory
+        memory_policy::huge_pages_type m_huge_pages;
+
+        /// The NUMA node the memory is bound to
+        int32_t m_numa_node;
+
+        /// The memory if the heap is used
+        std::vector<uint8_t, sak::aligned_allocator<uint8_t> > m_heap;
+
+    };
+
+}
+
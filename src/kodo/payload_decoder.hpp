@@ -53,6 +53,23 @@ namespace kodo
             SuperCoder::decode(symbol_data, symbol_id);
         }
 
+        /// Decodes a symbol received in separate symbol data and header
+        /// buffers, e.g. using scatter I/O. The buffers hold the same
+        /// bytes as the two parts of the payload passed to
+        /// decode(uint8_t*).
+        ///
+        /// @param symbol_data The symbol data, must be symbol_size()
+        ///        bytes
+        /// @param symbol_header The symbol header, must be
+        ///        header_size() bytes
+        void decode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            SuperCoder::decode(symbol_data, symbol_header);
+        }
+
         /// @copydoc layer::payload_size() const
         uint32_t payload_size() const
         {
@@ -7,6 +7,10 @@
 
 #include <cstdint>
 
+#include <sak/storage.hpp>
+
+#include "payload_view.hpp"
+
 namespace kodo
 {
 
@@ -70,6 +74,52 @@ namespace kodo
                 + SuperCoder::symbol_size();
         }
 
+        /// Encodes a symbol into separate symbol data and header
+        /// buffers. This allows e.g. the symbol data to be encoded
+        /// directly into a buffer registered with the network card
+        /// while the header is placed in a small separate buffer. The
+        /// bytes produced are the same as with encode(uint8_t*).
+        ///
+        /// @param symbol_data The buffer for the symbol data, must be
+        ///        symbol_size() bytes
+        /// @param symbol_header The buffer for the symbol header, must
+        ///        be at least header_size() bytes
+        /// @return The number of bytes used in the symbol header buffer
+        uint32_t encode(uint8_t *symbol_data, uint8_t *symbol_header)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            return SuperCoder::encode(symbol_data, symbol_header);
+        }
+
+        /// Encodes a symbol like encode(uint8_t*) but without copying
+        /// systematic symbols into the payload buffer. The symbol data
+        /// of a systematic symbol is instead referenced directly in the
+        /// encoder storage, so the views are only valid until the
+        /// storage is changed. Both deep and shallow storage is
+        /// supported.
+        ///
+        /// @param payload The buffer used for the symbol header and, if
+        ///        the symbol is coded, for the symbol data. Must be at
+        ///        least payload_size() bytes.
+        /// @param view The symbol data and header of the payload
+        /// @return The total number of bytes in the payload
+        uint32_t encode_view(uint8_t *payload, payload_view &view)
+        {
+            assert(payload != 0);
+
+            uint8_t *symbol_data = payload;
+            uint8_t *symbol_id = payload + SuperCoder::symbol_size();
+
+            uint32_t header_size = SuperCoder::encode_view(
+                symbol_data, symbol_id, view.m_symbol);
+
+            view.m_header = sak::storage(symbol_id, header_size);
+
+            return view.m_symbol.m_size + header_size;
+        }
+
         /// @copydoc layer::payload_size() const
         uint32_t payload_size() const
         {
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cstdint>
 
 namespace kodo
@@ -20,6 +22,14 @@ namespace kodo
     /// encoder. The only difference being that the a special Symbol ID
     /// layer generating the recoding coefficients and creating the
     /// recoded symbol id (or encoding vector).
+    ///
+    /// The recoding stack is built and initialized on the first call
+    /// to recode(), so coders which never recode do not pay for its
+    /// memory or initialization. Use factory::set_eager_recoding() to
+    /// build it when the coder is initialized instead. The symbols
+    /// produced by the recoding stack must be decodable by the main
+    /// stack, so the header and payload sizes of the coder are those
+    /// of the main stack.
     template<template <class> class RecodingStack, class SuperCoder>
     class payload_recoder : public SuperCoder
     {
@@ -47,7 +57,8 @@ namespace kodo
             /// @copydoc layer::factory::factory(uint32_t,uint32_t)
             factory(uint32_t max_symbols, uint32_t max_symbol_size)
                 : SuperCoder::factory(max_symbols, max_symbol_size),
-                  m_stack_factory(max_symbols, max_symbol_size)
+                  m_stack_factory(max_symbols, max_symbol_size),
+                  m_eager_recoding(false)
             {
                 m_stack_factory.set_factory_proxy(this);
             }
@@ -61,6 +72,31 @@ namespace kodo
                                 m_stack_factory.max_payload_size());
             }
 
+            /// Sets whether the coders built should have their recoding
+            /// stack built and initialized when they are initialized
+            /// instead of on the first call to recode(). The default is
+            /// false.
+            /// @param eager_recoding True if the recoding stack should be
+            ///        built when a coder is initialized
+            void set_eager_recoding(bool eager_recoding)
+            {
+                m_eager_recoding = eager_recoding;
+            }
+
+            /// @return True if the recoding stack of a coder is built
+            ///         when the coder is initialized
+            bool eager_recoding() const
+            {
+                return m_eager_recoding;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                return SuperCoder::factory::memory_usage() +
+                    m_stack_factory.memory_usage();
+            }
+
         private:
 
             /// Give the layer access
@@ -74,68 +110,106 @@ namespace kodo
 
         private:
 
+            /// The factory of the recoding stacks
             typename recode_stack::factory m_stack_factory;
 
+            /// True if the recoding stack is built on initialize
+            bool m_eager_recoding;
+
         };
 
     public:
 
+        /// Constructor
+        payload_recoder()
+            : m_recode_factory(0),
+              m_recode_initialized(false)
+        { }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
         {
             SuperCoder::initialize(the_factory);
 
-            // We have to postpone building the recoding stack to the
-            // initialize function, since we have to ensure that the
-            // main stack has been constructed and initialized.
-
-            auto& stack_factory = the_factory.recode_factory();
+            // The recoding stack is built or initialized when first
+            // used, since we have to ensure that the main stack has been
+            // constructed and initialized.
+            m_recode_factory = &the_factory.recode_factory();
+            m_recode_initialized = false;
 
-            if(!m_recode_stack)
-            {
-                stack_factory.set_stack_proxy(this);
-                m_recode_stack = stack_factory.build();
-            }
-            else
+            if(the_factory.eager_recoding())
             {
-
-                m_recode_stack->initialize(the_factory.recode_factory());
+                prepare_recode_stack();
             }
         }
 
         /// @copydoc layer::recode(uint8_t*)
         void recode(uint8_t *payload)
         {
-            assert(m_recode_stack);
+            prepare_recode_stack();
             m_recode_stack->encode(payload);
         }
 
-        /// Make sure we have enough space for both the payload
-        /// produced by the main stack and the recoding stack.
-        /// @copydoc layer::payload_size() const
-        uint32_t payload_size() const
+        /// Recodes a symbol into separate symbol data and header buffers
+        /// @param symbol_data The buffer for the symbol data, must be
+        ///        symbol_size() bytes
+        /// @param symbol_header The buffer for the symbol header, must
+        ///        be at least header_size() bytes
+        /// @return The number of bytes used in the symbol header buffer
+        uint32_t recode(uint8_t *symbol_data, uint8_t *symbol_header)
         {
-            assert(m_recode_stack);
-            return std::max(SuperCoder::payload_size(),
-                            m_recode_stack->payload_size());
+            prepare_recode_stack();
+            return m_recode_stack->encode(symbol_data, symbol_header);
         }
 
-    private:
+        /// @return True if the coder has built its recoding stack
+        bool has_recode_stack() const
+        {
+            return m_recode_stack.get() != 0;
+        }
 
-        /// Sets the recoding stack on the coder
-        /// @param recoder The recoding stack.
-        void set_recode_stack(const recode_pointer &recoder)
+        /// Includes the recoding stack once it has been built
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
         {
-            assert(!m_recode_stack);
-            m_recode_stack = recoder;
+            uint64_t usage = SuperCoder::memory_usage();
+
+            if(m_recode_stack)
+                usage += m_recode_stack->memory_usage();
+
+            return usage;
         }
 
-        /// @return True if the coder already has already been initialized
-        ///         with an recoding stack
-        bool has_recode_stack() const
+    private:
+
+        /// Builds the recoding stack if the coder does not have one,
+        /// otherwise initializes it if needed since the coder was
+        /// initialized.
+        void prepare_recode_stack()
         {
-            return m_recode_stack.get() != 0;
+            assert(m_recode_factory);
+
+            if(m_recode_initialized)
+                return;
+
+            if(!m_recode_stack)
+            {
+                // Building the stack also initializes it
+                m_recode_stack = m_recode_factory->build(this);
+            }
+            else
+            {
+                m_recode_stack->initialize(*m_recode_factory);
+            }
+
+            // The recoded symbols are decoded by the main stack
+            assert(m_recode_stack->header_size() <=
+                   SuperCoder::header_size());
+            assert(m_recode_stack->payload_size() <=
+                   SuperCoder::payload_size());
+
+            m_recode_initialized = true;
         }
 
     protected:
@@ -143,8 +217,14 @@ namespace kodo
         /// Store the recode stack
         recode_pointer m_recode_stack;
 
+        /// The factory of the recoding stack
+        typename recode_stack::factory *m_recode_factory;
+
+        /// True if the recoding stack has been initialized since the
+        /// coder was initialized
+        bool m_recode_initialized;
+
     };
 
 }
 
-
@@ -0,0 +1,42 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <sak/storage.hpp>
+
+namespace kodo
+{
+
+    /// @brief Describes an encoded payload as two separate buffers.
+    ///
+    /// The payload is the symbol data followed by the symbol header, i.e.
+    /// the same bytes as produced by the layer::encode(uint8_t*)
+    /// function. The two parts may be passed directly to a gather write
+    /// such as writev() or sendmsg():
+    ///
+    /// @code
+    ///   kodo::payload_view view;
+    ///   encoder->encode_view(&buffer[0], view);
+    ///
+    ///   iovec iov[2];
+    ///   iov[0].iov_base = (void*) view.m_symbol.m_data;
+    ///   iov[0].iov_len = view.m_symbol.m_size;
+    ///   iov[1].iov_base = (void*) view.m_header.m_data;
+    ///   iov[1].iov_len = view.m_header.m_size;
+    ///
+    ///   writev(socket, iov, 2);
+    /// @endcode
+    struct payload_view
+    {
+        /// The symbol data, for systematic symbols this refers directly
+        /// to the encoder storage
+        sak::const_storage m_symbol;
+
+        /// The symbol header
+        sak::const_storage m_header;
+    };
+
+}
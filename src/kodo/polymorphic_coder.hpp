@@ -0,0 +1,266 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <boost/shared_ptr.hpp>
+
+#include <sak/storage.hpp>
+
+namespace kodo
+{
+
+    /// @brief Runtime interface of an encoder, used where the stack is
+    ///        selected at runtime, see the geometry_registry.
+    ///
+    /// Only the payload API is virtual, so a call costs one indirection
+    /// per payload while the stack below is fully inlined.
+    class encoder_interface
+    {
+    public:
+
+        /// Destructor
+        virtual ~encoder_interface()
+        { }
+
+        /// @copydoc layer::set_symbols(const sak::const_storage&)
+        virtual void set_symbols(const sak::const_storage &symbol_storage) = 0;
+
+        /// @copydoc layer::encode(uint8_t*)
+        virtual uint32_t encode(uint8_t *payload) = 0;
+
+        /// @copydoc layer::payload_size() const
+        virtual uint32_t payload_size() const = 0;
+
+        /// @copydoc layer::symbols() const
+        virtual uint32_t symbols() const = 0;
+
+        /// @copydoc layer::symbol_size() const
+        virtual uint32_t symbol_size() const = 0;
+
+        /// @copydoc layer::block_size() const
+        virtual uint32_t block_size() const = 0;
+    };
+
+    /// @brief Runtime interface of a decoder, used where the stack is
+    ///        selected at runtime, see the geometry_registry.
+    class decoder_interface
+    {
+    public:
+
+        /// Destructor
+        virtual ~decoder_interface()
+        { }
+
+        /// @copydoc layer::decode(uint8_t*)
+        virtual void decode(uint8_t *payload) = 0;
+
+        /// @copydoc layer::copy_symbols(const sak::mutable_storage&)
+        virtual void copy_symbols(const sak::mutable_storage &dest) = 0;
+
+        /// @copydoc layer::is_complete() const
+        virtual bool is_complete() const = 0;
+
+        /// @copydoc layer::rank() const
+        virtual uint32_t rank() const = 0;
+
+        /// @copydoc layer::payload_size() const
+        virtual uint32_t payload_size() const = 0;
+
+        /// @copydoc layer::symbols() const
+        virtual uint32_t symbols() const = 0;
+
+        /// @copydoc layer::symbol_size() const
+        virtual uint32_t symbol_size() const = 0;
+
+        /// @copydoc layer::block_size() const
+        virtual uint32_t block_size() const = 0;
+    };
+
+    /// @brief Implements the encoder_interface using an encoder stack
+    ///
+    /// The encoder is built by the given factory, which is kept alive
+    /// as long as the encoder since the pooled factories recycle their
+    /// coders.
+    template<class Encoder>
+    class polymorphic_encoder : public encoder_interface
+    {
+    public:
+
+        /// The interface implemented
+        typedef encoder_interface interface_type;
+
+        /// The encoder stack
+        typedef Encoder coder_type;
+
+        /// The factory of the encoder
+        typedef typename Encoder::factory factory;
+
+        /// Pointer to the factory
+        typedef boost::shared_ptr<factory> factory_pointer;
+
+    public:
+
+        /// Constructor
+        /// @param the_factory The factory used to build the encoder
+        polymorphic_encoder(const factory_pointer &the_factory)
+            : m_factory(the_factory),
+              m_encoder(the_factory->build())
+        {
+            assert(m_encoder);
+        }
+
+        /// @copydoc layer::set_symbols(const sak::const_storage&)
+        void set_symbols(const sak::const_storage &symbol_storage)
+        {
+            m_encoder->set_symbols(symbol_storage);
+        }
+
+        /// @copydoc layer::encode(uint8_t*)
+        uint32_t encode(uint8_t *payload)
+        {
+            return m_encoder->encode(payload);
+        }
+
+        /// @copydoc layer::payload_size() const
+        uint32_t payload_size() const
+        {
+            return m_encoder->payload_size();
+        }
+
+        /// @copydoc layer::symbols() const
+        uint32_t symbols() const
+        {
+            return m_encoder->symbols();
+        }
+
+        /// @copydoc layer::symbol_size() const
+        uint32_t symbol_size() const
+        {
+            return m_encoder->symbol_size();
+        }
+
+        /// @copydoc layer::block_size() const
+        uint32_t block_size() const
+        {
+            return m_encoder->block_size();
+        }
+
+        /// @return The wrapped encoder
+        const typename Encoder::pointer& coder() const
+        {
+            return m_encoder;
+        }
+
+    private:
+
+        /// The factory which built the encoder
+        factory_pointer m_factory;
+
+        /// The encoder
+        typename Encoder::pointer m_encoder;
+    };
+
+    /// @brief Implements the decoder_interface using a decoder stack
+    ///
+    /// The decoder is built by the given factory, which is kept alive
+    /// as long as the decoder since the pooled factories recycle their
+    /// coders.
+    template<class Decoder>
+    class polymorphic_decoder : public decoder_interface
+    {
+    public:
+
+        /// The interface implemented
+        typedef decoder_interface interface_type;
+
+        /// The decoder stack
+        typedef Decoder coder_type;
+
+        /// The factory of the decoder
+        typedef typename Decoder::factory factory;
+
+        /// Pointer to the factory
+        typedef boost::shared_ptr<factory> factory_pointer;
+
+    public:
+
+        /// Constructor
+        /// @param the_factory The factory used to build the decoder
+        polymorphic_decoder(const factory_pointer &the_factory)
+            : m_factory(the_factory),
+              m_decoder(the_factory->build())
+        {
+            assert(m_decoder);
+        }
+
+        /// @copydoc layer::decode(uint8_t*)
+        void decode(uint8_t *payload)
+        {
+            m_decoder->decode(payload);
+        }
+
+        /// @copydoc layer::copy_symbols(const sak::mutable_storage&)
+        void copy_symbols(const sak::mutable_storage &dest)
+        {
+            m_decoder->copy_symbols(dest);
+        }
+
+        /// @copydoc layer::is_complete() const
+        bool is_complete() const
+        {
+            return m_decoder->is_complete();
+        }
+
+        /// @copydoc layer::rank() const
+        uint32_t rank() const
+        {
+            return m_decoder->rank();
+        }
+
+        /// @copydoc layer::payload_size() const
+        uint32_t payload_size() const
+        {
+            return m_decoder->payload_size();
+        }
+
+        /// @copydoc layer::symbols() const
+        uint32_t symbols() const
+        {
+            return m_decoder->symbols();
+        }
+
+        /// @copydoc layer::symbol_size() const
+        uint32_t symbol_size() const
+        {
+            return m_decoder->symbol_size();
+        }
+
+        /// @copydoc layer::block_size() const
+        uint32_t block_size() const
+        {
+            return m_decoder->block_size();
+        }
+
+        /// @return The wrapped decoder
+        const typename Decoder::pointer& coder() const
+        {
+            return m_decoder;
+        }
+
+    private:
+
+        /// The factory which built the decoder
+        factory_pointer m_factory;
+
+        /// The decoder
+        typename Decoder::pointer m_decoder;
+    };
+
+}
+
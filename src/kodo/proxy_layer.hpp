@@ -7,6 +7,9 @@
 
 #include <cstdint>
 
+#include "coder_arena.hpp"
+#include "memory_policy.hpp"
+
 namespace kodo
 {
 
@@ -67,12 +70,23 @@ namespace kodo
             /// @copydoc layer::factory::build()
             pointer build()
             {
-                assert(m_factory_proxy != 0);
                 assert(m_stack_proxy != 0);
+                return build(m_stack_proxy);
+            }
+
+            /// Builds a proxy stack forwarding calls to the given main
+            /// stack. Unlike set_stack_proxy() followed by build() this
+            /// does not change the state of the factory.
+            /// @param stack_proxy The stack where calls should be forwarded.
+            /// @return The proxy stack
+            pointer build(MainStack* stack_proxy)
+            {
+                assert(m_factory_proxy != 0);
+                assert(stack_proxy != 0);
 
                 pointer coder = boost::make_shared<FinalType>();
 
-                coder->set_proxy(m_stack_proxy);
+                coder->set_proxy(stack_proxy);
 
                 factory_type *this_factory =
                     static_cast<factory_type*>(this);
@@ -83,6 +97,29 @@ namespace kodo
                 return coder;
             }
 
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                // The proxy stack has its own arena, so the layers in
+                // the proxy stack add their size to this
+                return 0;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                // The main stack factory is accounted for by its owner,
+                // so the layers in the proxy stack add their usage to this
+                return 0;
+            }
+
+            /// @return The memory policy of the main stack factory
+            const kodo::memory_policy& memory_policy() const
+            {
+                assert(m_factory_proxy);
+                return m_factory_proxy->memory_policy();
+            }
+
             /// @copydoc layer::factory::max_symbols() const
             uint32_t max_symbols() const
             {
@@ -176,7 +213,8 @@ namespace kodo
         template<class Factory>
         void construct(Factory &the_factory)
         {
-            (void) the_factory;
+            m_arena.resize(the_factory.arena_size(),
+                           the_factory.memory_policy());
         }
 
         /// @copydoc layer::initialize(Factory&)
@@ -186,6 +224,30 @@ namespace kodo
             (void) the_factory;
         }
 
+        /// @copydoc layer::arena_allocate(uint32_t)
+        uint8_t* arena_allocate(uint32_t size)
+        {
+            return m_arena.allocate(size);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            // The layers holding memory outside the arena add their
+            // usage to this
+            return sizeof(FinalType) + m_arena.memory().allocated_size();
+        }
+
+        /// @copydoc layer::adopt_symbol(uint32_t, const uint8_t*)
+        bool adopt_symbol(uint32_t index, const uint8_t *symbol_data)
+        {
+            /// This is the final layer so the symbol data is copied
+            (void) index;
+            (void) symbol_data;
+
+            return false;
+        }
+
         //------------------------------------------------------------------
         // SYMBOL STORAGE API
         //------------------------------------------------------------------
@@ -462,11 +524,48 @@ namespace kodo
             return m_proxy->symbol_pivot(index);
         }
 
+        /// @copydoc layer::symbol_coded(uint32_t) const
+        bool symbol_coded(uint32_t index) const
+        {
+            assert(m_proxy);
+            return m_proxy->symbol_coded(index);
+        }
+
+        //------------------------------------------------------------------
+        // RUNNING COMBINATIONS API
+        //------------------------------------------------------------------
+
+        /// @copydoc running_combinations::next_running_combination()
+        uint32_t next_running_combination()
+        {
+            assert(m_proxy);
+            return m_proxy->next_running_combination();
+        }
+
+        /// @copydoc running_combinations::running_combination_symbol(
+        ///              uint32_t) const
+        const uint8_t* running_combination_symbol(uint32_t index) const
+        {
+            assert(m_proxy);
+            return m_proxy->running_combination_symbol(index);
+        }
+
+        /// @copydoc running_combinations::running_combination_coefficients(
+        ///              uint32_t) const
+        const uint8_t* running_combination_coefficients(uint32_t index) const
+        {
+            assert(m_proxy);
+            return m_proxy->running_combination_coefficients(index);
+        }
+
     protected:
 
         /// Pointer to the main stack
         MainStack *m_proxy;
 
+        /// The memory shared by the layers of the proxy stack
+        coder_arena m_arena;
+
     };
 
 }
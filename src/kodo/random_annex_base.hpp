@@ -8,14 +8,13 @@
 
 #include <stdint.h>
 
-#include <set>
+#include <algorithm>
 #include <vector>
 
 #include <boost/make_shared.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
-#include <boost/dynamic_bitset.hpp>
 
 namespace kodo
 {
@@ -86,7 +85,7 @@ namespace kodo
 
     };
 
-    /// Allows our annex info class to be used in e.g. a std::set
+    /// Allows our annex info class to be kept in a sorted array
     inline bool operator<(const annex_info &a, const annex_info &b)
     {
         return a.m_coder_id < b.m_coder_id ||
@@ -94,7 +93,35 @@ namespace kodo
              a.m_symbol_id < b.m_symbol_id);
     }
 
+    /// @return true if the two annex info objects are equal
+    inline bool operator==(const annex_info &a, const annex_info &b)
+    {
+        return a.m_coder_id == b.m_coder_id &&
+            a.m_symbol_id == b.m_symbol_id;
+    }
+
+    /// @brief Reverse annex info helper class. Describes a symbol of a
+    ///        block which is part of the annex of another block.
+    struct reverse_annex_info
+    {
+        /// The id of the coder which has the symbol in its annex
+        uint32_t m_coder_id;
+
+        /// The position of the symbol in the annex of that coder
+        uint32_t m_annex_position;
+
+        /// The id of the symbol in the block owning it
+        uint32_t m_symbol_id;
+    };
+
     /// @brief Base class for the random annex encoder and decoder.
+    ///
+    /// The annex of every block is stored as a sorted range in one flat
+    /// array, the range of block i is [i * annex_size, (i + 1) *
+    /// annex_size). The reverse annex is stored in compressed row form,
+    /// the entries of block i are found in the range
+    /// [m_reverse_offset[i], m_reverse_offset[i+1]) sorted by the
+    /// receiving coder.
     template<class BlockPartitioning>
     class random_annex_base : boost::noncopyable
     {
@@ -103,16 +130,17 @@ namespace kodo
         /// The block partitioning scheme used
         typedef BlockPartitioning block_partitioning;
 
-        /// Convenient typedef to make the Standard Libary insert
-        /// ugly'ness a bit more nicer
-        typedef std::pair<std::set<annex_info>::iterator,bool> annex_return;
-
         /// The uniform int distribution
         typedef boost::random::uniform_int_distribution<uint32_t>
             uniform_int;
 
     public:
 
+        /// Constructor
+        random_annex_base()
+            : m_annex_block_size(0)
+            { }
+
         /// Builds the random annex according to the given annex size and
         /// partitioning scheme
         /// @param annex_size the size of the annex
@@ -123,24 +151,23 @@ namespace kodo
                 // Get the number of blocks for this object
                 uint32_t blocks = partitioning.blocks();
 
-                // Prepare annex
-                m_annex.resize(blocks);
+                m_annex.clear();
+                m_reverse_annex.clear();
 
-                // Prepare reverse annex
-                m_reverse_annex.resize(blocks);
+                // The offsets are always valid which means that the
+                // algorithms operating on the data structures does not
+                // have to perform the check for annex_size == 0 or
+                // blocks < 2
+                m_reverse_offset.assign(blocks + 1, 0);
 
                 if(annex_size == 0 || blocks < 2)
                 {
-                    // No need to continue - we leave the resize since
-                    // then the algorithms operating on the data
-                    // structures (m_annex or m_reverse_annex) does not
-                    // have to perform the check for
-                    // annex_size == 0 or blocks < 2
+                    m_annex_block_size = 0;
                     return;
                 }
 
-                for(uint32_t i = 0; i < blocks; ++i)
-                    m_reverse_annex[i].resize(blocks);
+                m_annex_block_size = annex_size;
+                m_annex.resize(blocks * annex_size);
 
                 // For 5 blocks generate between [0,..,3] since 1 block is
                 // always excluded only 4 values are suitable. When
@@ -149,19 +176,8 @@ namespace kodo
                 m_block_distribution
                     = uniform_int(0, blocks - 2);
 
-                // std::cout << "Total blocks " << blocks << std::endl;
-                // std::cout << "Annex " << annex_size << std::endl;
-                // for(uint32_t i = 0; i < blocks; ++i)
-                // {
-                //     std::cout << "Block " << i << " symbols "
-                //               << partitioning.symbols(i) << std::endl;
-                // }
-
                 for(uint32_t i = 0; i < blocks; ++i)
                 {
-                    //std::cout << "Block " << i << " has "
-                    //<< partitioning.symbols(i) << " symbols" << std::endl;
-
                     // Safety check -- since we select the annex overlap
                     //randomly without replacement there is no way we
                     // can have an annex bigger than the number of
@@ -169,7 +185,10 @@ namespace kodo
                     assert(annex_size < (partitioning.total_symbols() -
                                          partitioning.symbols(i)));
 
-                    while(m_annex[i].size() < annex_size)
+                    annex_info *first = annex_begin(i);
+                    annex_info *last = first;
+
+                    while(uint32_t(last - first) < annex_size)
                     {
                         uint32_t block_id = select_block(i);
 
@@ -178,44 +197,99 @@ namespace kodo
 
                         annex_info annex(block_id, symbol_id);
 
-                        // Here we rely on the fact that the set will
-                        // not insert the element if it already exists
-                        annex_return ret = m_annex[i].insert(annex);
-
-                        if(ret.second == true)
-                        {
-                            m_reverse_annex[block_id][i] = 1;
-                        }
-                        else
-                        {
-                            //std::cout << "Could not insert " << std::endl;
-                        }
+                        // Keep the range sorted and skip entries which
+                        // have already been selected
+                        annex_info *pos =
+                            std::lower_bound(first, last, annex);
+
+                        if(pos != last && *pos == annex)
+                            continue;
+
+                        std::copy_backward(pos, last, last + 1);
+                        *pos = annex;
+                        ++last;
+
+                        ++m_reverse_offset[block_id + 1];
+                    }
+                }
+
+                // Prefix sum of the reverse annex sizes
+                for(uint32_t i = 0; i < blocks; ++i)
+                {
+                    m_reverse_offset[i + 1] += m_reverse_offset[i];
+                }
+
+                m_reverse_annex.resize(m_reverse_offset[blocks]);
+
+                // Fill in the reverse annex, since we visit the coders in
+                // increasing order the entries of every block will be
+                // sorted by the receiving coder
+                std::vector<uint32_t> fill(m_reverse_offset.begin(),
+                                           m_reverse_offset.end() - 1);
+
+                for(uint32_t i = 0; i < blocks; ++i)
+                {
+                    const annex_info *annex = annex_begin(i);
+
+                    for(uint32_t j = 0; j < annex_size; ++j)
+                    {
+                        uint32_t from_block = annex[j].m_coder_id;
+
+                        reverse_annex_info &info =
+                            m_reverse_annex[fill[from_block]++];
+
+                        info.m_coder_id = i;
+                        info.m_annex_position = j;
+                        info.m_symbol_id = annex[j].m_symbol_id;
                     }
                 }
+            }
 
-                // for(uint32_t i = 0; i < blocks; ++i)
-                // {
-                //     std::set<annex_info>::iterator it;
-                //     for(it = m_annex[i].begin(); it != m_annex[i].end(); ++it)
-                //     {
-                //         annex_info annex = *it;
-
-                //         std::cout << "For block " << i << " select block "
-                //                   << annex.first << " and symbol id " << annex.second
-                //                   << std::endl;
-                //     }
-
-                //     std::cout << "For block " << i << " reverse annex: ";
-                //     for(uint32_t j = 0; j < blocks; ++j)
-                //     {
-                //         std::cout << m_reverse_annex[i][j] << " ";
-                //     }
-                //     std::cout << std::endl;
-                // }
+        /// @return The number of bytes held by the annex and reverse
+        ///         annex tables
+        uint64_t memory_usage() const
+            {
+                return m_annex.capacity() * sizeof(annex_info) +
+                    m_reverse_annex.capacity() * sizeof(reverse_annex_info) +
+                    m_reverse_offset.capacity() * sizeof(uint32_t);
             }
 
     protected:
 
+        /// @param block_id the block id
+        /// @return pointer to the first entry in the annex of the block
+        annex_info* annex_begin(uint32_t block_id)
+            {
+                assert(block_id * m_annex_block_size <= m_annex.size());
+                return m_annex.data() + block_id * m_annex_block_size;
+            }
+
+        /// @param block_id the block id
+        /// @return pointer past the last entry in the annex of the block
+        annex_info* annex_end(uint32_t block_id)
+            {
+                return annex_begin(block_id) + m_annex_block_size;
+            }
+
+        /// @param block_id the block id
+        /// @return pointer to the first entry in the reverse annex of
+        ///         the block
+        const reverse_annex_info* reverse_annex_begin(uint32_t block_id) const
+            {
+                assert(block_id + 1 < m_reverse_offset.size());
+                return m_reverse_annex.data() + m_reverse_offset[block_id];
+            }
+
+        /// @param block_id the block id
+        /// @return pointer past the last entry in the reverse annex of
+        ///         the block
+        const reverse_annex_info* reverse_annex_end(uint32_t block_id) const
+            {
+                assert(block_id + 1 < m_reverse_offset.size());
+                return m_reverse_annex.data() +
+                    m_reverse_offset[block_id + 1];
+            }
+
         /// Selects a block from the block distribution, however
         /// with a certain block excluded
         /// @param exclude_block block excluded from the random pick
@@ -258,14 +332,20 @@ namespace kodo
         /// The random generator
         boost::random::mt19937 m_random_generator;
 
-        /// Stores the annex for every block
-        std::vector< std::set<annex_info> > m_annex;
+        /// The number of annex entries per block, zero if no annex
+        /// is used
+        uint32_t m_annex_block_size;
 
-        /// Stores the reverse annex
-        std::vector< boost::dynamic_bitset<> > m_reverse_annex;
+        /// Stores the sorted annex of every block
+        std::vector<annex_info> m_annex;
+
+        /// Stores the reverse annex of every block
+        std::vector<reverse_annex_info> m_reverse_annex;
+
+        /// Offsets of the reverse annex of every block
+        std::vector<uint32_t> m_reverse_offset;
     };
 
 }
 
 #endif
-
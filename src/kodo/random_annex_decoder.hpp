@@ -38,15 +38,6 @@ namespace kodo
         /// The base
         typedef random_annex_base<BlockPartitioning> Base;
 
-        /// Pull up the annex
-        using Base::m_annex;
-
-        /// Pull up the reverse annex
-        using Base::m_reverse_annex;
-
-        /// The annex iterator type
-        typedef typename std::set<annex_info>::iterator annex_iterator;
-
         /// The callback function to invoke when a decoder completes
         typedef boost::function<void ()> is_complete_handler;
 
@@ -152,6 +143,9 @@ namespace kodo
 
                 // Build decoders
                 build_decoders();
+
+                // A decoder can complete at most once
+                m_completed.reserve(m_decoders.size());
             }
 
         /// @return the number of decoders which may be created for
@@ -177,102 +171,153 @@ namespace kodo
                 return m_object_size;
             }
 
+        /// @return the number of bytes held by the object decoder, i.e.
+        ///         the annex tables and the decoders of all blocks
+        uint64_t memory_usage() const
+            {
+                uint64_t usage = sizeof(random_annex_decoder) +
+                    Base::memory_usage() +
+                    m_decoders.capacity() * sizeof(wrap_coder) +
+                    m_completed.capacity() * sizeof(uint32_t);
+
+                for(const auto &decoder : m_decoders)
+                {
+                    assert(decoder.m_c);
+                    usage += decoder.m_c->memory_usage();
+                }
+
+                return usage;
+            }
+
     private:
 
-        void forward_annex(uint32_t from_decoder)
+        /// Called when a decoder completes through the public API.
+        /// Propagates the decoded symbols to the decoders sharing
+        /// symbols with it. Decoders completing during the propagation
+        /// are queued and processed in turn, so the propagation is
+        /// never recursive.
+        /// @param decoder_id the decoder which completed
+        void decoder_complete(uint32_t decoder_id)
             {
-                assert(from_decoder < m_decoders.size());
-                assert(from_decoder < m_annex.size());
-
-                // Where does the annex start
-                uint32_t from_symbol =
-                    m_decoders[from_decoder]->symbols() - m_annex_size;
+                assert(decoder_id < m_decoders.size());
 
-                // Fetch the annex for the decoder
-                std::set<annex_info> &annex = m_annex[from_decoder];
+                m_completed.push_back(decoder_id);
 
-                // For every entry in the annex
-                for(auto it = annex.begin(); it != annex.end(); ++it)
+                if(m_completed.size() > 1)
                 {
-                    forward_symbol(from_symbol, from_decoder,
-                                   it->m_symbol_id, it->m_coder_id);
+                    // Already propagating, the decoder will be
+                    // processed by the loop below
+                    return;
+                }
 
-                    // Next entry in the annex
-                    ++from_symbol;
+                for(uint32_t i = 0; i < m_completed.size(); ++i)
+                {
+                    forward_annex(m_completed[i]);
+                    reverse_annex(m_completed[i]);
                 }
+
+                m_completed.clear();
             }
 
-        void forward_symbol(uint32_t from_symbol, uint32_t from_decoder,
-                            uint32_t to_symbol, uint32_t to_decoder)
+        /// Passes the symbols of the completed decoder which are part of
+        /// other decoders' blocks to those decoders. Since the annex is
+        /// sorted by coder id all symbols for one decoder are passed in
+        /// a single batch.
+        /// @param from_decoder the decoder which completed
+        void forward_annex(uint32_t from_decoder)
             {
                 assert(from_decoder < m_decoders.size());
-                assert(to_decoder < m_decoders.size());
-                assert(from_symbol < m_decoders[from_decoder]->symbols());
-                assert(to_symbol < m_decoders[to_decoder]->symbols());
 
-                if(m_decoders[to_decoder]->is_complete())
-                    return;
+                const annex_info *first = Base::annex_begin(from_decoder);
+                const annex_info *last = Base::annex_end(from_decoder);
 
-                // Get the symbol data
-                uint8_t *symbol_data =
-                    m_decoders[from_decoder]->symbol(from_symbol);
+                // Where does the annex start
+                uint32_t from_symbol =
+                    m_decoders[from_decoder].m_c->symbols() - m_annex_size;
 
-                // Pass it to the other decoder
-                m_decoders[to_decoder]->decode_symbol(
-                    symbol_data, to_symbol);
-            }
+                while(first != last)
+                {
+                    uint32_t to_decoder = first->m_coder_id;
+                    assert(to_decoder < m_decoders.size());
 
-        void decoder_complete(uint32_t decoder_id)
-            {
-                /// @todo: can this check be done better
-                //assert(m_annex_size != 0);
-                //assert(m_partitioning.blocks() > 1);
+                    internal_pointer_type &to = m_decoders[to_decoder].m_c;
+                    internal_pointer_type &from =
+                        m_decoders[from_decoder].m_c;
+
+                    bool complete = to->is_complete();
+
+                    for(; first != last && first->m_coder_id == to_decoder;
+                        ++first, ++from_symbol)
+                    {
+                        if(complete)
+                            continue;
+
+                        assert(first->m_symbol_id < to->symbols());
+
+                        to->decode_symbol(from->symbol(from_symbol),
+                                          first->m_symbol_id);
+                    }
 
-                forward_annex(decoder_id);
-                reverse_annex(decoder_id);
+                    queue_if_complete(complete, to_decoder);
+                }
             }
 
+        /// Passes the symbols of the completed decoder which are part of
+        /// other decoders' annex to those decoders. The reverse annex is
+        /// sorted by the receiving decoder so all symbols for one
+        /// decoder are passed in a single batch.
+        /// @param from_decoder the decoder which completed
         void reverse_annex(uint32_t from_decoder)
             {
                 assert(from_decoder < m_decoders.size());
-                assert(from_decoder < m_annex.size());
-                assert(from_decoder < m_reverse_annex.size());
 
-                // Now we use the reverse annex info to further pass
-                // symbols to decoders with our decoded block in
-                // their annex
-                uint32_t reverse_annex_size =
-                    m_reverse_annex[from_decoder].size();
+                const reverse_annex_info *first =
+                    Base::reverse_annex_begin(from_decoder);
+
+                const reverse_annex_info *last =
+                    Base::reverse_annex_end(from_decoder);
+
+                internal_pointer_type &from = m_decoders[from_decoder].m_c;
 
-                for(uint32_t to_decoder = 0;
-                    to_decoder < reverse_annex_size; ++to_decoder)
+                while(first != last)
                 {
-                    if(!m_reverse_annex[from_decoder][to_decoder])
-                        continue;
+                    uint32_t to_decoder = first->m_coder_id;
+                    assert(to_decoder < m_decoders.size());
 
-                    if(m_decoders[to_decoder]->is_complete())
-                        continue;
+                    internal_pointer_type &to = m_decoders[to_decoder].m_c;
 
-                    // Decoder 'to_decoder' has 'from_decoder' in the annex -
-                    //we need to inspect the annex of 'to_decoder' to see
-                    // which symbols it is. Fetch the annex for the decoder
-                    std::set<annex_info> &annex = m_annex[to_decoder];
+                    bool complete = to->is_complete();
 
-                    for(annex_iterator it = annex.begin();
-                        it != annex.end(); ++it)
+                    // Where does the annex start
+                    uint32_t annex_start = to->symbols() - m_annex_size;
+
+                    for(; first != last && first->m_coder_id == to_decoder;
+                        ++first)
                     {
-                        if(it->m_coder_id != from_decoder)
+                        if(complete)
                             continue;
 
-                        uint32_t to_symbol =
-                            m_decoders[to_decoder]->symbols() -
-                            m_annex_size + std::distance(annex.begin(), it);
-
-                        uint32_t from_symbol = it->m_symbol_id;
+                        assert(first->m_annex_position < m_annex_size);
 
-                        forward_symbol(from_symbol, from_decoder,
-                                       to_symbol, to_decoder);
+                        to->decode_symbol(
+                            from->symbol(first->m_symbol_id),
+                            annex_start + first->m_annex_position);
                     }
+
+                    queue_if_complete(complete, to_decoder);
+                }
+            }
+
+        /// Queues a decoder for propagation if it completed due to the
+        /// symbols forwarded to it
+        /// @param was_complete whether the decoder was complete before
+        ///        the symbols were forwarded
+        /// @param decoder_id the decoder
+        void queue_if_complete(bool was_complete, uint32_t decoder_id)
+            {
+                if(!was_complete && m_decoders[decoder_id].m_c->is_complete())
+                {
+                    m_completed.push_back(decoder_id);
                 }
             }
 
@@ -334,6 +379,10 @@ namespace kodo
 
         /// Vector for all the decoders
         std::vector<wrap_coder> m_decoders;
+
+        /// Decoders which completed and whose symbols should be
+        /// propagated
+        std::vector<uint32_t> m_completed;
     };
 
 }
@@ -43,9 +43,6 @@ namespace kodo
         /// The base
         typedef random_annex_base<BlockPartitioning> Base;
 
-        /// Pull up the annex
-        using Base::m_annex;
-
     public:
 
         /// Constructs a new random annex encoder
@@ -109,6 +106,24 @@ namespace kodo
                 return m_object.m_size;
             }
 
+        /// @return the number of bytes held by the object encoder, i.e.
+        ///         the annex tables and the encoders of all blocks. The
+        ///         object data is owned by the caller
+        uint64_t memory_usage() const
+            {
+                uint64_t usage = sizeof(random_annex_encoder) +
+                    Base::memory_usage() +
+                    m_encoders.capacity() * sizeof(pointer_type);
+
+                for(const auto &encoder : m_encoders)
+                {
+                    assert(encoder);
+                    usage += encoder->memory_usage();
+                }
+
+                return usage;
+            }
+
     protected:
 
         void init_encoder(uint32_t offset, uint32_t size,
@@ -179,12 +194,12 @@ namespace kodo
 
                     uint32_t annex_position = 0;
 
-                    typename std::set<annex_info>::iterator it;
+                    const annex_info *it;
 
-                    for(it = m_annex[i].begin();
-                        it != m_annex[i].end(); ++it)
+                    for(it = Base::annex_begin(i);
+                        it != Base::annex_end(i); ++it)
                     {
-                        annex_info annex = *it;
+                        const annex_info &annex = *it;
 
                         assert(annex.m_coder_id < m_encoders.size());
 
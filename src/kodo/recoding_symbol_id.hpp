@@ -12,6 +12,8 @@
 
 #include <fifi/fifi_utils.hpp>
 
+#include "coder_arena.hpp"
+
 namespace kodo
 {
 
@@ -48,6 +50,14 @@ namespace kodo
                 return SuperCoder::factory::max_coefficients_size();
             }
 
+            /// @copydoc layer::factory::arena_size() const
+            uint32_t arena_size() const
+            {
+                return SuperCoder::factory::arena_size() + 2 *
+                    coder_arena::aligned_size(
+                        SuperCoder::factory::max_coefficients_size());
+            }
+
         };
 
     public:
@@ -58,8 +68,11 @@ namespace kodo
         {
             SuperCoder::construct(the_factory);
 
-            m_coefficients.resize(the_factory.max_coefficients_size());
-            m_recode_id.resize(the_factory.max_coefficients_size());
+            m_coefficients = SuperCoder::arena_allocate(
+                the_factory.max_coefficients_size());
+
+            m_recode_id = SuperCoder::arena_allocate(
+                the_factory.max_coefficients_size());
         }
 
         /// @copydoc layer::initialize(Factory&)
@@ -84,7 +97,7 @@ namespace kodo
             assert(coefficients != 0);
 
             // Zero the symbol id
-            std::fill_n(m_recode_id.begin(), m_id_size, 0);
+            std::fill_n(m_recode_id, m_id_size, 0);
 
             // Prepare the symbol id storage
             sak::mutable_storage id_storage =
@@ -169,17 +182,14 @@ namespace kodo
         /// coding coefficients
         uint32_t m_id_size;
 
-        /// The storage type - we use aligned storage for both buffers
-        /// since if the coefficients are multibyte data types was have
-        /// to ensure the de-referencing the pointers are safe.
-        typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
-        aligned_vector;
-
-        /// Buffer for the recoding coefficients
-        aligned_vector m_coefficients;
+        /// Buffer for the recoding coefficients. Both buffers are
+        /// reserved aligned in the coder arena since if the coefficients
+        /// are multibyte data types we have to ensure the de-referencing
+        /// the pointers are safe.
+        uint8_t *m_coefficients;
 
         /// Buffer for the recoded id
-        aligned_vector m_recode_id;
+        uint8_t *m_recode_id;
     };
 
 }
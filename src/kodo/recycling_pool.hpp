@@ -0,0 +1,217 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include "control_block_slot.hpp"
+
+namespace kodo
+{
+
+    /// @brief Resource pool which does not use the heap once warmed.
+    ///
+    /// Provides the same API as the sak::resource_pool, but the free
+    /// list is a vector of indices which has room for all resources
+    /// and the control blocks of the handed out pointers are placed in
+    /// a control_block_slot of the resource. So only building a new
+    /// resource allocates memory.
+    ///
+    /// Resources handed out may outlive the pool, they are then
+    /// destroyed when released.
+    template<class Value>
+    class recycling_pool : boost::noncopyable
+    {
+    public:
+
+        /// Pointer to a resource
+        typedef boost::shared_ptr<Value> value_ptr;
+
+        /// Function returning a pointer to a new resource allocated
+        /// with new
+        typedef std::function<Value* ()> make_function;
+
+    private:
+
+        /// A resource of the pool
+        struct entry
+        {
+            /// The resource
+            Value *m_value;
+
+            /// The memory of the control block
+            control_block_slot *m_slot;
+
+            /// True if the resource is handed out
+            bool m_in_use;
+        };
+
+        /// The shared state of the pool
+        struct impl : boost::noncopyable
+        {
+            impl(const make_function &make)
+                : m_make(make)
+            { }
+
+            ~impl()
+            {
+                for(uint32_t i = 0; i < m_entries.size(); ++i)
+                {
+                    // The resources in use are destroyed when released
+                    if(!m_entries[i].m_in_use)
+                        delete m_entries[i].m_value;
+
+                    m_entries[i].m_slot->release();
+                }
+            }
+
+            /// Adds a new resource
+            /// @return The index of the resource
+            uint32_t add()
+            {
+                entry e;
+                e.m_value = m_make();
+                e.m_slot = control_block_slot::create();
+                e.m_in_use = false;
+
+                assert(e.m_value);
+
+                m_entries.push_back(e);
+
+                // Make room for all resources so releasing them does
+                // not allocate
+                m_free.reserve(m_entries.size());
+
+                return (uint32_t) m_entries.size() - 1;
+            }
+
+            /// The function building new resources
+            make_function m_make;
+
+            /// The resources
+            std::vector<entry> m_entries;
+
+            /// The indices of the unused resources
+            std::vector<uint32_t> m_free;
+        };
+
+        /// Returns the resource to the pool when the last reference
+        /// is released
+        struct recycler
+        {
+            recycler(const boost::weak_ptr<impl> &pool, uint32_t index)
+                : m_pool(pool),
+                  m_index(index)
+            { }
+
+            void operator()(Value *value)
+            {
+                boost::shared_ptr<impl> pool = m_pool.lock();
+
+                if(pool)
+                {
+                    assert(pool->m_entries[m_index].m_in_use);
+
+                    pool->m_entries[m_index].m_in_use = false;
+                    pool->m_free.push_back(m_index);
+                }
+                else
+                {
+                    delete value;
+                }
+            }
+
+            /// The pool owning the resource
+            boost::weak_ptr<impl> m_pool;
+
+            /// The index of the resource
+            uint32_t m_index;
+        };
+
+    public:
+
+        /// Constructor
+        /// @param make Function building new resources
+        recycling_pool(const make_function &make)
+            : m_pool(boost::make_shared<impl>(make))
+        { }
+
+        /// Hands out an unused resource if one is available, otherwise
+        /// a new resource is built.
+        /// @return Pointer to the resource
+        value_ptr allocate()
+        {
+            uint32_t index;
+
+            if(!m_pool->m_free.empty())
+            {
+                index = m_pool->m_free.back();
+                m_pool->m_free.pop_back();
+            }
+            else
+            {
+                index = m_pool->add();
+            }
+
+            entry &e = m_pool->m_entries[index];
+
+            assert(!e.m_in_use);
+            e.m_in_use = true;
+
+            return value_ptr(e.m_value, recycler(m_pool, index),
+                             control_block_allocator<Value>(e.m_slot));
+        }
+
+        /// @return The number of resources built by the pool
+        uint32_t total_resources() const
+        {
+            return (uint32_t) m_pool->m_entries.size();
+        }
+
+        /// @return The number of resources not handed out
+        uint32_t unused_resources() const
+        {
+            return (uint32_t) m_pool->m_free.size();
+        }
+
+        /// The memory used by the pool, i.e. its bookkeeping, the control
+        /// blocks of the resources and the resources not handed out. The
+        /// resources handed out are accounted for by their users. The
+        /// Value type must provide a memory_usage() function.
+        /// @return The number of bytes used by the pool
+        uint64_t memory_usage() const
+        {
+            const impl &pool = *m_pool;
+
+            uint64_t usage = sizeof(impl) +
+                pool.m_entries.capacity() * sizeof(entry) +
+                pool.m_free.capacity() * sizeof(uint32_t) +
+                pool.m_entries.size() * sizeof(control_block_slot);
+
+            for(uint32_t i = 0; i < pool.m_free.size(); ++i)
+            {
+                usage += pool.m_entries[pool.m_free[i]].m_value->memory_usage();
+            }
+
+            return usage;
+        }
+
+    private:
+
+        /// The shared state of the pool
+        boost::shared_ptr<impl> m_pool;
+    };
+
+}
+
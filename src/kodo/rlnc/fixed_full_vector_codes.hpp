@@ -0,0 +1,102 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#ifndef KODO_RLNC_FIXED_FULL_VECTOR_CODES_HPP
+#define KODO_RLNC_FIXED_FULL_VECTOR_CODES_HPP
+
+#include <cstdint>
+
+#include <fifi/default_field.hpp>
+
+#include "../fixed_storage_block_info.hpp"
+#include "../fixed_coefficient_info.hpp"
+
+#include "full_vector_codes.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC encoder with the number of symbols and the symbol size
+    ///        fixed at compile time.
+    ///
+    /// Produces the same payloads as the full_rlnc_encoder, so it is
+    /// compatible with the full_rlnc_decoder. The factory must be
+    /// constructed with the fixed values.
+    template<class Field, uint32_t Symbols, uint32_t SymbolSize>
+    class fixed_full_rlnc_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               fixed_coefficient_info<
+               // Symbol Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               fixed_storage_block_info<Symbols, SymbolSize,
+               // Finite Field API
+               simd_finite_field_math<
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               fixed_full_rlnc_encoder<Field, Symbols, SymbolSize>
+                   > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC decoder with the number of symbols and the symbol size
+    ///        fixed at compile time.
+    ///
+    /// Decodes the payloads of the full_rlnc_encoder and the
+    /// fixed_full_rlnc_encoder. The factory must be constructed with the
+    /// fixed values.
+    template<class Field, uint32_t Symbols, uint32_t SymbolSize>
+    class fixed_full_rlnc_decoder
+        : public // Payload API
+                 inline_payload_recoder<
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 fixed_coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 fixed_storage_block_info<Symbols, SymbolSize,
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 fixed_full_rlnc_decoder<Field, Symbols, SymbolSize>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+}
+
+#endif
+
@@ -14,6 +14,7 @@
 #include "../final_coder_factory_pool.hpp"
 #include "../final_coder_factory.hpp"
 #include "../finite_field_math.hpp"
+#include "../simd_finite_field_math.hpp"
 #include "../finite_field_info.hpp"
 #include "../zero_symbol_encoder.hpp"
 #include "../systematic_encoder.hpp"
@@ -21,9 +22,12 @@
 #include "../storage_bytes_used.hpp"
 #include "../storage_block_info.hpp"
 #include "../deep_symbol_storage.hpp"
+#include "../lending_symbol_storage.hpp"
 #include "../payload_encoder.hpp"
 #include "../payload_recoder.hpp"
+#include "../inline_payload_recoder.hpp"
 #include "../payload_decoder.hpp"
+#include "../lending_payload_decoder.hpp"
 #include "../symbol_id_encoder.hpp"
 #include "../symbol_id_decoder.hpp"
 #include "../coefficient_storage.hpp"
@@ -32,12 +36,17 @@
 #include "../plain_symbol_id_writer.hpp"
 #include "../uniform_generator.hpp"
 #include "../recoding_symbol_id.hpp"
+#include "../running_combinations.hpp"
+#include "../running_combination_recoder.hpp"
+#include "../store_and_mix_buffer.hpp"
 #include "../proxy_layer.hpp"
 #include "../storage_aware_encoder.hpp"
 #include "../encode_symbol_tracker.hpp"
 
 #include "../linear_block_encoder.hpp"
+#include "../padding_aware_encoder.hpp"
 #include "../linear_block_decoder.hpp"
+#include "../padding_aware_decoder.hpp"
 #include "../linear_block_decoder_delayed.hpp"
 
 namespace kodo
@@ -77,13 +86,14 @@ namespace kodo
                storage_bytes_used<
                storage_block_info<
                // Finite Field API
+               simd_finite_field_math<
                finite_field_math<typename fifi::default_field<Field>::type,
                finite_field_info<Field,
                // Factory API
                final_coder_factory_pool<
                // Final type
                full_rlnc_encoder<Field
-                   > > > > > > > > > > > > > > > > >
+                   > > > > > > > > > > > > > > > > > >
     { };
 
     /// Intermediate stack implementing the recoding functionality of a
@@ -95,6 +105,8 @@ namespace kodo
     /// The only layer specific to recoding is the recoding_symbol_id
     /// layer. Finally the recoder uses a proxy_layer which forwards
     /// any calls not implemented in the recoding stack to the MainStack.
+    /// The decoders below use the inline_payload_recoder instead, which
+    /// produces the same symbols without the proxy_layer indirection.
     template<class MainStack>
     class recoding_stack
         : public // Payload API
@@ -120,12 +132,12 @@ namespace kodo
     ///
     /// This configuration adds the following features (including those
     /// described for the encoder):
-    /// - Recoding using the recoding_stack
+    /// - Recoding using the inline_payload_recoder
     /// - Linear block decoder using Gauss-Jordan elimination.
     template<class Field>
     class full_rlnc_decoder
         : public // Payload API
-                 payload_recoder<recoding_stack,
+                 inline_payload_recoder<
                  payload_decoder<
                  // Codec Header API
                  systematic_decoder<
@@ -143,13 +155,238 @@ namespace kodo
                  storage_bytes_used<
                  storage_block_info<
                  // Finite Field API
+                 simd_finite_field_math<
                  finite_field_math<typename fifi::default_field<Field>::type,
                  finite_field_info<Field,
                  // Factory API
                  final_coder_factory_pool<
                  // Final type
                  full_rlnc_decoder<Field>
-                     > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// Recoding stack emitting the running combinations maintained by
+    /// the running_combinations layer of the MainStack. Compatible with
+    /// the decoders of the recoding_stack, but recoding a symbol only
+    /// copies a combination instead of combining every symbol held.
+    template<class MainStack>
+    class running_recoding_stack
+        : public // Payload API
+                 payload_encoder<
+                 // Codec Header API
+                 non_systematic_encoder<
+                 symbol_id_encoder<
+                 // Symbol ID API
+                 running_combination_recoder<
+                 // Proxy
+                 proxy_layer<
+                 running_recoding_stack<MainStack>, MainStack> > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC decoder recoding from running combinations
+    ///
+    /// Same as the full_rlnc_decoder except that every symbol received
+    /// is mixed into a few running combinations which are emitted by
+    /// recode(). Recoding costs O(symbol_size) per symbol independent of
+    /// the rank, while every symbol received costs one multiply-add per
+    /// combination. The number of combinations and how stale
+    /// combinations are refreshed is set on the factory, see the
+    /// running_combinations layer.
+    template<class Field>
+    class full_rlnc_running_recoding_decoder
+        : public // Payload API
+                 payload_recoder<running_recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 running_combinations<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_running_recoding_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC relay which recodes without decoding
+    ///
+    /// Stores the symbols received as they are using the
+    /// store_and_mix_buffer, instead of eliminating them as the
+    /// full_rlnc_decoder does, and recodes random combinations of them
+    /// using the inline_payload_recoder. The relay cannot return the decoded
+    /// data. The number of symbols stored and whether symbols which are
+    /// not innovative are dropped is set on the factory.
+    template<class Field>
+    class full_rlnc_relay
+        : public // Payload API
+                 inline_payload_recoder<
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 store_and_mix_buffer<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_relay<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC decoder decoding in place in buffers lent by the
+    ///        application.
+    ///
+    /// Same as the full_rlnc_decoder except for the storage. Payloads
+    /// decoded using decode_lent() are kept as the rows of the decoding
+    /// matrix instead of being copied into the symbol storage, the
+    /// buffers are handed back through the release callback once they
+    /// are superseded.
+    template<class Field>
+    class full_rlnc_lending_decoder
+        : public // Payload API
+                 lending_payload_decoder<
+                 inline_payload_recoder<
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 lending_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_lending_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC encoder only spending arithmetics on the bytes used.
+    ///
+    /// Same as the full_rlnc_encoder except that the padding symbols
+    /// following layer::bytes_used() and the unused tail of the last
+    /// symbol are skipped when encoding. The padding must be zero, so
+    /// the stack cannot be used with the random annex coders which
+    /// place symbols of other blocks after the bytes used.
+    template<class Field>
+    class full_rlnc_padding_aware_encoder :
+        public // Payload Codec API
+               payload_encoder<
+               // Codec Header API
+               systematic_encoder<
+               symbol_id_encoder<
+               // Symbol ID API
+               plain_symbol_id_writer<
+               // Coefficient Generator API
+               uniform_generator<
+               // Codec API
+               encode_symbol_tracker<
+               zero_symbol_encoder<
+               padding_aware_encoder<
+               linear_block_encoder<
+               storage_aware_encoder<
+               // Coefficient Storage API
+               coefficient_info<
+               // Symbol Storage API
+               deep_symbol_storage<
+               storage_bytes_used<
+               storage_block_info<
+               // Finite Field API
+               simd_finite_field_math<
+               finite_field_math<typename fifi::default_field<Field>::type,
+               finite_field_info<Field,
+               // Factory API
+               final_coder_factory_pool<
+               // Final type
+               full_rlnc_padding_aware_encoder<Field
+                   > > > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief RLNC decoder treating the padding symbols as decoded.
+    ///
+    /// Same as the full_rlnc_decoder except that the padding symbols
+    /// following layer::bytes_used() are decoded as zero symbols when
+    /// the bytes used are set and are removed from every incoming coded
+    /// symbol. The decoder therefore completes once it has received as
+    /// many symbols as hold data. Compatible with both the
+    /// full_rlnc_encoder and the full_rlnc_padding_aware_encoder.
+    template<class Field>
+    class full_rlnc_padding_aware_decoder
+        : public // Payload API
+                 inline_payload_recoder<
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 padding_aware_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_padding_aware_decoder<Field>
+                     > > > > > > > > > > > > > > > > >
     { };
 
 }
@@ -14,6 +14,7 @@
 #include "../final_coder_factory_pool.hpp"
 #include "../final_coder_factory.hpp"
 #include "../finite_field_math.hpp"
+#include "../simd_finite_field_math.hpp"
 #include "../finite_field_info.hpp"
 #include "../zero_symbol_encoder.hpp"
 #include "../systematic_encoder.hpp"
@@ -31,6 +32,10 @@
 #include "../plain_symbol_id_reader.hpp"
 #include "../seed_symbol_id_writer.hpp"
 #include "../seed_symbol_id_reader.hpp"
+#include "../compact_seed_symbol_id_writer.hpp"
+#include "../compact_seed_symbol_id_reader.hpp"
+#include "../cached_coefficient_generator.hpp"
+#include "../duplicate_seed_decoder.hpp"
 #include "../uniform_generator.hpp"
 #include "../recoding_symbol_id.hpp"
 #include "../proxy_layer.hpp"
@@ -77,13 +82,14 @@ namespace kodo
                  storage_bytes_used<
                  storage_block_info<
                  // Finite Field API
+                 simd_finite_field_math<
                  finite_field_math<typename fifi::default_field<Field>::type,
                  finite_field_info<Field,
                  // Factory API
                  final_coder_factory_pool<
                  // Final type
                  seed_rlnc_encoder<Field>
-                     > > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > > >
     { };
 
     /// @ingroup fec_stacks
@@ -92,16 +98,21 @@ namespace kodo
     /// Adds the following features (including those described for
     /// the encoder):
     /// - Linear block decoder using Gauss-Jordan elimination.
+    /// - Symbols with an already received seed are dropped before
+    ///   any coefficients are generated.
+    /// - Generated coefficients are kept in a bounded LRU cache.
     template<class Field>
     class seed_rlnc_decoder
         : public // Payload API
                  payload_decoder<
                  // Codec Header API
                  systematic_decoder<
+                 duplicate_seed_decoder<
                  symbol_id_decoder<
                  // Symbol ID API
                  seed_symbol_id_reader<
                  // Coefficient Generator API
+                 cached_coefficient_generator<
                  uniform_generator<
                  // Codec API
                  aligned_coefficients_decoder<
@@ -114,13 +125,91 @@ namespace kodo
                  storage_bytes_used<
                  storage_block_info<
                  // Finite Field Math API
+                 simd_finite_field_math<
                  finite_field_math<typename fifi::default_field<Field>::type,
                  finite_field_info<Field,
                  // Factory API
                  final_coder_factory_pool<
                  // Final type
                  seed_rlnc_decoder<Field>
-                     > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Seed based RLNC encoder sending a compact 16 bit id
+    ///        instead of the full generator seed.
+    ///
+    /// The generator seed is derived from the id and a per-generation
+    /// nonce which must be set on both the encoder and the decoder
+    /// using set_seed_nonce(). Otherwise identical to the
+    /// seed_rlnc_encoder.
+    template<class Field>
+    class compact_seed_rlnc_encoder
+        : public // Payload Codec API
+                 payload_encoder<
+                 // Codec Header API
+                 systematic_encoder<
+                 symbol_id_encoder<
+                 // Symbol ID API
+                 compact_seed_symbol_id_writer<uint16_t,
+                 // Coefficient Generator API
+                 uniform_generator<
+                 // Codec API
+                 encode_symbol_tracker<
+                 zero_symbol_encoder<
+                 linear_block_encoder<
+                 storage_aware_encoder<
+                 // Coefficient Storage API
+                 coefficient_info<
+                 // Symbol Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 compact_seed_rlnc_encoder<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+    /// @ingroup fec_stacks
+    /// @brief Decoder matching the compact_seed_rlnc_encoder.
+    template<class Field>
+    class compact_seed_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 duplicate_seed_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 compact_seed_symbol_id_reader<uint16_t,
+                 // Coefficient Generator API
+                 cached_coefficient_generator<
+                 uniform_generator<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field Math API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 compact_seed_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > > > >
     { };
 
 }
@@ -11,6 +11,7 @@
 
 #include "../final_coder_factory_pool.hpp"
 #include "../finite_field_math.hpp"
+#include "../simd_finite_field_math.hpp"
 #include "../finite_field_info.hpp"
 #include "../zero_symbol_encoder.hpp"
 #include "../systematic_encoder.hpp"
@@ -66,13 +67,14 @@ namespace kodo
                  storage_bytes_used<
                  storage_block_info<
                  // Finite Field API
+                 simd_finite_field_math<
                  finite_field_math<typename fifi::default_field<Field>::type,
                  finite_field_info<Field,
                  // Factory API
                  final_coder_factory_pool<
                  // Final type
                  rs_encoder<Field>
-                     > > > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > > > >
     { };
 
     /// @ingroup fec_stacks
@@ -101,13 +103,14 @@ namespace kodo
                  storage_bytes_used<
                  storage_block_info<
                  // Finite Field API
+                 simd_finite_field_math<
                  finite_field_math<typename fifi::default_field<Field>::type,
                  finite_field_info<Field,
                  // Factory API
                  final_coder_factory_pool<
                  // Final type
                  rs_decoder<Field>
-                     > > > > > > > > > > > > > >
+                     > > > > > > > > > > > > > > >
     { };
 
 }
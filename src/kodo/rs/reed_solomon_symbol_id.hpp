@@ -81,6 +81,19 @@ namespace kodo
                 return sizeof(value_type);
             }
 
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                uint64_t usage = SuperCoder::factory::memory_usage();
+
+                for(const auto& m : m_cache)
+                {
+                    usage += m.second->memory_usage();
+                }
+
+                return usage;
+            }
+
         private:
 
             /// map for blocks
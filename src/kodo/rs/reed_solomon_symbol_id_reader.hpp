@@ -46,7 +46,7 @@ namespace kodo
                              m_matrix->row_size());
 
             sak::mutable_storage dest =
-                sak::storage(m_coefficients);
+                sak::storage(m_coefficients, m_matrix->row_size());
 
             sak::copy_storage(dest, src);
 
@@ -40,6 +40,23 @@ namespace kodo
 
     public:
 
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            // Reserve the largest coefficients so initialize does not
+            // allocate
+            m_coefficients.reserve(the_factory.max_coefficients_size());
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() + m_coefficients.capacity();
+        }
+
         /// @copydoc layer::initialize(Factory&)
         template<class Factory>
         void initialize(Factory& the_factory)
@@ -0,0 +1,134 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include <sak/storage.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup symbol_id_layers
+    /// @brief Recodes by emitting the running combinations of the main
+    ///        stack.
+    ///
+    /// Used in the recoding stack of a decoder with the
+    /// running_combinations layer. Replaces the recoding_symbol_id,
+    /// coefficient generator and encoder layers of the recoding_stack:
+    /// the symbol id written is the coding coefficients of the running
+    /// combination selected and the symbol data is copied from it, so a
+    /// recoded symbol costs O(symbol_size) independent of the rank.
+    template<class SuperCoder>
+    class running_combination_recoder : public SuperCoder
+    {
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size)
+            { }
+
+            /// @copydoc layer::factory::max_id_size() const
+            uint32_t max_id_size() const
+            {
+                return SuperCoder::factory::max_coefficients_size();
+            }
+
+        };
+
+    public:
+
+        /// Constructor
+        running_combination_recoder()
+            : m_combination(0)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+            m_combination = 0;
+        }
+
+        /// Writes the coding coefficients of the running combination
+        /// emitted as the symbol id.
+        ///
+        /// @copydoc layer::write_id(uint8_t*, uint8_t**)
+        uint32_t write_id(uint8_t *symbol_id, uint8_t **coefficients)
+        {
+            assert(symbol_id != 0);
+            assert(coefficients != 0);
+
+            m_combination = SuperCoder::next_running_combination();
+
+            uint32_t id_size = SuperCoder::coefficients_size();
+
+            sak::copy_storage(
+                sak::storage(symbol_id, id_size),
+                sak::storage(SuperCoder::running_combination_coefficients(
+                                 m_combination), id_size));
+
+            *coefficients = symbol_id;
+            return id_size;
+        }
+
+        /// Copies the symbol data of the running combination selected by
+        /// write_id().
+        ///
+        /// @copydoc layer::encode_symbol(uint8_t*, uint8_t*)
+        void encode_symbol(uint8_t *symbol_data, uint8_t *coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(coefficients != 0);
+            (void) coefficients;
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            sak::copy_storage(
+                sak::storage(symbol_data, symbol_size),
+                sak::storage(SuperCoder::running_combination_symbol(
+                                 m_combination), symbol_size));
+        }
+
+        /// Copies an uncoded symbol of the main stack.
+        ///
+        /// @copydoc layer::encode_symbol(uint8_t*,uint32_t)
+        void encode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_data != 0);
+            assert(SuperCoder::symbol_pivot(symbol_index));
+            assert(!SuperCoder::symbol_coded(symbol_index));
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            sak::copy_storage(
+                sak::storage(symbol_data, symbol_size),
+                sak::storage(SuperCoder::symbol(symbol_index), symbol_size));
+        }
+
+        /// @copydoc layer::id_size()
+        uint32_t id_size() const
+        {
+            return SuperCoder::coefficients_size();
+        }
+
+    protected:
+
+        /// The running combination being emitted
+        uint32_t m_combination;
+    };
+
+}
+
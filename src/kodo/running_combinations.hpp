@@ -0,0 +1,421 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Maintains a small set of running random combinations of
+    ///        the symbols received by a decoder, allowing recoding in
+    ///        O(symbol_size) per recoded symbol.
+    ///
+    /// The recoding_symbol_id layer combines every symbol held by the
+    /// decoder for each recoded symbol, so a relay pays
+    /// O(rank * symbol_size) per packet. Instead this layer mixes every
+    /// symbol received, before it is decoded, into a number of running
+    /// combinations using random coefficients, and the recoder emits
+    /// the combinations in turn (see running_combination_recoder).
+    ///
+    /// The combination emitted next always contains the latest symbol
+    /// received. A combination emitted twice without receiving a symbol
+    /// in between would be redundant, so before it is emitted again a
+    /// number of randomly chosen decoded rows is mixed into it. The
+    /// number of combinations and refresh rows trade the freshness of
+    /// the recoded symbols against CPU, they are set on the factory.
+    ///
+    /// The layer must be placed above the decoding layer since the
+    /// symbols are mixed before they are eliminated.
+    template<class SuperCoder>
+    class running_combinations : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The random generator used
+        typedef boost::random::mt19937 generator_type;
+
+        /// @copydoc layer::seed_type
+        typedef generator_type::result_type seed_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_running_combinations(2),
+                  m_refresh_rows(1)
+            { }
+
+            /// Sets the number of running combinations of the coders
+            /// built. Every symbol received costs one multiply-add per
+            /// combination, in return more combinations may be emitted
+            /// before they need to be refreshed. The default is 2.
+            /// @param combinations The number of running combinations
+            void set_running_combinations(uint32_t combinations)
+            {
+                assert(combinations > 0);
+                m_running_combinations = combinations;
+            }
+
+            /// @return The number of running combinations
+            uint32_t running_combinations() const
+            {
+                return m_running_combinations;
+            }
+
+            /// Sets the number of decoded rows mixed into a combination
+            /// which is emitted again without receiving a symbol in
+            /// between. Zero disables refreshing, the recoded symbols are
+            /// then redundant once every combination has been emitted
+            /// since the last symbol was received. The default is 1.
+            /// @param rows The number of rows mixed into a combination
+            void set_refresh_rows(uint32_t rows)
+            {
+                m_refresh_rows = rows;
+            }
+
+            /// @return The number of rows mixed into a stale combination
+            uint32_t refresh_rows() const
+            {
+                return m_refresh_rows;
+            }
+
+        private:
+
+            /// The number of running combinations
+            uint32_t m_running_combinations;
+
+            /// The number of rows mixed into a stale combination
+            uint32_t m_refresh_rows;
+        };
+
+    public:
+
+        /// Constructor
+        running_combinations()
+            : m_value_distribution(field_type::min_value,
+                                   field_type::max_value),
+              m_combinations(0),
+              m_refresh_rows(0),
+              m_next(0)
+        { }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_combinations = the_factory.running_combinations();
+            m_refresh_rows = the_factory.refresh_rows();
+            m_next = 0;
+
+            m_symbol_stride = SuperCoder::symbol_length();
+            m_coefficients_stride = SuperCoder::coefficients_length();
+
+            // The same sizes are used when a pooled coder is initialized
+            // again, so this does not allocate in the steady state
+            m_symbols.resize(m_combinations * m_symbol_stride);
+            m_coefficients.resize(m_combinations * m_coefficients_stride);
+            m_stale.resize(m_combinations);
+            m_unit.resize(m_coefficients_stride);
+
+            std::fill(m_symbols.begin(), m_symbols.end(), 0);
+            std::fill(m_coefficients.begin(), m_coefficients.end(), 0);
+            std::fill(m_stale.begin(), m_stale.end(), false);
+            std::fill(m_unit.begin(), m_unit.end(), 0);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                (m_stale.capacity() + 7) / 8 +
+                (m_symbols.capacity() + m_coefficients.capacity() +
+                 m_unit.capacity()) * sizeof(value_type);
+        }
+
+        /// Mixes the symbol into the running combinations unless the
+        /// decoder is complete
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_coefficients != 0);
+
+            if(!SuperCoder::is_complete())
+            {
+                mix_coded(reinterpret_cast<value_type*>(symbol_data),
+                          reinterpret_cast<value_type*>(symbol_coefficients));
+            }
+
+            SuperCoder::decode_symbol(symbol_data, symbol_coefficients);
+        }
+
+        /// Mixes the symbol into the running combinations unless it was
+        /// already decoded
+        /// @copydoc layer::decode_symbol(uint8_t*,uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_index < SuperCoder::symbols());
+
+            if(!SuperCoder::symbol_pivot(symbol_index))
+            {
+                mix_uncoded(reinterpret_cast<value_type*>(symbol_data),
+                            symbol_index);
+            }
+
+            SuperCoder::decode_symbol(symbol_data, symbol_index);
+        }
+
+        /// Selects the running combination to emit next and refreshes it
+        /// if it was already emitted since the last symbol was received.
+        /// @return The index of the running combination
+        uint32_t next_running_combination()
+        {
+            assert(m_combinations > 0);
+
+            uint32_t index = m_next;
+            m_next = (m_next + 1) % m_combinations;
+
+            if(m_stale[index])
+            {
+                refresh(index);
+            }
+
+            m_stale[index] = true;
+            return index;
+        }
+
+        /// @param index The index of a running combination
+        /// @return The symbol data of the running combination
+        const uint8_t* running_combination_symbol(uint32_t index) const
+        {
+            assert(index < m_combinations);
+            return reinterpret_cast<const uint8_t*>(
+                &m_symbols[index * m_symbol_stride]);
+        }
+
+        /// @param index The index of a running combination
+        /// @return The coding coefficients of the running combination
+        const uint8_t* running_combination_coefficients(uint32_t index) const
+        {
+            assert(index < m_combinations);
+            return reinterpret_cast<const uint8_t*>(
+                &m_coefficients[index * m_coefficients_stride]);
+        }
+
+        /// @return The number of running combinations
+        uint32_t running_combination_count() const
+        {
+            return m_combinations;
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            m_random_generator.seed(seed_value);
+        }
+
+    protected:
+
+        /// Mixes a coded symbol into the running combinations
+        /// @param symbol The symbol data
+        /// @param coefficients The coding coefficients of the symbol
+        void mix_coded(const value_type *symbol,
+                       const value_type *coefficients)
+        {
+            for(uint32_t i = 0; i < m_combinations; ++i)
+            {
+                value_type c = coefficient(i);
+
+                if(!c)
+                    continue;
+
+                mix(symbol_value(i), symbol, c,
+                    SuperCoder::symbol_length());
+
+                mix(coefficients_value(i), coefficients, c,
+                    SuperCoder::coefficients_length());
+
+                m_stale[i] = false;
+            }
+        }
+
+        /// Mixes an uncoded symbol into the running combinations
+        /// @param symbol The symbol data
+        /// @param symbol_index The index of the symbol
+        void mix_uncoded(const value_type *symbol, uint32_t symbol_index)
+        {
+            // The coding coefficients of an uncoded symbol are the unit
+            // vector of its index
+            value_type *unit = &m_unit[0];
+
+            fifi::set_value<field_type>(unit, symbol_index, 1U);
+            mix_coded(symbol, unit);
+            fifi::set_value<field_type>(unit, symbol_index, 0U);
+        }
+
+        /// Mixes randomly chosen decoded rows into a running combination
+        /// @param index The index of the running combination
+        void refresh(uint32_t index)
+        {
+            if(SuperCoder::rank() == 0)
+                return;
+
+            uint32_t symbols = SuperCoder::symbols();
+
+            boost::random::uniform_int_distribution<uint32_t>
+                row_distribution(0, symbols - 1);
+
+            for(uint32_t i = 0; i < m_refresh_rows; ++i)
+            {
+                // Find the first pivot from a random position
+                uint32_t row = row_distribution(m_random_generator);
+
+                while(!SuperCoder::symbol_pivot(row))
+                {
+                    row = (row + 1) % symbols;
+                }
+
+                value_type c = nonzero_coefficient();
+
+                mix(symbol_value(index), SuperCoder::symbol_value(row), c,
+                    SuperCoder::symbol_length());
+
+                mix(coefficients_value(index),
+                    SuperCoder::coefficients_value(row), c,
+                    SuperCoder::coefficients_length());
+            }
+        }
+
+        /// Adds the source multiplied by the coefficient to the
+        /// destination
+        /// @param dest The destination buffer
+        /// @param src The source buffer
+        /// @param c The coefficient
+        /// @param length The length of the buffers in value_type elements
+        void mix(value_type *dest, const value_type *src, value_type c,
+                 uint32_t length)
+        {
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::add(dest, src, length);
+            }
+            else
+            {
+                SuperCoder::multiply_add(dest, src, c, length);
+            }
+        }
+
+        /// @param index The index of a running combination
+        /// @return The random coefficient used to mix a received symbol
+        ///         into the running combination. The combination emitted
+        ///         next always receives a non-zero coefficient.
+        value_type coefficient(uint32_t index)
+        {
+            if(index == m_next)
+                return nonzero_coefficient();
+
+            return m_value_distribution(m_random_generator);
+        }
+
+        /// @return A random non-zero coefficient
+        value_type nonzero_coefficient()
+        {
+            value_type c;
+
+            do
+            {
+                c = m_value_distribution(m_random_generator);
+            }
+            while(!c);
+
+            return c;
+        }
+
+        /// @param index The index of a running combination
+        /// @return The symbol data of the running combination
+        value_type* symbol_value(uint32_t index)
+        {
+            return &m_symbols[index * m_symbol_stride];
+        }
+
+        /// @param index The index of a running combination
+        /// @return The coding coefficients of the running combination
+        value_type* coefficients_value(uint32_t index)
+        {
+            return &m_coefficients[index * m_coefficients_stride];
+        }
+
+    protected:
+
+        /// The type of the value_type distribution
+        typedef boost::random::uniform_int_distribution<value_type>
+            value_type_distribution;
+
+        /// Distribution that generates random values from a finite field
+        value_type_distribution m_value_distribution;
+
+        /// The random generator
+        generator_type m_random_generator;
+
+        /// The number of running combinations
+        uint32_t m_combinations;
+
+        /// The number of rows mixed into a stale combination
+        uint32_t m_refresh_rows;
+
+        /// The running combination emitted next
+        uint32_t m_next;
+
+        /// The value_type elements between two combination symbols
+        uint32_t m_symbol_stride;
+
+        /// The value_type elements between two coefficient vectors
+        uint32_t m_coefficients_stride;
+
+        /// The symbol data of the running combinations
+        std::vector<value_type> m_symbols;
+
+        /// The coding coefficients of the running combinations
+        std::vector<value_type> m_coefficients;
+
+        /// True for a combination emitted since it was last updated
+        std::vector<bool> m_stale;
+
+        /// Zero coefficient vector used for the unit vectors of
+        /// uncoded symbols
+        std::vector<value_type> m_unit;
+    };
+
+}
+
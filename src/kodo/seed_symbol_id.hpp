@@ -9,6 +9,7 @@
 #include <cstdint>
 
 #include <fifi/fifi_utils.hpp>
+#include <sak/convert_endian.hpp>
 
 namespace kodo
 {
@@ -60,6 +61,16 @@ namespace kodo
                 return sizeof(seed_type);
             }
 
+        /// Reads the generator seed stored in a symbol id without
+        /// generating any coefficients
+        /// @param symbol_id The buffer containing the symbol id
+        /// @return The seed used to generate the symbol coefficients
+        seed_type read_seed(const uint8_t *symbol_id) const
+            {
+                assert(symbol_id != 0);
+                return sak::big_endian::get<seed_type>(symbol_id);
+            }
+
     };
 
 }
@@ -50,6 +50,12 @@ namespace kodo
 
     public:
 
+        /// Constructor
+        shallow_symbol_storage()
+            : m_symbols_count(0),
+              m_dirty_symbols(0)
+        { }
+
         /// @copydoc layer::construct(Factory&)
         template<class Factory>
         void construct(Factory &the_factory)
@@ -59,13 +65,25 @@ namespace kodo
             m_data.resize(the_factory.max_symbols(), 0);
         }
 
+        /// The symbol data is owned by the caller, only the table of
+        /// symbol pointers is held by the layer
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                m_data.capacity() * sizeof(data_ptr);
+        }
+
         /// @copydoc layer::initialize(uint32_t,uint32_t)
         template<class Factory>
         void initialize(Factory &the_factory)
         {
             SuperCoder::initialize(the_factory);
 
-            std::fill(m_data.begin(), m_data.end(), (data_ptr) 0);
+            // Only the pointers used by the previous block may be set
+            std::fill_n(m_data.begin(), m_dirty_symbols, (data_ptr) 0);
+            m_dirty_symbols = SuperCoder::symbols();
+
             m_symbols_count = 0;
         }
 
@@ -91,6 +109,7 @@ namespace kodo
         {
             assert(m_data.size() == symbols.size());
             m_data.swap(symbols);
+            m_dirty_symbols = m_data.size();
 
             m_symbols_count = 0;
 
@@ -104,15 +123,20 @@ namespace kodo
         /// @copydoc layer::set_symbols()
         void set_symbols(const storage_type &symbol_storage)
         {
-            auto symbol_sequence = sak::split_storage(
-                symbol_storage, SuperCoder::symbol_size());
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            assert(symbol_storage.m_size ==
+                   SuperCoder::symbols() * symbol_size);
 
-            uint32_t sequence_size = symbol_sequence.size();
-            assert(sequence_size == SuperCoder::symbols());
+            // Step through the storage instead of splitting it, which
+            // would allocate
+            storage_type symbol = symbol_storage;
+            symbol.m_size = symbol_size;
 
-            for(uint32_t i = 0; i < sequence_size; ++i)
+            for(uint32_t i = 0; i < SuperCoder::symbols(); ++i)
             {
-                set_symbol(i, symbol_sequence[i]);
+                set_symbol(i, symbol);
+                symbol.m_data += symbol_size;
             }
         }
 
@@ -229,6 +253,10 @@ namespace kodo
         /// Symbols count
         uint32_t m_symbols_count;
 
+        /// The number of symbol pointers which may have been set since
+        /// they were last cleared
+        uint32_t m_dirty_symbols;
+
     };
 
     /// @ingroup symbol_storage_layers
@@ -0,0 +1,314 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <fifi/field_types.hpp>
+
+#include "cpu_features.hpp"
+#include "simd_region_kernels.hpp"
+
+namespace kodo
+{
+
+    /// @ingroup finite_field_layers
+    /// @brief Performs the region operations of the binary and binary8
+    ///        fields using the most capable SIMD kernels of the CPU.
+    ///
+    /// The CPU is probed once per process, see cpu_simd_backend(), and
+    /// the kernels are bound when a coder is initialized. The operations
+    /// of the other fields and layer::invert(value_type) are forwarded to
+    /// the finite_field_math layer below, which must be used with this
+    /// layer. For the binary8 field the factory computes the nibble
+    /// tables of the 256 constants once from the field of the
+    /// finite_field_math layer.
+    template<class SuperCoder>
+    class simd_finite_field_math : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// True if the region operations of the field use the kernels
+        static const bool has_kernels =
+            std::is_same<field_type, fifi::binary>::value ||
+            std::is_same<field_type, fifi::binary8>::value;
+
+        /// The nibble tables of the constants
+        typedef boost::shared_ptr<const std::vector<uint8_t> > tables_pointer;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_backend(cpu_simd_backend())
+            {
+                if(std::is_same<field_type, fifi::binary8>::value)
+                {
+                    auto tables = boost::make_shared<std::vector<uint8_t> >(
+                        256 * 32);
+
+                    for(uint32_t c = 0; c < 256; ++c)
+                    {
+                        for(uint32_t i = 0; i < 16; ++i)
+                        {
+                            (*tables)[c * 32 + i] = (uint8_t)
+                                SuperCoder::factory::m_field->multiply(
+                                    (value_type) c, (value_type) i);
+
+                            (*tables)[c * 32 + 16 + i] = (uint8_t)
+                                SuperCoder::factory::m_field->multiply(
+                                    (value_type) c, (value_type) (i << 4));
+                        }
+                    }
+
+                    m_tables = tables;
+                }
+            }
+
+            /// @return The backend bound to the coders built
+            simd_backend backend() const
+            {
+                return m_backend;
+            }
+
+            /// Selects a less capable backend than the one of the CPU,
+            /// e.g. to compare the backends. Affects the coders
+            /// initialized after the call.
+            /// @param backend The backend, which must be supported by the
+            ///        CPU
+            void set_backend(simd_backend backend)
+            {
+                assert(backend <= cpu_simd_backend());
+                m_backend = backend;
+            }
+
+            /// @copydoc layer::factory::memory_usage() const
+            uint64_t memory_usage() const
+            {
+                uint64_t usage = SuperCoder::factory::memory_usage();
+
+                if(m_tables)
+                    usage += m_tables->capacity();
+
+                return usage;
+            }
+
+        private:
+
+            /// Give the layer access
+            friend class simd_finite_field_math;
+
+            /// @return The nibble tables of the constants
+            tables_pointer tables() const
+            {
+                return m_tables;
+            }
+
+        private:
+
+            /// The backend bound to the coders
+            simd_backend m_backend;
+
+            /// The nibble tables of the constants
+            tables_pointer m_tables;
+        };
+
+    public:
+
+        /// Constructor
+        simd_finite_field_math()
+            : m_backend(simd_scalar),
+              m_kernels(0)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory &the_factory)
+        {
+            SuperCoder::construct(the_factory);
+            m_tables = the_factory.tables();
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_backend = the_factory.backend();
+            m_kernels = &region_kernels(m_backend);
+        }
+
+        /// @return The backend used for the region operations, the
+        ///         fields without kernels report simd_scalar
+        simd_backend backend() const
+        {
+            return has_kernels ? m_backend : simd_scalar;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        void multiply(value_type *symbol_dest, value_type coefficient,
+                      uint32_t symbol_length)
+        {
+            if(!has_kernels)
+            {
+                SuperCoder::multiply(symbol_dest, coefficient, symbol_length);
+                return;
+            }
+
+            assert(m_kernels);
+            assert(symbol_dest != 0);
+            assert(symbol_length > 0);
+
+            if(coefficient == 0)
+            {
+                std::fill_n(symbol_dest, symbol_length, 0);
+            }
+            else if(coefficient != 1)
+            {
+                assert(m_tables);
+                m_kernels->multiply(bytes(symbol_dest),
+                                    &(*m_tables)[coefficient * 32],
+                                    symbol_length);
+            }
+        }
+
+        /// @copydoc layer::multipy_add(value_type *, const value_type*,
+        ///                             value_type, uint32_t)
+        void multiply_add(value_type *symbol_dest,
+                          const value_type *symbol_src,
+                          value_type coefficient, uint32_t symbol_length)
+        {
+            if(!has_kernels)
+            {
+                SuperCoder::multiply_add(symbol_dest, symbol_src,
+                                         coefficient, symbol_length);
+                return;
+            }
+
+            assert(m_kernels);
+            assert(symbol_dest != 0);
+            assert(symbol_src != 0);
+            assert(symbol_length > 0);
+
+            if(coefficient == 1)
+            {
+                m_kernels->add(bytes(symbol_dest), bytes(symbol_src),
+                               symbol_length);
+            }
+            else if(coefficient != 0)
+            {
+                assert(m_tables);
+                m_kernels->multiply_add(bytes(symbol_dest), bytes(symbol_src),
+                                        &(*m_tables)[coefficient * 32],
+                                        symbol_length);
+            }
+        }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type *symbol_dest, const value_type *symbol_src,
+                 uint32_t symbol_length)
+        {
+            if(!has_kernels)
+            {
+                SuperCoder::add(symbol_dest, symbol_src, symbol_length);
+                return;
+            }
+
+            assert(m_kernels);
+            assert(symbol_dest != 0);
+            assert(symbol_src != 0);
+            assert(symbol_length > 0);
+
+            m_kernels->add(bytes(symbol_dest), bytes(symbol_src),
+                           symbol_length);
+        }
+
+        /// In fields of characteristic two subtraction is addition
+        /// @copydoc layer::multiply_subtract(value_type*, const value_type*,
+        ///                                   value_type, uint32_t)
+        void multiply_subtract(value_type *symbol_dest,
+                               const value_type *symbol_src,
+                               value_type coefficient,
+                               uint32_t symbol_length)
+        {
+            if(!has_kernels)
+            {
+                SuperCoder::multiply_subtract(symbol_dest, symbol_src,
+                                              coefficient, symbol_length);
+                return;
+            }
+
+            assert(symbol_dest != symbol_src);
+            multiply_add(symbol_dest, symbol_src, coefficient, symbol_length);
+        }
+
+        /// In fields of characteristic two subtraction is addition
+        /// @copydoc layer::subtract(value_type*,const value_type*, uint32_t)
+        void subtract(value_type *symbol_dest, const value_type *symbol_src,
+                      uint32_t symbol_length)
+        {
+            if(!has_kernels)
+            {
+                SuperCoder::subtract(symbol_dest, symbol_src, symbol_length);
+                return;
+            }
+
+            add(symbol_dest, symbol_src, symbol_length);
+        }
+
+    private:
+
+        /// The kernels are only used with the byte sized value_type of the
+        /// binary and binary8 fields
+        static uint8_t* bytes(value_type *symbol)
+        {
+            return reinterpret_cast<uint8_t*>(symbol);
+        }
+
+        /// @copydoc bytes(value_type*)
+        static const uint8_t* bytes(const value_type *symbol)
+        {
+            return reinterpret_cast<const uint8_t*>(symbol);
+        }
+
+    private:
+
+        /// The backend of the kernels
+        simd_backend m_backend;
+
+        /// The kernels of the backend
+        const simd_region_kernels *m_kernels;
+
+        /// The nibble tables of the constants
+        tables_pointer m_tables;
+    };
+
+    template<class SuperCoder>
+    const bool simd_finite_field_math<SuperCoder>::has_kernels;
+
+}
+
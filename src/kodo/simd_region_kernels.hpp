@@ -0,0 +1,275 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+#include "cpu_features.hpp"
+
+#if defined(KODO_SIMD_X86)
+    #include <immintrin.h>
+    #define KODO_SIMD_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace kodo
+{
+
+    /// @brief Region kernels for fields of characteristic two with byte
+    ///        sized elements.
+    ///
+    /// A multiplication by a constant uses two 16 entry tables holding
+    /// the products of the constant with the low and the high nibble of
+    /// a byte. The 32 bytes of tables of a constant are laid out as the
+    /// low nibble table followed by the high nibble table, which allows
+    /// the SSSE3 and AVX2 kernels to multiply 16 or 32 bytes using two
+    /// shuffles.
+    struct simd_region_kernels
+    {
+        /// Adds the source to the destination
+        void (*add)(uint8_t *dest, const uint8_t *src, uint32_t size);
+
+        /// Adds the source multiplied by a constant to the destination
+        void (*multiply_add)(uint8_t *dest, const uint8_t *src,
+                             const uint8_t *tables, uint32_t size);
+
+        /// Multiplies the destination by a constant
+        void (*multiply)(uint8_t *dest, const uint8_t *tables,
+                         uint32_t size);
+    };
+
+    /// The scalar kernels
+    namespace scalar_kernels
+    {
+        inline void add(uint8_t *dest, const uint8_t *src, uint32_t size)
+        {
+            for(uint32_t i = 0; i < size; ++i)
+                dest[i] ^= src[i];
+        }
+
+        inline void multiply_add(uint8_t *dest, const uint8_t *src,
+                                 const uint8_t *tables, uint32_t size)
+        {
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                dest[i] ^= tables[src[i] & 0x0f] ^ tables[16 + (src[i] >> 4)];
+            }
+        }
+
+        inline void multiply(uint8_t *dest, const uint8_t *tables,
+                             uint32_t size)
+        {
+            for(uint32_t i = 0; i < size; ++i)
+            {
+                dest[i] = tables[dest[i] & 0x0f] ^ tables[16 + (dest[i] >> 4)];
+            }
+        }
+    }
+
+#if defined(KODO_SIMD_X86)
+
+    /// The SSE2 kernels
+    namespace sse2_kernels
+    {
+        KODO_SIMD_TARGET("sse2")
+        inline void add(uint8_t *dest, const uint8_t *src, uint32_t size)
+        {
+            uint32_t i = 0;
+            for(; i + 16 <= size; i += 16)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+                _mm_storeu_si128((__m128i*)(dest + i), _mm_xor_si128(d, s));
+            }
+
+            scalar_kernels::add(dest + i, src + i, size - i);
+        }
+    }
+
+    /// The SSSE3 kernels
+    namespace ssse3_kernels
+    {
+        KODO_SIMD_TARGET("ssse3")
+        inline __m128i multiply(__m128i value, __m128i low, __m128i high)
+        {
+            __m128i mask = _mm_set1_epi8(0x0f);
+            __m128i l = _mm_and_si128(value, mask);
+            __m128i h = _mm_and_si128(_mm_srli_epi64(value, 4), mask);
+
+            return _mm_xor_si128(_mm_shuffle_epi8(low, l),
+                                 _mm_shuffle_epi8(high, h));
+        }
+
+        KODO_SIMD_TARGET("ssse3")
+        inline void multiply_add(uint8_t *dest, const uint8_t *src,
+                                 const uint8_t *tables, uint32_t size)
+        {
+            __m128i low = _mm_loadu_si128((const __m128i*)tables);
+            __m128i high = _mm_loadu_si128((const __m128i*)(tables + 16));
+
+            uint32_t i = 0;
+            for(; i + 16 <= size; i += 16)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i p = multiply(s, low, high);
+                _mm_storeu_si128((__m128i*)(dest + i), _mm_xor_si128(d, p));
+            }
+
+            scalar_kernels::multiply_add(dest + i, src + i, tables, size - i);
+        }
+
+        KODO_SIMD_TARGET("ssse3")
+        inline void multiply(uint8_t *dest, const uint8_t *tables,
+                             uint32_t size)
+        {
+            __m128i low = _mm_loadu_si128((const __m128i*)tables);
+            __m128i high = _mm_loadu_si128((const __m128i*)(tables + 16));
+
+            uint32_t i = 0;
+            for(; i + 16 <= size; i += 16)
+            {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dest + i));
+                _mm_storeu_si128((__m128i*)(dest + i),
+                                 multiply(d, low, high));
+            }
+
+            scalar_kernels::multiply(dest + i, tables, size - i);
+        }
+    }
+
+    /// The AVX2 kernels
+    namespace avx2_kernels
+    {
+        KODO_SIMD_TARGET("avx2")
+        inline void add(uint8_t *dest, const uint8_t *src, uint32_t size)
+        {
+            uint32_t i = 0;
+            for(; i + 32 <= size; i += 32)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+                __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+                _mm256_storeu_si256((__m256i*)(dest + i),
+                                    _mm256_xor_si256(d, s));
+            }
+
+            scalar_kernels::add(dest + i, src + i, size - i);
+        }
+
+        KODO_SIMD_TARGET("avx2")
+        inline __m256i multiply(__m256i value, __m256i low, __m256i high)
+        {
+            __m256i mask = _mm256_set1_epi8(0x0f);
+            __m256i l = _mm256_and_si256(value, mask);
+            __m256i h = _mm256_and_si256(_mm256_srli_epi64(value, 4), mask);
+
+            return _mm256_xor_si256(_mm256_shuffle_epi8(low, l),
+                                    _mm256_shuffle_epi8(high, h));
+        }
+
+        /// The shuffle works on each 128 bit lane, so the tables are
+        /// repeated in both lanes
+        KODO_SIMD_TARGET("avx2")
+        inline __m256i load_table(const uint8_t *table)
+        {
+            return _mm256_broadcastsi128_si256(
+                _mm_loadu_si128((const __m128i*)table));
+        }
+
+        KODO_SIMD_TARGET("avx2")
+        inline void multiply_add(uint8_t *dest, const uint8_t *src,
+                                 const uint8_t *tables, uint32_t size)
+        {
+            __m256i low = load_table(tables);
+            __m256i high = load_table(tables + 16);
+
+            uint32_t i = 0;
+            for(; i + 32 <= size; i += 32)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+                __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+                __m256i p = multiply(s, low, high);
+                _mm256_storeu_si256((__m256i*)(dest + i),
+                                    _mm256_xor_si256(d, p));
+            }
+
+            scalar_kernels::multiply_add(dest + i, src + i, tables, size - i);
+        }
+
+        KODO_SIMD_TARGET("avx2")
+        inline void multiply(uint8_t *dest, const uint8_t *tables,
+                             uint32_t size)
+        {
+            __m256i low = load_table(tables);
+            __m256i high = load_table(tables + 16);
+
+            uint32_t i = 0;
+            for(; i + 32 <= size; i += 32)
+            {
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dest + i));
+                _mm256_storeu_si256((__m256i*)(dest + i),
+                                    multiply(d, low, high));
+            }
+
+            scalar_kernels::multiply(dest + i, tables, size - i);
+        }
+    }
+
+#endif
+
+    /// @param backend The backend, which must be supported by the CPU
+    /// @return The kernels of the backend
+    inline const simd_region_kernels& region_kernels(simd_backend backend)
+    {
+        static const simd_region_kernels scalar =
+            {
+                &scalar_kernels::add,
+                &scalar_kernels::multiply_add,
+                &scalar_kernels::multiply
+            };
+
+#if defined(KODO_SIMD_X86)
+        static const simd_region_kernels sse2 =
+            {
+                &sse2_kernels::add,
+                &scalar_kernels::multiply_add,
+                &scalar_kernels::multiply
+            };
+
+        static const simd_region_kernels ssse3 =
+            {
+                &sse2_kernels::add,
+                &ssse3_kernels::multiply_add,
+                &ssse3_kernels::multiply
+            };
+
+        static const simd_region_kernels avx2 =
+            {
+                &avx2_kernels::add,
+                &avx2_kernels::multiply_add,
+                &avx2_kernels::multiply
+            };
+
+        switch(backend)
+        {
+        case simd_scalar:
+            return scalar;
+        case simd_sse2:
+            return sse2;
+        case simd_ssse3:
+            return ssse3;
+        case simd_avx2:
+            return avx2;
+        }
+#else
+        (void) backend;
+#endif
+
+        return scalar;
+    }
+
+}
+
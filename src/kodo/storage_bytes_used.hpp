@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 
 namespace kodo
@@ -47,6 +48,37 @@ namespace kodo
             return m_bytes_used;
         }
 
+        /// The symbols following the last used byte are zero padding.
+        /// If the bytes used have not been set the entire block is
+        /// considered used.
+        /// @copydoc layer::symbols_used() const
+        uint32_t symbols_used() const
+        {
+            if(m_bytes_used == 0)
+                return SuperCoder::symbols();
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+            return (m_bytes_used + symbol_size - 1) / symbol_size;
+        }
+
+        /// @copydoc layer::symbol_bytes_used(uint32_t) const
+        uint32_t symbol_bytes_used(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+
+            uint32_t symbol_size = SuperCoder::symbol_size();
+
+            if(m_bytes_used == 0)
+                return symbol_size;
+
+            uint32_t offset = index * symbol_size;
+
+            if(offset >= m_bytes_used)
+                return 0;
+
+            return std::min(symbol_size, m_bytes_used - offset);
+        }
+
     private:
 
         /// The number of bytes used
@@ -0,0 +1,411 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+
+#include <sak/storage.hpp>
+
+#include <fifi/is_binary.hpp>
+#include <fifi/fifi_utils.hpp>
+
+namespace kodo
+{
+
+    /// @ingroup codec_layers
+    /// @brief Stores the symbols received by a relay as they are,
+    ///        without decoding them.
+    ///
+    /// Replaces the linear_block_decoder in a relay which only recodes.
+    /// Every symbol received is stored together with its coding
+    /// coefficients in the next free row of the symbol and coefficient
+    /// storage, so no normalization or elimination of the symbol data
+    /// takes place. The stored rows are the pivots seen by the
+    /// recoding_stack, which emits random combinations of them.
+    ///
+    /// The number of rows used is set on the factory. Once they are all
+    /// used a symbol received is mixed into a random row. Optionally a
+    /// rank check drops the symbols which are not innovative, it
+    /// eliminates the coding coefficients only, in a separate matrix.
+    template<class SuperCoder>
+    class store_and_mix_buffer : public SuperCoder
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename SuperCoder::value_type value_type;
+
+        /// The random generator used
+        typedef boost::random::mt19937 generator_type;
+
+        /// @copydoc layer::seed_type
+        typedef generator_type::result_type seed_type;
+
+    public:
+
+        /// @ingroup factory_layers
+        /// The factory layer associated with this coder.
+        class factory : public SuperCoder::factory
+        {
+        public:
+
+            /// @copydoc layer::factory::factory(uint32_t,uint32_t)
+            factory(uint32_t max_symbols, uint32_t max_symbol_size)
+                : SuperCoder::factory(max_symbols, max_symbol_size),
+                  m_buffer_symbols(max_symbols),
+                  m_rank_check(false)
+            { }
+
+            /// Sets the number of symbols stored by the coders built. At
+            /// most symbols() are stored. The default is max_symbols().
+            /// @param buffer_symbols The number of symbols stored
+            void set_buffer_symbols(uint32_t buffer_symbols)
+            {
+                assert(buffer_symbols > 0);
+                m_buffer_symbols = buffer_symbols;
+            }
+
+            /// @return The number of symbols stored
+            uint32_t buffer_symbols() const
+            {
+                return m_buffer_symbols;
+            }
+
+            /// Sets whether the coders built drop the symbols which are
+            /// not innovative. The default is false.
+            /// @param rank_check True if the rank check should be used
+            void set_rank_check(bool rank_check)
+            {
+                m_rank_check = rank_check;
+            }
+
+            /// @return True if the symbols which are not innovative are
+            ///         dropped
+            bool rank_check() const
+            {
+                return m_rank_check;
+            }
+
+        private:
+
+            /// The number of symbols stored
+            uint32_t m_buffer_symbols;
+
+            /// True if the rank check is used
+            bool m_rank_check;
+        };
+
+    public:
+
+        /// Constructor
+        store_and_mix_buffer()
+            : m_value_distribution(field_type::min_value,
+                                   field_type::max_value),
+              m_buffer_symbols(0),
+              m_rank_check(false),
+              m_stored(0),
+              m_received_rank(0)
+        { }
+
+        /// @copydoc layer::construct(Factory&)
+        template<class Factory>
+        void construct(Factory& the_factory)
+        {
+            SuperCoder::construct(the_factory);
+
+            uint32_t max_length =
+                the_factory.max_coefficients_size() / sizeof(value_type);
+
+            m_pivots.resize(the_factory.max_symbols(), false);
+            m_echelon.resize(the_factory.max_symbols() * max_length);
+            m_scratch.resize(max_length);
+            m_unit.resize(max_length);
+        }
+
+        /// @copydoc layer::memory_usage() const
+        uint64_t memory_usage() const
+        {
+            return SuperCoder::memory_usage() +
+                (m_pivots.capacity() + 7) / 8 +
+                (m_echelon.capacity() + m_scratch.capacity() +
+                 m_unit.capacity()) * sizeof(value_type);
+        }
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+
+            m_buffer_symbols = std::min(the_factory.buffer_symbols(),
+                                        the_factory.symbols());
+
+            m_rank_check = the_factory.rank_check();
+            m_stored = 0;
+            m_received_rank = 0;
+
+            std::fill(m_pivots.begin(), m_pivots.end(), false);
+            std::fill(m_unit.begin(), m_unit.end(), 0);
+        }
+
+        /// Stores the symbol unless the rank check finds that it is not
+        /// innovative
+        /// @copydoc layer::decode_symbol(uint8_t*,uint8_t*)
+        void decode_symbol(uint8_t *symbol_data,
+                           uint8_t *symbol_coefficients)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_coefficients != 0);
+
+            const value_type *coefficients =
+                reinterpret_cast<const value_type*>(symbol_coefficients);
+
+            if(m_rank_check && !check_innovative(coefficients))
+                return;
+
+            store_symbol(reinterpret_cast<const value_type*>(symbol_data),
+                         coefficients);
+        }
+
+        /// Stores the uncoded symbol unless the rank check finds that it
+        /// is not innovative
+        /// @copydoc layer::decode_symbol(uint8_t*, uint32_t)
+        void decode_symbol(uint8_t *symbol_data, uint32_t symbol_index)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_index < SuperCoder::symbols());
+
+            // The coding coefficients of an uncoded symbol are the unit
+            // vector of its index
+            value_type *unit = &m_unit[0];
+            fifi::set_value<field_type>(unit, symbol_index, 1U);
+
+            if(!m_rank_check || check_innovative(unit))
+            {
+                store_symbol(
+                    reinterpret_cast<const value_type*>(symbol_data), unit);
+            }
+
+            fifi::set_value<field_type>(unit, symbol_index, 0U);
+        }
+
+        /// @return True if as many symbols as the block holds have been
+        ///         stored. Only with the rank check do they span the
+        ///         block.
+        bool is_complete() const
+        {
+            return m_stored == SuperCoder::symbols();
+        }
+
+        /// @return The number of symbols stored
+        uint32_t rank() const
+        {
+            return m_stored;
+        }
+
+        /// @return True if the row is used by a stored symbol
+        bool symbol_pivot(uint32_t index) const
+        {
+            assert(index < SuperCoder::symbols());
+            return index < m_stored;
+        }
+
+        /// @return True since the stored symbols are coded
+        bool symbol_coded(uint32_t index) const
+        {
+            assert(symbol_pivot(index));
+            (void) index;
+            return true;
+        }
+
+        /// @return The rank of the symbols received if the rank check is
+        ///         used, otherwise zero
+        uint32_t received_rank() const
+        {
+            return m_received_rank;
+        }
+
+        /// @copydoc layer::seed(seed_type)
+        void seed(seed_type seed_value)
+        {
+            m_random_generator.seed(seed_value);
+        }
+
+    protected:
+
+        /// Stores a symbol in the next free row, or mixes it into a
+        /// random row if all rows are used
+        /// @param symbol_data The symbol data
+        /// @param coefficients The coding coefficients of the symbol
+        void store_symbol(const value_type *symbol_data,
+                          const value_type *coefficients)
+        {
+            if(m_stored < m_buffer_symbols)
+            {
+                uint32_t row = m_stored;
+                ++m_stored;
+
+                SuperCoder::set_coefficients(
+                    row, sak::storage(coefficients,
+                                      SuperCoder::coefficients_size()));
+
+                sak::copy_storage(
+                    sak::storage(SuperCoder::symbol(row),
+                                 SuperCoder::symbol_size()),
+                    sak::storage(symbol_data, SuperCoder::symbol_size()));
+
+                return;
+            }
+
+            boost::random::uniform_int_distribution<uint32_t>
+                row_distribution(0, m_stored - 1);
+
+            uint32_t row = row_distribution(m_random_generator);
+            value_type c = nonzero_coefficient();
+
+            if(fifi::is_binary<field_type>::value)
+            {
+                SuperCoder::add(SuperCoder::symbol_value(row), symbol_data,
+                                SuperCoder::symbol_length());
+
+                SuperCoder::add(SuperCoder::coefficients_value(row),
+                                coefficients,
+                                SuperCoder::coefficients_length());
+            }
+            else
+            {
+                SuperCoder::multiply_add(
+                    SuperCoder::symbol_value(row), symbol_data, c,
+                    SuperCoder::symbol_length());
+
+                SuperCoder::multiply_add(
+                    SuperCoder::coefficients_value(row), coefficients, c,
+                    SuperCoder::coefficients_length());
+            }
+        }
+
+        /// Eliminates the coding coefficients against the rows of the
+        /// echelon matrix of the symbols received. An innovative vector
+        /// is normalized and added to the matrix.
+        /// @param coefficients The coding coefficients of a symbol
+        /// @return True if the coefficients are innovative
+        bool check_innovative(const value_type *coefficients)
+        {
+            uint32_t length = SuperCoder::coefficients_length();
+            uint32_t symbols = SuperCoder::symbols();
+
+            value_type *scratch = &m_scratch[0];
+            std::copy(coefficients, coefficients + length, scratch);
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                value_type value = fifi::get_value<field_type>(scratch, i);
+
+                if(!value)
+                    continue;
+
+                if(!m_pivots[i])
+                {
+                    // The coefficients before the pivot are zero
+                    if(!fifi::is_binary<field_type>::value)
+                    {
+                        SuperCoder::multiply(
+                            scratch, SuperCoder::invert(value), length);
+                    }
+
+                    std::copy(scratch, scratch + length, echelon_row(i));
+
+                    m_pivots[i] = true;
+                    ++m_received_rank;
+
+                    return true;
+                }
+
+                if(fifi::is_binary<field_type>::value)
+                {
+                    SuperCoder::subtract(scratch, echelon_row(i), length);
+                }
+                else
+                {
+                    SuperCoder::multiply_subtract(
+                        scratch, echelon_row(i), value, length);
+                }
+            }
+
+            return false;
+        }
+
+        /// @param index The pivot of a row of the echelon matrix
+        /// @return The coding coefficients of the row
+        value_type* echelon_row(uint32_t index)
+        {
+            return &m_echelon[index * SuperCoder::coefficients_length()];
+        }
+
+        /// @return A random non-zero coefficient
+        value_type nonzero_coefficient()
+        {
+            value_type c;
+
+            do
+            {
+                c = m_value_distribution(m_random_generator);
+            }
+            while(!c);
+
+            return c;
+        }
+
+    protected:
+
+        /// The type of the value_type distribution
+        typedef boost::random::uniform_int_distribution<value_type>
+            value_type_distribution;
+
+        /// Distribution that generates random values from a finite field
+        value_type_distribution m_value_distribution;
+
+        /// The random generator
+        generator_type m_random_generator;
+
+        /// The number of rows used to store symbols
+        uint32_t m_buffer_symbols;
+
+        /// True if the symbols which are not innovative are dropped
+        bool m_rank_check;
+
+        /// The number of symbols stored
+        uint32_t m_stored;
+
+        /// The rank of the symbols received, if checked
+        uint32_t m_received_rank;
+
+        /// Tracks the pivots of the echelon matrix
+        std::vector<bool> m_pivots;
+
+        /// The coding coefficients of the symbols received in row
+        /// echelon form
+        std::vector<value_type> m_echelon;
+
+        /// Buffer for the coefficients being eliminated
+        std::vector<value_type> m_scratch;
+
+        /// Zero coefficient vector used for the unit vectors of
+        /// uncoded symbols
+        std::vector<value_type> m_unit;
+    };
+
+}
+
@@ -137,11 +137,45 @@ namespace kodo
 
         /// @return The number of systematically encoded packets produced
         ///         by this encoder
-        void systematic_count()
+        uint32_t systematic_count() const
         {
             return m_systematic_count;
         }
 
+        /// Works like encode(uint8_t*, uint8_t*) but does not copy the
+        /// data of systematic symbols. Instead the returned view refers
+        /// to the symbol in the encoder storage. For non-systematic
+        /// symbols the view refers to the symbol_data buffer.
+        ///
+        /// @copydoc layer::encode_view(uint8_t*, uint8_t*,
+        ///                             sak::const_storage&)
+        uint32_t encode_view(uint8_t *symbol_data, uint8_t *symbol_header,
+                             sak::const_storage &symbol)
+        {
+            assert(symbol_data != 0);
+            assert(symbol_header != 0);
+
+            bool in_systematic_phase =
+                m_systematic_count < SuperCoder::rank();
+
+            if(m_systematic && in_systematic_phase)
+            {
+                write_systematic_header(symbol_header);
+
+                symbol = SuperCoder::encode_symbol_view(m_systematic_count);
+
+                ++m_systematic_count;
+
+                return sizeof(flag_type) + sizeof(counter_type);
+            }
+            else
+            {
+                symbol = sak::storage(symbol_data, SuperCoder::symbol_size());
+
+                return encode_non_systematic(symbol_data, symbol_header);
+            }
+        }
+
 
     protected:
 
@@ -153,6 +187,21 @@ namespace kodo
             assert(symbol_data != 0);
             assert(symbol_header != 0);
 
+            write_systematic_header(symbol_header);
+
+            SuperCoder::encode_symbol(symbol_data, m_systematic_count);
+
+            ++m_systematic_count;
+
+            return sizeof(flag_type) + sizeof(counter_type);
+        }
+
+        /// Writes the header of the next systematic packet
+        /// @param symbol_header The buffer for the header
+        void write_systematic_header(uint8_t *symbol_header)
+        {
+            assert(symbol_header != 0);
+
             /// Flag systematic packet
             sak::big_endian::put<flag_type>(
                 systematic_base_coder::systematic_flag, symbol_header);
@@ -160,12 +209,6 @@ namespace kodo
             /// Set the symbol id
             sak::big_endian::put<counter_type>(
                 m_systematic_count, symbol_header + sizeof(flag_type));
-
-            SuperCoder::encode_symbol(symbol_data, m_systematic_count);
-
-            ++m_systematic_count;
-
-            return sizeof(flag_type) + sizeof(counter_type);
         }
 
         /// Encodes a non-systematic packets
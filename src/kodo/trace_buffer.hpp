@@ -0,0 +1,171 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "trace_clock.hpp"
+#include "trace_event.hpp"
+
+namespace kodo
+{
+
+    /// A trace event as stored in the trace_buffer
+    struct trace_record
+    {
+        /// The trace_clock ticks when the event was written
+        uint64_t m_ticks;
+
+        /// The value of the event, see trace_event
+        uint32_t m_value;
+
+        /// The trace_event::type of the event
+        uint8_t m_event;
+
+        /// Padding to 16 bytes
+        uint8_t m_reserved[3];
+    };
+
+    static_assert(sizeof(trace_record) == 16,
+                  "The trace records are written to the files as is");
+
+    /// A ring buffer of trace events with a single writer. When the
+    /// buffer is full the oldest events are overwritten, so writing
+    /// never blocks or allocates. The writer only updates the head
+    /// index with a release store, which is a plain store on x86,
+    /// while other threads may take a snapshot() of the buffer at
+    /// any time without locking.
+    class trace_buffer : boost::noncopyable
+    {
+    public:
+
+        /// Constructor
+        /// @param capacity The number of events kept, rounded up to a
+        ///        power of two
+        trace_buffer(uint32_t capacity)
+            : m_head(0)
+        {
+            assert(capacity > 0);
+            assert(capacity <= (1U << 31));
+
+            uint64_t size = 1;
+            while(size < capacity)
+            {
+                size <<= 1;
+            }
+
+            m_records.resize(size);
+            m_mask = size - 1;
+        }
+
+        /// Writes an event, must only be called by the writer
+        /// @param event The event
+        /// @param value The value of the event
+        void write(trace_event::type event, uint32_t value)
+        {
+            uint64_t head = m_head.load(std::memory_order_relaxed);
+
+            trace_record &record = m_records[head & m_mask];
+            record.m_ticks = trace_clock::ticks();
+            record.m_value = value;
+            record.m_event = static_cast<uint8_t>(event);
+
+            m_head.store(head + 1, std::memory_order_release);
+        }
+
+        /// Removes all events, must only be called by the writer
+        void clear()
+        {
+            m_head.store(0, std::memory_order_release);
+        }
+
+        /// Copies the events kept in the buffer, oldest first. Events
+        /// overwritten by the writer while copying are left out. Once
+        /// the buffer has wrapped the oldest record is left out as well,
+        /// since the writer may be overwriting it with the next event
+        /// without having moved the head yet. A snapshot of a wrapped
+        /// buffer therefore holds at most capacity() - 1 events, and
+        /// the events overwritten are written() - capacity(), not the
+        /// events written minus the events copied.
+        /// @param records The vector the events are copied to
+        /// @return The number of events written when the snapshot was
+        ///         taken, the last event copied is the one before
+        uint64_t snapshot(std::vector<trace_record> &records) const
+        {
+            uint64_t head = m_head.load(std::memory_order_acquire);
+            uint64_t first = head > capacity() ? head - capacity() : 0;
+
+            records.resize(head - first);
+
+            for(uint64_t i = first; i < head; ++i)
+            {
+                records[i - first] = m_records[i & m_mask];
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // The writer may have overwritten the oldest records and
+            // may be writing the record following the current head
+            uint64_t last = m_head.load(std::memory_order_relaxed) + 1;
+            uint64_t valid = last > capacity() ? last - capacity() : 0;
+
+            if(valid > first)
+            {
+                uint64_t torn = std::min<uint64_t>(valid - first,
+                                                   records.size());
+
+                records.erase(records.begin(), records.begin() + torn);
+            }
+
+            return head;
+        }
+
+        /// @return The number of events kept
+        uint32_t capacity() const
+        {
+            return static_cast<uint32_t>(m_records.size());
+        }
+
+        /// @return The number of events written since the buffer was
+        ///         created or cleared
+        uint64_t written() const
+        {
+            return m_head.load(std::memory_order_acquire);
+        }
+
+        /// @return The number of events which have been overwritten
+        uint64_t dropped() const
+        {
+            uint64_t head = written();
+            return head > capacity() ? head - capacity() : 0;
+        }
+
+        /// @return The number of bytes allocated for the events
+        uint64_t memory_usage() const
+        {
+            return sizeof(trace_buffer) +
+                m_records.capacity() * sizeof(trace_record);
+        }
+
+    private:
+
+        /// The events
+        std::vector<trace_record> m_records;
+
+        /// Maps an event index to its position in m_records
+        uint64_t m_mask;
+
+        /// The index of the next event written
+        std::atomic<uint64_t> m_head;
+    };
+
+}
@@ -0,0 +1,81 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <intrin.h>
+    #define KODO_TRACE_CLOCK_TSC
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <x86intrin.h>
+    #define KODO_TRACE_CLOCK_TSC
+#endif
+
+namespace kodo
+{
+
+    /// The clock used to timestamp the trace events. On x86 the time
+    /// stamp counter is read, which takes a few nanoseconds and is
+    /// constant rate on current processors. On other platforms the
+    /// steady clock is used and a tick is a nanosecond.
+    struct trace_clock
+    {
+        /// @return The current time in ticks
+        static uint64_t ticks()
+        {
+#if defined(KODO_TRACE_CLOCK_TSC)
+            return __rdtsc();
+#else
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        /// The rate of the time stamp counter is measured against the
+        /// steady clock the first time the function is called, which
+        /// takes around 20 milliseconds.
+        /// @return The number of ticks per second
+        static uint64_t ticks_per_second()
+        {
+            static const uint64_t rate = measure_ticks_per_second();
+            return rate;
+        }
+
+    private:
+
+        /// @return The measured number of ticks per second
+        static uint64_t measure_ticks_per_second()
+        {
+#if defined(KODO_TRACE_CLOCK_TSC)
+            typedef std::chrono::steady_clock clock;
+
+            clock::time_point start = clock::now();
+            uint64_t start_ticks = ticks();
+
+            clock::time_point stop;
+
+            do
+            {
+                stop = clock::now();
+            }
+            while(stop - start < std::chrono::milliseconds(20));
+
+            uint64_t stop_ticks = ticks();
+
+            uint64_t nanoseconds =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    stop - start).count();
+
+            return (stop_ticks - start_ticks) * 1000000000ULL / nanoseconds;
+#else
+            return 1000000000ULL;
+#endif
+        }
+    };
+
+}
@@ -0,0 +1,79 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace kodo
+{
+
+    /// The events of the linear_block_decoder which are written to the
+    /// trace_buffer of the decoder_trace layer
+    struct trace_event
+    {
+        enum type
+        {
+            /// The coder was initialized, the value is the number of
+            /// symbols
+            initialized = 0,
+
+            /// A symbol was passed to the decoder, the value is the
+            /// index of an uncoded symbol or trace_event::coded_symbol
+            packet_received,
+
+            /// A pivot was found, the value is the pivot index
+            pivot_found,
+
+            /// The symbol did not increase the rank, the value is the
+            /// index of an uncoded symbol or trace_event::coded_symbol
+            non_innovative,
+
+            /// The rank increased, the value is the new rank
+            rank_changed,
+
+            /// An uncoded symbol replaced a coded symbol, the value is
+            /// the pivot index
+            swap_decode,
+
+            /// The decoder reached full rank, the value is the rank
+            complete,
+
+            /// The number of events
+            event_count
+        };
+
+        /// The value of the events of a coded symbol
+        static const uint32_t coded_symbol = 0xffffffffU;
+
+        /// @param event The trace event
+        /// @return The name of the event
+        static const char* name(type event)
+        {
+            switch(event)
+            {
+            case initialized:
+                return "initialized";
+            case packet_received:
+                return "packet_received";
+            case pivot_found:
+                return "pivot_found";
+            case non_innovative:
+                return "non_innovative";
+            case rank_changed:
+                return "rank_changed";
+            case swap_decode:
+                return "swap_decode";
+            case complete:
+                return "complete";
+            default:
+                assert(0);
+                return "";
+            }
+        }
+    };
+
+}
@@ -0,0 +1,142 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "trace_buffer.hpp"
+#include "trace_clock.hpp"
+
+namespace kodo
+{
+
+    /// The binary file format of the events saved from a trace_buffer.
+    /// The file is a header followed by the trace_record structs in
+    /// the byte order of the machine which wrote them. The trace_dump
+    /// tool prints the file as a timeline.
+    struct trace_file
+    {
+        /// Constructor
+        trace_file()
+            : m_ticks_per_second(0),
+              m_capacity(0),
+              m_written(0)
+        { }
+
+        /// Constructs a file with a snapshot of the events in a buffer
+        /// @param buffer The trace buffer
+        explicit trace_file(const trace_buffer &buffer)
+            : m_ticks_per_second(trace_clock::ticks_per_second()),
+              m_capacity(buffer.capacity()),
+              m_written(0)
+        {
+            m_written = buffer.snapshot(m_records);
+        }
+
+        /// @return The number of events overwritten in the buffer
+        ///         before the snapshot was taken. The snapshot may also
+        ///         leave out the oldest event kept, see
+        ///         trace_buffer::snapshot()
+        uint64_t dropped() const
+        {
+            return m_written > m_capacity ? m_written - m_capacity : 0;
+        }
+
+        /// Writes the file
+        /// @param out The stream the file is written to
+        void write(std::ostream &out) const
+        {
+            header h;
+            std::memcpy(h.m_magic, magic(), sizeof(h.m_magic));
+            h.m_version = version;
+            h.m_record_size = sizeof(trace_record);
+            h.m_ticks_per_second = m_ticks_per_second;
+            h.m_capacity = m_capacity;
+            h.m_written = m_written;
+            h.m_records = m_records.size();
+
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+            if(!m_records.empty())
+            {
+                out.write(reinterpret_cast<const char*>(&m_records[0]),
+                          m_records.size() * sizeof(trace_record));
+            }
+        }
+
+        /// Reads a file
+        /// @param in The stream the file is read from
+        /// @return false if the stream does not hold a trace file of
+        ///         this version
+        bool read(std::istream &in)
+        {
+            header h;
+            in.read(reinterpret_cast<char*>(&h), sizeof(h));
+
+            if(!in || std::memcmp(h.m_magic, magic(), sizeof(h.m_magic)) ||
+               h.m_version != version ||
+               h.m_record_size != sizeof(trace_record))
+            {
+                return false;
+            }
+
+            m_ticks_per_second = h.m_ticks_per_second;
+            m_capacity = h.m_capacity;
+            m_written = h.m_written;
+            m_records.resize(h.m_records);
+
+            if(!m_records.empty())
+            {
+                in.read(reinterpret_cast<char*>(&m_records[0]),
+                        m_records.size() * sizeof(trace_record));
+            }
+
+            return static_cast<bool>(in);
+        }
+
+        /// The trace_clock ticks per second of the machine which wrote
+        /// the events
+        uint64_t m_ticks_per_second;
+
+        /// The number of events the buffer kept
+        uint64_t m_capacity;
+
+        /// The number of events written to the buffer when the snapshot
+        /// was taken
+        uint64_t m_written;
+
+        /// The events, oldest first
+        std::vector<trace_record> m_records;
+
+    private:
+
+        /// The version of the file format
+        static const uint32_t version = 2;
+
+        /// @return The 8 bytes identifying a trace file
+        static const char* magic()
+        {
+            return "KODOTRC\0";
+        }
+
+        /// The header of the file
+        struct header
+        {
+            char m_magic[8];
+            uint32_t m_version;
+            uint32_t m_record_size;
+            uint64_t m_ticks_per_second;
+            uint64_t m_capacity;
+            uint64_t m_written;
+            uint64_t m_records;
+        };
+    };
+
+}
@@ -0,0 +1,498 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_allocation_free.cpp Checks that the codec stacks do not
+///       use the heap once their factories are warmed. The test counts
+///       the allocations by replacing the global allocator, so it is
+///       built as a separate test program
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/rlnc/seed_codes.hpp>
+#include <kodo/rs/reed_solomon_codes.hpp>
+#include <kodo/nocode/carousel_codes.hpp>
+#include <kodo/concurrent_resource_pool.hpp>
+#include <kodo/recycling_pool.hpp>
+#include <kodo/systematic_operations.hpp>
+#include <kodo/rank_callback_decoder.hpp>
+#include <kodo/storage_encoder.hpp>
+#include <kodo/object_decoder.hpp>
+
+#include "../src/basic_api_test_helper.hpp"
+#include "../../benchmark/counting_allocator.hpp"
+
+namespace kodo
+{
+    /// The full_rlnc_decoder with a rank changed callback
+    template<class Field>
+    class rank_callback_rlnc_decoder
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 rank_callback_decoder<
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 rank_callback_rlnc_decoder<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+}
+
+namespace
+{
+
+    /// Buffers used by a block, allocated before the allocations are
+    /// counted
+    struct block_buffers
+    {
+        block_buffers(uint32_t block_size, uint32_t payload_size)
+            : m_data_in(random_vector(block_size)),
+              m_data_out(block_size),
+              m_payload(payload_size),
+              m_recoded(payload_size)
+        { }
+
+        std::vector<uint8_t> m_data_in;
+        std::vector<uint8_t> m_data_out;
+        std::vector<uint8_t> m_payload;
+        std::vector<uint8_t> m_recoded;
+    };
+
+    /// Codes a block using coders built by the factories
+    /// @return The number of allocations made
+    template<class EncoderFactory, class DecoderFactory>
+    uint64_t run_block(EncoderFactory &encoder_factory,
+                       DecoderFactory &decoder_factory,
+                       block_buffers &buffers, bool systematic)
+    {
+        uint64_t before = heap_allocations();
+
+        auto encoder = encoder_factory.build();
+        auto decoder = decoder_factory.build();
+
+        encoder->set_symbols(sak::storage(buffers.m_data_in));
+
+        if(!systematic && kodo::is_systematic_encoder(encoder))
+            kodo::set_systematic_off(encoder);
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&buffers.m_payload[0]);
+            decoder->decode(&buffers.m_payload[0]);
+        }
+
+        decoder->copy_symbols(sak::storage(buffers.m_data_out));
+
+        encoder.reset();
+        decoder.reset();
+
+        return heap_allocations() - before;
+    }
+
+    /// Codes a block through a recoding relay
+    /// @return The number of allocations made
+    template<class EncoderFactory, class RelayFactory, class DecoderFactory>
+    uint64_t run_recoded_block(EncoderFactory &encoder_factory,
+                               RelayFactory &relay_factory,
+                               DecoderFactory &decoder_factory,
+                               block_buffers &buffers)
+    {
+        uint64_t before = heap_allocations();
+
+        auto encoder = encoder_factory.build();
+        auto relay = relay_factory.build();
+        auto decoder = decoder_factory.build();
+
+        encoder->set_symbols(sak::storage(buffers.m_data_in));
+        kodo::set_systematic_off(encoder);
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&buffers.m_payload[0]);
+            relay->decode(&buffers.m_payload[0]);
+
+            relay->recode(&buffers.m_recoded[0]);
+            decoder->decode(&buffers.m_recoded[0]);
+        }
+
+        decoder->copy_symbols(sak::storage(buffers.m_data_out));
+
+        encoder.reset();
+        relay.reset();
+        decoder.reset();
+
+        return heap_allocations() - before;
+    }
+
+    /// Checks that the stacks do not allocate after the first blocks
+    template<class Encoder, class Decoder>
+    void test_stacks(uint32_t symbols, uint32_t symbol_size)
+    {
+        typename Encoder::factory encoder_factory(symbols, symbol_size);
+        typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+        block_buffers buffers(symbols * symbol_size,
+                              std::max(encoder_factory.max_payload_size(),
+                                       decoder_factory.max_payload_size()));
+
+        // Warm the pools and caches
+        for(uint32_t i = 0; i < 3; ++i)
+        {
+            run_block(encoder_factory, decoder_factory, buffers, true);
+            run_block(encoder_factory, decoder_factory, buffers, false);
+        }
+
+        EXPECT_EQ(0U, run_block(encoder_factory, decoder_factory,
+                                buffers, true));
+        EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+
+        EXPECT_EQ(0U, run_block(encoder_factory, decoder_factory,
+                                buffers, false));
+        EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+    }
+
+    /// Checks that recoding does not allocate after the first blocks
+    template<class Encoder, class Relay, class Decoder>
+    void test_recoding(uint32_t symbols, uint32_t symbol_size)
+    {
+        typename Encoder::factory encoder_factory(symbols, symbol_size);
+        typename Relay::factory relay_factory(symbols, symbol_size);
+        typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+        block_buffers buffers(symbols * symbol_size,
+                              relay_factory.max_payload_size());
+
+        for(uint32_t i = 0; i < 3; ++i)
+        {
+            run_recoded_block(encoder_factory, relay_factory,
+                              decoder_factory, buffers);
+        }
+
+        EXPECT_EQ(0U, run_recoded_block(encoder_factory, relay_factory,
+                                        decoder_factory, buffers));
+        EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+    }
+
+}
+
+TEST(TestAllocationFree, full_vector_codes)
+{
+    test_stacks<kodo::full_rlnc_encoder<fifi::binary>,
+                kodo::full_rlnc_decoder<fifi::binary> >(32, 160);
+
+    test_stacks<kodo::full_rlnc_encoder<fifi::binary8>,
+                kodo::full_rlnc_decoder<fifi::binary8> >(32, 160);
+
+    test_stacks<kodo::full_rlnc_encoder<fifi::binary16>,
+                kodo::full_rlnc_decoder<fifi::binary16> >(32, 160);
+
+    test_stacks<kodo::full_rlnc_padding_aware_encoder<fifi::binary8>,
+                kodo::full_rlnc_padding_aware_decoder<fifi::binary8> >(
+                    32, 160);
+
+    test_recoding<kodo::full_rlnc_encoder<fifi::binary8>,
+                  kodo::full_rlnc_decoder<fifi::binary8>,
+                  kodo::full_rlnc_decoder<fifi::binary8> >(32, 160);
+
+    test_recoding<kodo::full_rlnc_encoder<fifi::binary8>,
+                  kodo::full_rlnc_running_recoding_decoder<fifi::binary8>,
+                  kodo::full_rlnc_decoder<fifi::binary8> >(32, 160);
+
+    test_recoding<kodo::full_rlnc_encoder<fifi::binary8>,
+                  kodo::full_rlnc_relay<fifi::binary8>,
+                  kodo::full_rlnc_decoder<fifi::binary8> >(32, 160);
+}
+
+TEST(TestAllocationFree, lending_decoder)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_lending_decoder<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    uint32_t payload_size = decoder_factory.max_payload_size();
+
+    // Enough buffers for the rows lent and the payload being decoded
+    std::vector<std::vector<uint8_t> > storage(
+        symbols + 1, std::vector<uint8_t>(payload_size));
+
+    std::vector<uint8_t*> free_buffers;
+    free_buffers.reserve(storage.size());
+
+    for(auto &buffer : storage)
+        free_buffers.push_back(&buffer[0]);
+
+    block_buffers buffers(symbols * symbol_size, payload_size);
+
+    auto run = [&]() -> uint64_t
+        {
+            uint64_t before = heap_allocations();
+
+            auto encoder = encoder_factory.build();
+            auto decoder = decoder_factory.build();
+
+            decoder->set_release_callback(
+                [&free_buffers](uint8_t *buffer)
+                { free_buffers.push_back(buffer); });
+
+            encoder->set_symbols(sak::storage(buffers.m_data_in));
+            kodo::set_systematic_off(encoder);
+
+            while(!decoder->is_complete())
+            {
+                uint8_t *payload = free_buffers.back();
+                free_buffers.pop_back();
+
+                encoder->encode(payload);
+                decoder->decode_lent(payload);
+            }
+
+            decoder->copy_symbols(sak::storage(buffers.m_data_out));
+            decoder->release_symbols();
+
+            encoder.reset();
+            decoder.reset();
+
+            return heap_allocations() - before;
+        };
+
+    for(uint32_t i = 0; i < 3; ++i)
+        run();
+
+    EXPECT_EQ(0U, run());
+    EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+    EXPECT_EQ(storage.size(), free_buffers.size());
+}
+
+TEST(TestAllocationFree, rank_callback_decoder)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::rank_callback_rlnc_decoder<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    block_buffers buffers(symbols * symbol_size,
+                          decoder_factory.max_payload_size());
+
+    uint32_t rank_changes = 0;
+
+    auto run = [&]() -> uint64_t
+        {
+            uint64_t before = heap_allocations();
+
+            auto encoder = encoder_factory.build();
+            auto decoder = decoder_factory.build();
+
+            // A callback capturing a reference is stored within the
+            // std::function without using the heap
+            decoder->set_rank_changed_callback(
+                [&rank_changes](uint32_t) { ++rank_changes; });
+
+            encoder->set_symbols(sak::storage(buffers.m_data_in));
+            kodo::set_systematic_off(encoder);
+
+            while(!decoder->is_complete())
+            {
+                encoder->encode(&buffers.m_payload[0]);
+                decoder->decode(&buffers.m_payload[0]);
+            }
+
+            decoder->copy_symbols(sak::storage(buffers.m_data_out));
+
+            encoder.reset();
+            decoder.reset();
+
+            return heap_allocations() - before;
+        };
+
+    for(uint32_t i = 0; i < 3; ++i)
+        run();
+
+    rank_changes = 0;
+
+    EXPECT_EQ(0U, run());
+    EXPECT_EQ(symbols, rank_changes);
+    EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+}
+
+TEST(TestAllocationFree, object_coders)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_decoder<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    // The last block is only partially filled
+    uint32_t object_size = 3 * symbols * symbol_size + 1000;
+
+    block_buffers buffers(object_size,
+                          decoder_factory.max_payload_size());
+
+    auto run = [&]() -> uint64_t
+        {
+            uint64_t before = heap_allocations();
+
+            kodo::storage_encoder<encoder_t> object_encoder(
+                encoder_factory, sak::storage(buffers.m_data_in));
+
+            kodo::object_decoder<decoder_t> object_decoder(
+                decoder_factory, object_size);
+
+            uint32_t offset = 0;
+
+            for(uint32_t i = 0; i < object_decoder.decoders(); ++i)
+            {
+                auto encoder = object_encoder.build(i);
+                auto decoder = object_decoder.build(i);
+
+                while(!decoder->is_complete())
+                {
+                    encoder->encode(&buffers.m_payload[0]);
+                    decoder->decode(&buffers.m_payload[0]);
+                }
+
+                decoder->copy_symbols(sak::storage(
+                    &buffers.m_data_out[offset], decoder->bytes_used()));
+
+                offset += decoder->bytes_used();
+            }
+
+            EXPECT_EQ(object_size, offset);
+
+            return heap_allocations() - before;
+        };
+
+    for(uint32_t i = 0; i < 3; ++i)
+        run();
+
+    EXPECT_EQ(0U, run());
+    EXPECT_TRUE(buffers.m_data_in == buffers.m_data_out);
+}
+
+TEST(TestAllocationFree, seed_codes)
+{
+    test_stacks<kodo::seed_rlnc_encoder<fifi::binary8>,
+                kodo::seed_rlnc_decoder<fifi::binary8> >(32, 160);
+
+    test_stacks<kodo::compact_seed_rlnc_encoder<fifi::binary8>,
+                kodo::compact_seed_rlnc_decoder<fifi::binary8> >(32, 160);
+}
+
+TEST(TestAllocationFree, reed_solomon_codes)
+{
+    test_stacks<kodo::rs_encoder<fifi::binary8>,
+                kodo::rs_decoder<fifi::binary8> >(32, 160);
+}
+
+TEST(TestAllocationFree, nocode)
+{
+    test_stacks<kodo::nocode_carousel_encoder,
+                kodo::nocode_carousel_decoder>(32, 160);
+}
+
+TEST(TestAllocationFree, pools)
+{
+    {
+        kodo::recycling_pool<int> pool([]() { return new int(0); });
+
+        {
+            auto a = pool.allocate();
+            auto b = pool.allocate();
+        }
+
+        uint64_t before = heap_allocations();
+        {
+            auto a = pool.allocate();
+            auto b = pool.allocate();
+        }
+        EXPECT_EQ(0U, heap_allocations() - before);
+
+        EXPECT_EQ(2U, pool.total_resources());
+        EXPECT_EQ(2U, pool.unused_resources());
+    }
+
+    {
+        kodo::concurrent_resource_pool<int> pool;
+        auto make = []() { return new int(0); };
+
+        {
+            auto a = pool.allocate(make);
+            auto b = pool.allocate(make);
+        }
+
+        uint64_t before = heap_allocations();
+        {
+            auto a = pool.allocate(make);
+            auto b = pool.allocate(make);
+        }
+        EXPECT_EQ(0U, heap_allocations() - before);
+    }
+}
+
+TEST(TestAllocationFree, pool_lifetime)
+{
+    // A resource handed out may outlive the pool
+    boost::shared_ptr<int> resource;
+    boost::weak_ptr<int> observer;
+
+    {
+        kodo::recycling_pool<int> pool([]() { return new int(42); });
+        resource = pool.allocate();
+        observer = resource;
+    }
+
+    EXPECT_EQ(42, *resource);
+    resource.reset();
+    EXPECT_TRUE(observer.expired());
+
+    // A weak pointer keeps the control block of a released resource
+    // alive, handing out the resource again must not reuse its memory
+    kodo::recycling_pool<int> pool([]() { return new int(1); });
+
+    {
+        auto first = pool.allocate();
+        observer = first;
+    }
+
+    auto second = pool.allocate();
+    EXPECT_EQ(1U, pool.total_resources());
+    EXPECT_TRUE(observer.expired());
+    EXPECT_EQ(1, *second);
+}
+
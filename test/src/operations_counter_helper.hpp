@@ -10,7 +10,7 @@
 /// Helper function which sets all values in the counter
 /// @param counter The counter to be initialized
 /// @param value The value to use for initialization
-inline void set_values(kodo::operations_counter &counter, uint32_t value)
+inline void set_values(kodo::operations_counter &counter, uint64_t value)
 {
     counter.m_multiply = value;
     counter.m_multiply_add = value;
@@ -23,7 +23,7 @@ inline void set_values(kodo::operations_counter &counter, uint32_t value)
 /// Helper function which tests all values in the counter
 /// @param counter The counter to be tested
 /// @param value The value to use for testing
-inline void test_values(kodo::operations_counter &counter, uint32_t value)
+inline void test_values(kodo::operations_counter &counter, uint64_t value)
 {
     EXPECT_EQ(counter.m_multiply, value);
     EXPECT_EQ(counter.m_multiply_add, value);
@@ -41,6 +41,9 @@ void test_cached_symbol_decoder(uint32_t symbols, uint32_t symbol_size)
     EXPECT_EQ(factory.symbol_size(), symbol_size);
     EXPECT_EQ(stack->symbol_size(), symbol_size);
 
+    EXPECT_GE(stack->memory_usage(),
+              uint64_t(symbol_size) + stack->coefficients_size());
+
     std::vector<uint8_t> data_in = random_vector(symbol_size);
     std::vector<uint8_t> coeff_in = random_vector(stack->coefficients_size());
 
@@ -5,11 +5,14 @@
 
 /// @file test_carousel_codes.cpp Unit tests for the carousel nocode scheme
 
+#include <algorithm>
 #include <ctime>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include <kodo/nocode/carousel_codes.hpp>
+#include <kodo/payload_view.hpp>
 
 #include "basic_api_test_helper.hpp"
 
@@ -37,4 +40,62 @@ TEST(TestNoCodeCarouselCodes, basic_api)
     test_coders(symbols, symbol_size);
 }
 
+/// Checks that encode_view() produces the same payloads as encode() and
+/// that the symbol data refers directly to the encoder storage
+TEST(TestNoCodeCarouselCodes, encode_view)
+{
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+
+    kodo::nocode_carousel_encoder::factory encoder_factory(
+        symbols, symbol_size);
+
+    kodo::nocode_carousel_decoder::factory decoder_factory(
+        symbols, symbol_size);
+
+    auto view_encoder = encoder_factory.build();
+    auto copy_encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(view_encoder->block_size());
+
+    view_encoder->set_symbols(sak::storage(data_in));
+    copy_encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> buffer(view_encoder->payload_size());
+    std::vector<uint8_t> payload(view_encoder->payload_size());
+    std::vector<uint8_t> expected(copy_encoder->payload_size());
+
+    // Run past the end of the generation to check the wrap around
+    for(uint32_t i = 0; i < 2 * symbols; ++i)
+    {
+        kodo::payload_view view;
+        uint32_t used = view_encoder->encode_view(&buffer[0], view);
+        uint32_t expected_used = copy_encoder->encode(&expected[0]);
 
+        EXPECT_EQ(expected_used, used);
+        EXPECT_EQ(used, view.m_symbol.m_size + view.m_header.m_size);
+        EXPECT_EQ(view_encoder->symbol_size(), view.m_symbol.m_size);
+        EXPECT_EQ(view_encoder->symbol(i % symbols), view.m_symbol.m_data);
+
+        std::copy(view.m_symbol.m_data,
+                  view.m_symbol.m_data + view.m_symbol.m_size,
+                  payload.begin());
+
+        std::copy(view.m_header.m_data,
+                  view.m_header.m_data + view.m_header.m_size,
+                  payload.begin() + view.m_symbol.m_size);
+
+        EXPECT_TRUE(std::equal(payload.begin(), payload.begin() + used,
+                               expected.begin()));
+
+        decoder->decode(&payload[0]);
+    }
+
+    EXPECT_TRUE(decoder->is_complete());
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
@@ -0,0 +1,108 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_coefficient_cache.cpp Unit tests for the
+///       kodo::coefficient_cache class
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/coefficient_cache.hpp>
+
+TEST(TestCoefficientCache, lru)
+{
+    uint32_t capacity = 3;
+    uint32_t size = 10;
+
+    kodo::coefficient_cache cache(capacity, size);
+
+    EXPECT_EQ(capacity, cache.capacity());
+    EXPECT_EQ(0U, cache.size());
+    EXPECT_TRUE(cache.find(0, size) == 0);
+
+    std::vector<uint8_t> coefficients(size);
+
+    for(uint32_t seed = 0; seed < capacity; ++seed)
+    {
+        std::fill(coefficients.begin(), coefficients.end(), seed);
+        cache.insert(seed, &coefficients[0], size);
+    }
+
+    EXPECT_EQ(capacity, cache.size());
+
+    // Touch seed 0 so seed 1 becomes the least recently used
+    const uint8_t *c = cache.find(0, size);
+    ASSERT_TRUE(c != 0);
+    EXPECT_EQ(0U, c[0]);
+    EXPECT_EQ(0U, c[size - 1]);
+
+    std::fill(coefficients.begin(), coefficients.end(), 42);
+    cache.insert(42, &coefficients[0], size);
+
+    EXPECT_EQ(capacity, cache.size());
+    EXPECT_TRUE(cache.find(1, size) == 0);
+    ASSERT_TRUE(cache.find(0, size) != 0);
+    ASSERT_TRUE(cache.find(2, size) != 0);
+
+    c = cache.find(42, size);
+    ASSERT_TRUE(c != 0);
+    EXPECT_EQ(42U, c[0]);
+    EXPECT_EQ(42U, c[size - 1]);
+
+    // The size is part of the key
+    EXPECT_TRUE(cache.find(42, size - 1) == 0);
+
+    EXPECT_EQ(4U, cache.hits());
+    EXPECT_EQ(3U, cache.misses());
+}
+
+/// All 64 bits of the seed are part of the key
+TEST(TestCoefficientCache, wide_seeds)
+{
+    uint32_t size = 10;
+    kodo::coefficient_cache cache(4, size);
+
+    uint64_t low = 7;
+    uint64_t high = (uint64_t(1) << 40) | low;
+
+    std::vector<uint8_t> coefficients(size, 1);
+    cache.insert(low, &coefficients[0], size);
+
+    EXPECT_TRUE(cache.find(high, size) == 0);
+
+    std::fill(coefficients.begin(), coefficients.end(), 2);
+    cache.insert(high, &coefficients[0], size);
+
+    const uint8_t *c = cache.find(low, size);
+    ASSERT_TRUE(c != 0);
+    EXPECT_EQ(1U, c[0]);
+
+    c = cache.find(high, size);
+    ASSERT_TRUE(c != 0);
+    EXPECT_EQ(2U, c[0]);
+
+    // Evicting every entry empties the lookup table
+    for(uint64_t seed = 100; seed < 104; ++seed)
+    {
+        cache.insert(seed << 33, &coefficients[0], size);
+    }
+
+    EXPECT_TRUE(cache.find(low, size) == 0);
+    EXPECT_TRUE(cache.find(high, size) == 0);
+    EXPECT_TRUE(cache.find(uint64_t(103) << 33, size) != 0);
+}
+
+TEST(TestCoefficientCache, disabled)
+{
+    kodo::coefficient_cache cache(0, 10);
+
+    std::vector<uint8_t> coefficients(10, 1);
+    cache.insert(1, &coefficients[0], 10);
+
+    EXPECT_EQ(0U, cache.size());
+    EXPECT_TRUE(cache.find(1, 10) == 0);
+}
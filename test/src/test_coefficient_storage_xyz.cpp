@@ -202,3 +202,28 @@ TEST(TestSymbolStorage, test_coefficients_storage_stack)
 
 }
 
+
+/// Tests that the coefficient vectors are stored as the 16 byte aligned
+/// rows of one matrix in the coder arena
+TEST(TestSymbolStorage, test_coefficients_storage_arena)
+{
+    typedef kodo::coefficient_storage_stack<fifi::binary8> coder_t;
+
+    uint32_t symbols = 10;
+    uint32_t symbol_size = 100;
+
+    coder_t::factory factory(symbols, symbol_size);
+
+    // 10 coefficients are padded to 16 bytes per row
+    EXPECT_EQ(symbols * 16U, factory.arena_size());
+
+    auto coder = factory.build();
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        const uint8_t *row = coder->coefficients(i);
+
+        EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(row) % 16);
+        EXPECT_EQ(coder->coefficients(0) + i * 16, row);
+    }
+}
@@ -8,6 +8,7 @@
 /// Tests:
 ///   - layer::initialize(uint32_t,uint32_t)
 ///   - layer::decode(const uint8_t*)
+///   - layer::decode(const uint8_t*, const uint8_t*)
 
 #include <cstdint>
 #include <vector>
@@ -160,9 +161,19 @@ void test_stack(uint32_t symbols, uint32_t symbol_size)
 
     auto coder = coder_factory.build();
 
+    // The copy of the payload is held by the coder
+    EXPECT_GE(coder->memory_usage(), coder->payload_size());
+
     std::vector<uint8_t> payload(coder->payload_size(), 'a');
+    std::vector<uint8_t> payload_copy(payload);
 
     coder->decode(&payload[0]);
+
+    // The separate symbol data and header must not be changed either
+    coder->decode(&payload[0], &payload[coder->symbol_size()]);
+
+    EXPECT_TRUE(
+        std::equal(payload.begin(), payload.end(), payload_copy.begin()) );
 }
 
 /// Run the tests
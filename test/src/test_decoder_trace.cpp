@@ -0,0 +1,418 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_decoder_trace.cpp Unit tests for the kodo::decoder_trace
+///       layer and the kodo::trace_buffer
+
+#include <cstdint>
+#include <sstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fifi/field_types.hpp>
+#include <fifi/fifi_utils.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/decoder_trace.hpp>
+#include <kodo/has_decoder_trace.hpp>
+#include <kodo/trace_buffer.hpp>
+#include <kodo/trace_file.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+
+    /// Test layer checking that the decoding matrix is fully reduced
+    /// when the complete event is written to the trace
+    template<class SuperCoder>
+    class check_reduced_at_complete : public SuperCoder
+    {
+    public:
+
+        /// The field type
+        typedef typename SuperCoder::field_type field_type;
+
+        /// The value type
+        typedef typename SuperCoder::value_type value_type;
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory &the_factory)
+        {
+            SuperCoder::initialize(the_factory);
+            m_reduced_at_complete = false;
+        }
+
+        /// Checks the decoding matrix before writing the complete event
+        /// @copydoc decoder_trace::write_trace_event(trace_event::type,
+        ///                                           uint32_t)
+        void write_trace_event(trace_event::type event, uint32_t value)
+        {
+            if(event == trace_event::complete)
+            {
+                m_reduced_at_complete = is_reduced();
+            }
+
+            SuperCoder::write_trace_event(event, value);
+        }
+
+        /// @return True if the decoding matrix was the identity matrix
+        ///         when the complete event was written
+        bool reduced_at_complete() const
+        {
+            return m_reduced_at_complete;
+        }
+
+    private:
+
+        /// @return True if the decoding matrix is the identity matrix
+        bool is_reduced()
+        {
+            uint32_t symbols = SuperCoder::symbols();
+
+            for(uint32_t i = 0; i < symbols; ++i)
+            {
+                const value_type *row = SuperCoder::coefficients_value(i);
+
+                for(uint32_t j = 0; j < symbols; ++j)
+                {
+                    value_type c = fifi::get_value<field_type>(row, j);
+
+                    if(c != (i == j ? 1U : 0U))
+                        return false;
+                }
+            }
+
+            return true;
+        }
+
+    private:
+
+        /// True if the matrix was reduced at the complete event
+        bool m_reduced_at_complete;
+    };
+
+    /// RLNC decoder writing its events to a trace
+    template<class Field>
+    class full_rlnc_decoder_trace
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 check_reduced_at_complete<
+                 decoder_trace<       // <-- Trace layer
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_decoder_trace<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// RLNC decoder with delayed backward substitution writing its
+    /// events to a trace
+    template<class Field>
+    class full_rlnc_decoder_delayed_trace
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder_delayed<
+                 linear_block_decoder<
+                 check_reduced_at_complete<
+                 decoder_trace<       // <-- Trace layer
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_decoder_delayed_trace<Field>
+                     > > > > > > > > > > > > > > > > >
+    { };
+
+}
+
+/// Counts the records of an event
+inline uint32_t count_events(const std::vector<kodo::trace_record> &records,
+                             kodo::trace_event::type event)
+{
+    uint32_t count = 0;
+
+    for(const auto &record : records)
+    {
+        if(record.m_event == event)
+        {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/// Events are kept oldest first and overwritten when the buffer is full
+TEST(TestDecoderTrace, trace_buffer)
+{
+    kodo::trace_buffer buffer(100);
+
+    EXPECT_EQ(128U, buffer.capacity());
+    EXPECT_EQ(0U, buffer.written());
+
+    std::vector<kodo::trace_record> records;
+    buffer.snapshot(records);
+    EXPECT_TRUE(records.empty());
+
+    for(uint32_t i = 0; i < 10; ++i)
+    {
+        buffer.write(kodo::trace_event::rank_changed, i);
+    }
+
+    buffer.snapshot(records);
+    EXPECT_EQ(10U, records.size());
+    EXPECT_EQ(0U, buffer.dropped());
+
+    for(uint32_t i = 0; i < records.size(); ++i)
+    {
+        EXPECT_EQ(kodo::trace_event::rank_changed, records[i].m_event);
+        EXPECT_EQ(i, records[i].m_value);
+
+        if(i > 0)
+        {
+            EXPECT_GE(records[i].m_ticks, records[i-1].m_ticks);
+        }
+    }
+
+    for(uint32_t i = 10; i < 300; ++i)
+    {
+        buffer.write(kodo::trace_event::pivot_found, i);
+    }
+
+    EXPECT_EQ(300U, buffer.written());
+    EXPECT_EQ(172U, buffer.dropped());
+
+    // The snapshot leaves out the oldest record as the writer could
+    // be overwriting it
+    buffer.snapshot(records);
+    ASSERT_EQ(127U, records.size());
+    EXPECT_EQ(173U, records.front().m_value);
+    EXPECT_EQ(299U, records.back().m_value);
+
+    buffer.clear();
+    buffer.snapshot(records);
+    EXPECT_TRUE(records.empty());
+    EXPECT_EQ(0U, buffer.written());
+}
+
+/// A trace file is read back as written
+TEST(TestDecoderTrace, trace_file)
+{
+    kodo::trace_buffer buffer(16);
+    buffer.write(kodo::trace_event::initialized, 8);
+    buffer.write(kodo::trace_event::packet_received,
+                 kodo::trace_event::coded_symbol);
+
+    kodo::trace_file out(buffer);
+    EXPECT_EQ(16U, out.m_capacity);
+    EXPECT_EQ(2U, out.m_written);
+    EXPECT_EQ(0U, out.dropped());
+    EXPECT_GT(out.m_ticks_per_second, 0U);
+
+    std::stringstream stream;
+    out.write(stream);
+
+    kodo::trace_file in;
+    EXPECT_TRUE(in.read(stream));
+
+    EXPECT_EQ(out.m_ticks_per_second, in.m_ticks_per_second);
+    EXPECT_EQ(out.m_capacity, in.m_capacity);
+    EXPECT_EQ(out.m_written, in.m_written);
+    ASSERT_EQ(2U, in.m_records.size());
+
+    for(uint32_t i = 0; i < in.m_records.size(); ++i)
+    {
+        EXPECT_EQ(out.m_records[i].m_ticks, in.m_records[i].m_ticks);
+        EXPECT_EQ(out.m_records[i].m_value, in.m_records[i].m_value);
+        EXPECT_EQ(out.m_records[i].m_event, in.m_records[i].m_event);
+    }
+
+    std::stringstream garbage("not a trace file at all");
+    EXPECT_FALSE(in.read(garbage));
+
+    // Only the events overwritten are dropped, not the oldest event
+    // left out of the snapshot of a wrapped buffer
+    for(uint32_t i = 0; i < 38; ++i)
+    {
+        buffer.write(kodo::trace_event::rank_changed, i);
+    }
+
+    kodo::trace_file wrapped(buffer);
+    EXPECT_EQ(40U, wrapped.m_written);
+    EXPECT_EQ(24U, wrapped.dropped());
+    ASSERT_EQ(15U, wrapped.m_records.size());
+    EXPECT_EQ(23U, wrapped.m_records.front().m_value);
+    EXPECT_EQ(37U, wrapped.m_records.back().m_value);
+}
+
+/// Decodes a block and checks the events written by the decoder
+template<class Decoder>
+void check_decoder_trace(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef typename Decoder::field_type field_type;
+    typedef kodo::full_rlnc_encoder<field_type> encoder_t;
+
+    static_assert(kodo::has_decoder_trace<Decoder>::value,
+                  "The decoder writes a trace");
+
+    static_assert(!kodo::has_decoder_trace<encoder_t>::value,
+                  "The encoder does not write a trace");
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    decoder_factory.set_trace_capacity(1000);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    auto buffer = decoder->get_trace_buffer();
+    EXPECT_EQ(1024U, buffer->capacity());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    // A coded symbol followed by the uncoded symbols leads to a swap
+    kodo::set_systematic_off(encoder);
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    kodo::set_systematic_on(encoder);
+
+    uint32_t packets = 1;
+    uint32_t duplicates = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        std::vector<uint8_t> duplicate = payload;
+
+        decoder->decode(&payload[0]);
+        ++packets;
+
+        if(!decoder->is_complete())
+        {
+            decoder->decode(&duplicate[0]);
+            ++packets;
+            ++duplicates;
+        }
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    std::vector<kodo::trace_record> records;
+    buffer->snapshot(records);
+
+    ASSERT_FALSE(records.empty());
+    EXPECT_EQ(kodo::trace_event::initialized, records.front().m_event);
+    EXPECT_EQ(symbols, records.front().m_value);
+
+    // The decoder is complete once the last symbol is fully processed,
+    // i.e. after the final backward substitution of a delayed decoder
+    ASSERT_GE(records.size(), 2U);
+    EXPECT_EQ(kodo::trace_event::complete, records.back().m_event);
+    EXPECT_EQ(symbols, records.back().m_value);
+    EXPECT_EQ(kodo::trace_event::rank_changed,
+              records[records.size() - 2].m_event);
+    EXPECT_TRUE(decoder->reduced_at_complete());
+
+    EXPECT_EQ(packets,
+              count_events(records, kodo::trace_event::packet_received));
+    EXPECT_EQ(symbols,
+              count_events(records, kodo::trace_event::pivot_found));
+    EXPECT_EQ(1U, count_events(records, kodo::trace_event::complete));
+    EXPECT_GE(count_events(records, kodo::trace_event::swap_decode), 1U);
+    EXPECT_GE(count_events(records, kodo::trace_event::non_innovative),
+              duplicates);
+
+    // The rank increases one by one
+    uint32_t rank = 0;
+
+    for(uint32_t i = 0; i < records.size(); ++i)
+    {
+        if(records[i].m_event == kodo::trace_event::rank_changed)
+        {
+            ++rank;
+            EXPECT_EQ(rank, records[i].m_value);
+        }
+
+        if(i > 0)
+        {
+            EXPECT_GE(records[i].m_ticks, records[i-1].m_ticks);
+        }
+    }
+
+    EXPECT_EQ(symbols, rank);
+
+    // The trace is kept when the decoder is recycled
+    uint64_t written = buffer->written();
+
+    decoder.reset();
+    decoder = decoder_factory.build();
+
+    EXPECT_EQ(buffer, decoder->get_trace_buffer());
+    EXPECT_EQ(written + 1, buffer->written());
+
+    buffer->snapshot(records);
+    EXPECT_EQ(kodo::trace_event::initialized, records.back().m_event);
+
+    EXPECT_GE(decoder->memory_usage(), buffer->memory_usage());
+}
+
+TEST(TestDecoderTrace, decoder_events)
+{
+    check_decoder_trace<kodo::full_rlnc_decoder_trace<fifi::binary> >(
+        16, 160);
+    check_decoder_trace<kodo::full_rlnc_decoder_trace<fifi::binary8> >(
+        16, 160);
+    check_decoder_trace<kodo::full_rlnc_decoder_trace<fifi::binary16> >(
+        16, 160);
+
+    check_decoder_trace<
+        kodo::full_rlnc_decoder_delayed_trace<fifi::binary8> >(16, 160);
+}
@@ -0,0 +1,315 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_final_coder_factory_concurrent_pool.cpp Unit tests for the
+///       concurrent coder pool
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/final_coder_factory_concurrent_pool.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+
+    /// RLNC encoder using the concurrent coder pool
+    template<class Field>
+    class full_rlnc_encoder_concurrent
+        : public // Payload Codec API
+                 payload_encoder<
+                 // Codec Header API
+                 systematic_encoder<
+                 symbol_id_encoder<
+                 // Symbol ID API
+                 plain_symbol_id_writer<
+                 // Coefficient Generator API
+                 uniform_generator<
+                 // Codec API
+                 encode_symbol_tracker<
+                 zero_symbol_encoder<
+                 linear_block_encoder<
+                 storage_aware_encoder<
+                 // Coefficient Storage API
+                 coefficient_info<
+                 // Symbol Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_concurrent_pool<
+                 // Final type
+                 full_rlnc_encoder_concurrent<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+    /// RLNC decoder using the concurrent coder pool
+    template<class Field>
+    class full_rlnc_decoder_concurrent
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field Math API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_concurrent_pool<
+                 // Final type
+                 full_rlnc_decoder_concurrent<Field>
+                     > > > > > > > > > > > > > >
+    { };
+
+    /// RLNC decoder with a recoding stack using the concurrent coder pool
+    template<class Field>
+    class full_rlnc_recoding_decoder_concurrent
+        : public // Payload API
+                 payload_recoder<recoding_stack,
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field Math API
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_concurrent_pool<
+                 // Final type
+                 full_rlnc_recoding_decoder_concurrent<Field>
+                     > > > > > > > > > > > > > > >
+    { };
+
+}
+
+TEST(TestFinalCoderFactoryConcurrentPool, basic_api)
+{
+    invoke_basic_api
+        <
+            kodo::full_rlnc_encoder_concurrent<fifi::binary8>,
+            kodo::full_rlnc_decoder_concurrent<fifi::binary8>
+            >(32, 160);
+}
+
+TEST(TestFinalCoderFactoryConcurrentPool, statistics)
+{
+    typedef kodo::full_rlnc_encoder_concurrent<fifi::binary8> encoder_t;
+
+    encoder_t::factory factory(16, 160);
+
+    {
+        auto e1 = factory.build();
+        auto e2 = factory.build();
+
+        kodo::concurrent_pool_statistics stats = factory.pool_statistics();
+        EXPECT_EQ(2U, stats.m_allocated);
+        EXPECT_EQ(0U, stats.m_reused);
+        EXPECT_EQ(2U, stats.m_in_use);
+        EXPECT_EQ(2U, stats.m_high_water);
+    }
+
+    auto e3 = factory.build();
+
+    kodo::concurrent_pool_statistics stats = factory.pool_statistics();
+    EXPECT_EQ(2U, stats.m_allocated);
+    EXPECT_EQ(1U, stats.m_reused);
+    EXPECT_EQ(1U, stats.m_in_use);
+    EXPECT_EQ(2U, stats.m_high_water);
+}
+
+/// Builds, uses and releases coders from one factory on several threads.
+/// Half of the coders are released by a different thread than the one
+/// which built them.
+TEST(TestFinalCoderFactoryConcurrentPool, threads)
+{
+    typedef kodo::full_rlnc_encoder_concurrent<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_decoder_concurrent<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    const uint32_t threads = 4;
+    const uint32_t iterations = 200;
+
+    std::vector<uint32_t> failures(threads, 0);
+    std::vector< std::vector<decoder_t::pointer> > handover(threads);
+
+    auto worker = [&](uint32_t id)
+    {
+        std::vector<uint8_t> data(symbols * symbol_size);
+        std::vector<uint8_t> out(data.size());
+
+        for(uint32_t i = 0; i < iterations; ++i)
+        {
+            for(auto &d : data)
+                d = uint8_t(i + id);
+
+            auto encoder = encoder_factory.build();
+            auto decoder = decoder_factory.build();
+
+            encoder->set_symbols(sak::storage(data));
+            std::vector<uint8_t> payload(encoder->payload_size());
+
+            while(!decoder->is_complete())
+            {
+                encoder->encode(&payload[0]);
+                decoder->decode(&payload[0]);
+            }
+
+            decoder->copy_symbols(sak::storage(out));
+
+            if(out != data)
+                ++failures[id];
+
+            // Released by the next thread when it finishes
+            if(i % 2 == 0)
+                handover[id].push_back(decoder);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(uint32_t i = 0; i < threads; ++i)
+        workers.push_back(std::thread(worker, i));
+
+    for(auto &w : workers)
+        w.join();
+
+    for(uint32_t i = 0; i < threads; ++i)
+        EXPECT_EQ(0U, failures[i]);
+
+    kodo::concurrent_pool_statistics stats =
+        decoder_factory.pool_statistics();
+
+    EXPECT_EQ(threads * iterations / 2, stats.m_in_use);
+    EXPECT_EQ(uint64_t(threads * iterations),
+              stats.m_allocated + stats.m_reused);
+
+    std::vector<std::thread> releasers;
+    for(uint32_t i = 0; i < threads; ++i)
+    {
+        releasers.push_back(std::thread(
+            [&handover, i, threads]() {
+                handover[(i + 1) % threads].clear();
+            }));
+    }
+
+    for(auto &r : releasers)
+        r.join();
+
+    stats = decoder_factory.pool_statistics();
+    EXPECT_EQ(0U, stats.m_in_use);
+    EXPECT_GE(stats.m_high_water, threads * iterations / 2);
+
+    // The released coders are recycled
+    auto decoder = decoder_factory.build();
+    EXPECT_EQ(stats.m_allocated,
+              decoder_factory.pool_statistics().m_allocated);
+}
+
+/// Builds recoding decoders from one factory on several threads. The
+/// recoding stacks are built from the factory shared by the coders.
+TEST(TestFinalCoderFactoryConcurrentPool, recoding_threads)
+{
+    typedef kodo::full_rlnc_encoder_concurrent<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_recoding_decoder_concurrent<fifi::binary8>
+        recoder_t;
+    typedef kodo::full_rlnc_decoder_concurrent<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 8;
+    uint32_t symbol_size = 64;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    recoder_t::factory recoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    const uint32_t threads = 4;
+    const uint32_t iterations = 50;
+
+    std::vector<uint32_t> failures(threads, 0);
+
+    auto worker = [&](uint32_t id)
+    {
+        std::vector<uint8_t> data(symbols * symbol_size);
+        std::vector<uint8_t> out(data.size());
+
+        for(uint32_t i = 0; i < iterations; ++i)
+        {
+            for(auto &d : data)
+                d = uint8_t(i * id + 1);
+
+            auto encoder = encoder_factory.build();
+            auto recoder = recoder_factory.build();
+            auto decoder = decoder_factory.build();
+
+            encoder->set_symbols(sak::storage(data));
+            std::vector<uint8_t> payload(encoder->payload_size());
+
+            while(!recoder->is_complete())
+            {
+                encoder->encode(&payload[0]);
+                recoder->decode(&payload[0]);
+            }
+
+            // The decoder only receives symbols recoded by the recoder
+            std::vector<uint8_t> recoded(recoder->payload_size());
+
+            while(!decoder->is_complete())
+            {
+                recoder->recode(&recoded[0]);
+                decoder->decode(&recoded[0]);
+            }
+
+            decoder->copy_symbols(sak::storage(out));
+
+            if(out != data)
+                ++failures[id];
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(uint32_t i = 0; i < threads; ++i)
+        workers.push_back(std::thread(worker, i));
+
+    for(auto &w : workers)
+        w.join();
+
+    for(uint32_t i = 0; i < threads; ++i)
+        EXPECT_EQ(0U, failures[i]);
+}
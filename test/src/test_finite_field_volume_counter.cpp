@@ -0,0 +1,339 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_finite_field_volume_counter.cpp Unit tests for the
+///       kodo::finite_field_volume_counter class
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fifi/field_types.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/finite_field_counter.hpp>
+#include <kodo/finite_field_volume_counter.hpp>
+#include <kodo/has_finite_field_volume_counter.hpp>
+#include <kodo/operations_buffer_scope.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+
+    // Dummy class to provide needed API
+    template<class Field>
+    class dummy_volume_finite_field
+    {
+    public:
+
+        /// @copydoc layer::field_type
+        typedef Field field_type;
+
+        /// @copydoc layer::value_type
+        typedef typename field_type::value_type value_type;
+
+    public:
+
+        /// Dummy factory
+        struct factory
+        { };
+
+    public:
+
+        /// @copydoc layer::initialize(Factory&)
+        template<class Factory>
+        void initialize(Factory& the_factory)
+        {
+            (void) the_factory;
+        }
+
+        /// @copydoc layer::multiply(value_type*,value_type,uint32_t)
+        void multiply(value_type*, value_type, uint32_t)
+        { }
+
+        /// @copydoc layer::multipy_add(value_type *, const value_type*,
+        ///                             value_type, uint32_t)
+        void multiply_add(value_type*, const value_type*, value_type,
+                          uint32_t)
+        { }
+
+        /// @copydoc layer::add(value_type*, const value_type *, uint32_t)
+        void add(value_type*, const value_type*, uint32_t)
+        { }
+
+        /// @copydoc layer::multiply_subtract(
+        ///              value_type*, const value_type*,
+        ///              value_type, uint32_t)
+        void multiply_subtract(value_type*, const value_type*, value_type,
+                               uint32_t)
+        { }
+
+        /// @copydoc layer::subtract(
+        ///              value_type*,const value_type*, uint32_t)
+        void subtract(value_type*, const value_type*, uint32_t)
+        { }
+
+        /// @copydoc layer::invert(value_type)
+        value_type invert(value_type value)
+        {
+            return value;
+        }
+
+    };
+
+    /// Dummy stack including the finite field volume counter
+    template<class Field>
+    class volume_counter_test_stack :
+        public finite_field_volume_counter<
+               dummy_volume_finite_field<Field> >
+    { };
+
+    /// RLNC decoder counting the operations
+    template<class Field>
+    class full_rlnc_decoder_volume
+        : public // Payload API
+                 payload_decoder<
+                 // Codec Header API
+                 systematic_decoder<
+                 symbol_id_decoder<
+                 // Symbol ID API
+                 plain_symbol_id_reader<
+                 // Codec API
+                 aligned_coefficients_decoder<
+                 linear_block_decoder<
+                 // Coefficient Storage API
+                 coefficient_storage<
+                 coefficient_info<
+                 // Storage API
+                 deep_symbol_storage<
+                 storage_bytes_used<
+                 storage_block_info<
+                 // Finite Field API
+                 finite_field_volume_counter<
+                 finite_field_counter<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 // Factory API
+                 final_coder_factory_pool<
+                 // Final type
+                 full_rlnc_decoder_volume<Field>
+                     > > > > > > > > > > > > > > > >
+    { };
+
+}
+
+/// The operations are counted per buffer and per phase
+TEST(TestFiniteFieldVolumeCounter, invoke_counters)
+{
+    typedef kodo::volume_counter_test_stack<fifi::binary8> stack_type;
+    typedef kodo::operations_volume volume;
+
+    stack_type stack;
+    stack_type::factory factory;
+
+    stack.initialize(factory);
+
+    EXPECT_EQ(kodo::decoder_phase::other, stack.current_decoder_phase());
+    EXPECT_EQ(volume::symbol_data, stack.current_operations_buffer());
+
+    uint8_t *dummy_ptr = 0;
+
+    stack.multiply_add(dummy_ptr, dummy_ptr, 1, 100);
+
+    {
+        kodo::operations_buffer_scope<stack_type> buffer(
+            stack, volume::coefficients);
+
+        EXPECT_EQ(volume::coefficients, stack.current_operations_buffer());
+        stack.multiply(dummy_ptr, 1, 16);
+    }
+
+    EXPECT_EQ(volume::symbol_data, stack.current_operations_buffer());
+
+    stack.set_decoder_phase(kodo::decoder_phase::backward_substitution);
+
+    // The buffer is marked, not told apart by the length
+    stack.set_operations_buffer(volume::coefficients);
+    stack.multiply_subtract(dummy_ptr, dummy_ptr, 1, 16);
+
+    stack.set_operations_buffer(volume::symbol_data);
+    stack.multiply_subtract(dummy_ptr, dummy_ptr, 1, 100);
+    stack.multiply_subtract(dummy_ptr, dummy_ptr, 1, 16);
+    stack.invert(1);
+
+    const volume& v = stack.get_operations_volume();
+
+    EXPECT_EQ(1U, v.operation_calls(volume::multiply_add));
+    EXPECT_EQ(100U, v.operation_bytes(volume::multiply_add));
+    EXPECT_EQ(3U, v.operation_calls(volume::multiply_subtract));
+    EXPECT_EQ(132U, v.operation_bytes(volume::multiply_subtract));
+    EXPECT_EQ(0U, v.operation_calls(volume::add));
+
+    EXPECT_EQ(2U, v.buffer_calls(volume::coefficients));
+    EXPECT_EQ(32U, v.buffer_bytes(volume::coefficients));
+    EXPECT_EQ(3U, v.buffer_calls(volume::symbol_data));
+    EXPECT_EQ(216U, v.buffer_bytes(volume::symbol_data));
+
+    EXPECT_EQ(116U, v.phase_bytes(kodo::decoder_phase::other));
+    EXPECT_EQ(3U, v.phase_calls(kodo::decoder_phase::backward_substitution));
+    EXPECT_EQ(132U, v.phase_bytes(kodo::decoder_phase::backward_substitution));
+    EXPECT_EQ(0U, v.phase_bytes(kodo::decoder_phase::normalization));
+
+    EXPECT_EQ(1U, v.inverts());
+    EXPECT_EQ(248U, v.total_bytes());
+
+    stack.reset_operations_volume();
+    EXPECT_EQ(0U, stack.get_operations_volume().total_bytes());
+
+    stack.add(dummy_ptr, dummy_ptr, 100);
+    EXPECT_EQ(100U, stack.get_operations_volume().total_bytes());
+
+    stack.initialize(factory);
+
+    EXPECT_EQ(0U, stack.get_operations_volume().total_bytes());
+    EXPECT_EQ(kodo::decoder_phase::other, stack.current_decoder_phase());
+    EXPECT_EQ(volume::symbol_data, stack.current_operations_buffer());
+}
+
+/// Checks that the operations of a decoder are all counted
+template<class Decoder>
+void check_volume_totals(Decoder& decoder)
+{
+    typedef kodo::operations_volume volume;
+
+    const volume& v = decoder->get_operations_volume();
+    kodo::operations_counter counter = decoder->get_operations_counter();
+
+    // Every call is counted in one phase and buffer
+    EXPECT_EQ(counter.m_multiply, v.operation_calls(volume::multiply));
+    EXPECT_EQ(counter.m_subtract, v.operation_calls(volume::subtract));
+    EXPECT_EQ(counter.m_multiply_subtract,
+              v.operation_calls(volume::multiply_subtract));
+    EXPECT_EQ(counter.m_invert, v.inverts());
+
+    uint64_t calls = 0;
+    uint64_t bytes = 0;
+
+    for(uint32_t p = 0; p < kodo::decoder_phase::phase_count; ++p)
+    {
+        auto phase = static_cast<kodo::decoder_phase::type>(p);
+        calls += v.phase_calls(phase);
+        bytes += v.phase_bytes(phase);
+    }
+
+    EXPECT_EQ(v.buffer_calls(volume::coefficients) +
+              v.buffer_calls(volume::symbol_data), calls);
+    EXPECT_EQ(v.total_bytes(), bytes);
+
+    // The decoder performs all the operations while decoding
+    EXPECT_EQ(0U, v.phase_calls(kodo::decoder_phase::other));
+
+    // The buffers are processed a symbol or a coefficient vector at
+    // a time
+    EXPECT_EQ(v.buffer_calls(volume::symbol_data) * decoder->symbol_size(),
+              v.buffer_bytes(volume::symbol_data));
+
+    EXPECT_EQ(v.buffer_calls(volume::coefficients) *
+              decoder->coefficients_size(),
+              v.buffer_bytes(volume::coefficients));
+}
+
+/// Checks the phases of the operations performed by the decoder
+template<class Field>
+void check_decoder_volume(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::full_rlnc_decoder_volume<Field> decoder_t;
+
+    static_assert(kodo::has_finite_field_volume_counter<decoder_t>::value,
+                  "The decoder counts the operations");
+
+    static_assert(!kodo::has_finite_field_volume_counter<encoder_t>::value,
+                  "The encoder does not count the operations");
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    // Only coded symbols, the decoder does not swap
+    kodo::set_systematic_off(encoder);
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    check_volume_totals(decoder);
+
+    const kodo::operations_volume& v = decoder->get_operations_volume();
+
+    EXPECT_GT(v.phase_calls(kodo::decoder_phase::forward_substitution), 0U);
+    EXPECT_GT(v.phase_calls(kodo::decoder_phase::backward_substitution), 0U);
+    EXPECT_EQ(0U, v.phase_calls(kodo::decoder_phase::swap_decoding));
+
+    // Every operation on a symbol is repeated on its coefficients
+    EXPECT_EQ(v.buffer_calls(kodo::operations_volume::symbol_data),
+              v.buffer_calls(kodo::operations_volume::coefficients));
+
+    if(fifi::is_binary<Field>::value)
+    {
+        EXPECT_EQ(0U, v.phase_calls(kodo::decoder_phase::normalization));
+        EXPECT_EQ(0U, v.inverts());
+    }
+    else
+    {
+        // Every pivot found normalizes the coefficients and the symbol
+        EXPECT_EQ(symbols, v.inverts());
+        EXPECT_EQ(2 * symbols,
+                  v.phase_calls(kodo::decoder_phase::normalization));
+    }
+
+    // A coded symbol followed by the uncoded symbols leads to a swap
+    decoder = decoder_factory.build();
+    EXPECT_EQ(0U, decoder->get_operations_volume().total_bytes());
+
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    kodo::set_systematic_on(encoder);
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    check_volume_totals(decoder);
+
+    EXPECT_GT(decoder->get_operations_volume().phase_calls(
+                  kodo::decoder_phase::swap_decoding), 0U);
+}
+
+TEST(TestFiniteFieldVolumeCounter, decoder_phases)
+{
+    check_decoder_volume<fifi::binary>(16, 160);
+    check_decoder_volume<fifi::binary8>(16, 160);
+    check_decoder_volume<fifi::binary16>(16, 160);
+
+    // The coefficients and symbols have the same size
+    check_decoder_volume<fifi::binary8>(16, 16);
+}
@@ -0,0 +1,206 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_fixed_geometry.cpp Unit tests for the fixed geometry
+///       stacks and the geometry registry
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+#include <kodo/rlnc/fixed_full_vector_codes.hpp>
+#include <kodo/polymorphic_coder.hpp>
+#include <kodo/geometry_registry.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace
+{
+
+    /// Encodes a random block with the encoder and decodes it with the
+    /// decoder
+    template<class Encoder, class Decoder>
+    void run_round_trip(Encoder &encoder, Decoder &decoder)
+    {
+        EXPECT_EQ(encoder->symbols(), decoder->symbols());
+        EXPECT_EQ(encoder->symbol_size(), decoder->symbol_size());
+        EXPECT_EQ(encoder->payload_size(), decoder->payload_size());
+
+        std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+        encoder->set_symbols(sak::storage(data_in));
+
+        std::vector<uint8_t> payload(encoder->payload_size());
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&payload[0]);
+            decoder->decode(&payload[0]);
+        }
+
+        std::vector<uint8_t> data_out(decoder->block_size());
+        decoder->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(data_in == data_out);
+    }
+
+    /// Checks that the fixed stacks interoperate with the generic
+    /// stacks
+    template<class Field, uint32_t Symbols, uint32_t SymbolSize>
+    void test_fixed_stacks()
+    {
+        typedef kodo::fixed_full_rlnc_encoder<Field, Symbols, SymbolSize>
+            fixed_encoder;
+
+        typedef kodo::fixed_full_rlnc_decoder<Field, Symbols, SymbolSize>
+            fixed_decoder;
+
+        typedef kodo::full_rlnc_encoder<Field> encoder;
+        typedef kodo::full_rlnc_decoder<Field> decoder;
+
+        typename fixed_encoder::factory fixed_encoder_factory(
+            Symbols, SymbolSize);
+
+        typename fixed_decoder::factory fixed_decoder_factory(
+            Symbols, SymbolSize);
+
+        typename encoder::factory encoder_factory(Symbols, SymbolSize);
+        typename decoder::factory decoder_factory(Symbols, SymbolSize);
+
+        EXPECT_EQ(fixed_encoder_factory.max_payload_size(),
+                  encoder_factory.max_payload_size());
+
+        EXPECT_EQ(fixed_decoder_factory.max_payload_size(),
+                  decoder_factory.max_payload_size());
+
+        {
+            auto fixed = fixed_encoder_factory.build();
+            auto generic = decoder_factory.build();
+            run_round_trip(fixed, generic);
+        }
+
+        {
+            auto generic = encoder_factory.build();
+            auto fixed = fixed_decoder_factory.build();
+            run_round_trip(generic, fixed);
+        }
+
+        // Check that the pooled coders are reset
+        {
+            auto fixed_en = fixed_encoder_factory.build();
+            auto fixed_de = fixed_decoder_factory.build();
+            run_round_trip(fixed_en, fixed_de);
+        }
+    }
+
+}
+
+TEST(TestFixedGeometry, test_fixed_stacks)
+{
+    test_fixed_stacks<fifi::binary, 16, 64>();
+    test_fixed_stacks<fifi::binary8, 32, 1400>();
+    test_fixed_stacks<fifi::binary16, 10, 100>();
+    test_fixed_stacks<fifi::prime2325, 5, 40>();
+}
+
+TEST(TestFixedGeometry, test_registry)
+{
+    typedef kodo::polymorphic_encoder<
+        kodo::fixed_full_rlnc_encoder<fifi::binary8, 32, 1400> >
+        fixed_encoder;
+
+    typedef kodo::polymorphic_decoder<
+        kodo::fixed_full_rlnc_decoder<fifi::binary8, 32, 1400> >
+        fixed_decoder;
+
+    typedef kodo::polymorphic_encoder<
+        kodo::full_rlnc_encoder<fifi::binary8> > encoder;
+
+    typedef kodo::polymorphic_decoder<
+        kodo::full_rlnc_decoder<fifi::binary8> > decoder;
+
+    kodo::geometry_registry<kodo::encoder_interface> encoders;
+    kodo::geometry_registry<kodo::decoder_interface> decoders;
+
+    // Nothing registered
+    EXPECT_FALSE(encoders.build(kodo::field_binary8, 32, 1400));
+    EXPECT_FALSE(decoders.build(kodo::field_binary8, 32, 1400));
+
+    kodo::add_fixed<fixed_encoder>(encoders);
+    kodo::add_fixed<fixed_decoder>(decoders);
+
+    kodo::add_generic<encoder>(encoders, 64, 1600);
+    kodo::add_generic<decoder>(decoders, 64, 1600);
+
+    EXPECT_TRUE(encoders.is_fixed(kodo::field_binary8, 32, 1400));
+    EXPECT_TRUE(decoders.is_fixed(kodo::field_binary8, 32, 1400));
+    EXPECT_FALSE(encoders.is_fixed(kodo::field_binary8, 31, 1400));
+    EXPECT_FALSE(encoders.is_fixed(kodo::field_binary, 32, 1400));
+
+    // The registered geometry uses the fixed stacks
+    {
+        auto en = encoders.build(kodo::field_binary8, 32, 1400);
+        auto de = decoders.build(kodo::field_binary8, 32, 1400);
+
+        ASSERT_TRUE(bool(en));
+        ASSERT_TRUE(bool(de));
+
+        EXPECT_TRUE(dynamic_cast<fixed_encoder*>(en.get()) != 0);
+        EXPECT_TRUE(dynamic_cast<fixed_decoder*>(de.get()) != 0);
+
+        run_round_trip(en, de);
+    }
+
+    // Other geometries fall back to the generic stacks
+    {
+        auto en = encoders.build(kodo::field_binary8, 20, 1000);
+        auto de = decoders.build(kodo::field_binary8, 20, 1000);
+
+        ASSERT_TRUE(bool(en));
+        ASSERT_TRUE(bool(de));
+
+        EXPECT_TRUE(dynamic_cast<encoder*>(en.get()) != 0);
+        EXPECT_TRUE(dynamic_cast<decoder*>(de.get()) != 0);
+
+        EXPECT_EQ(20U, en->symbols());
+        EXPECT_EQ(1000U, en->symbol_size());
+
+        run_round_trip(en, de);
+    }
+
+    // The fixed and generic coders interoperate
+    {
+        auto en = encoders.build(kodo::field_binary8, 32, 1400);
+        auto de = decoders.build(kodo::field_binary8, 32, 1400);
+
+        auto generic_en = boost::make_shared<encoder>(
+            boost::make_shared<encoder::factory>(32, 1400));
+
+        EXPECT_EQ(en->payload_size(), generic_en->payload_size());
+        run_round_trip(generic_en, de);
+    }
+
+    // Geometries larger than the generic stacks support
+    EXPECT_FALSE(encoders.build(kodo::field_binary8, 65, 1000));
+    EXPECT_FALSE(decoders.build(kodo::field_binary8, 65, 1000));
+    EXPECT_FALSE(encoders.build(kodo::field_binary8, 20, 1601));
+    EXPECT_FALSE(decoders.build(kodo::field_binary8, 20, 1601));
+
+    // The generic stacks still work after a rejected geometry
+    {
+        auto en = encoders.build(kodo::field_binary8, 64, 1600);
+        auto de = decoders.build(kodo::field_binary8, 64, 1600);
+
+        ASSERT_TRUE(bool(en));
+        ASSERT_TRUE(bool(de));
+
+        run_round_trip(en, de);
+    }
+
+    // No stack registered for the field
+    EXPECT_FALSE(encoders.build(kodo::field_binary16, 32, 1400));
+}
+
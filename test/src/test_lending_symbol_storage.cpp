@@ -0,0 +1,171 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_lending_symbol_storage.cpp Unit tests for decoding in
+///       buffers lent by the application
+
+#include <algorithm>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <sak/aligned_allocator.hpp>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// A pool of aligned receive buffers which checks that every buffer is
+/// handed back exactly once
+struct buffer_pool
+{
+    typedef std::vector<uint8_t, sak::aligned_allocator<uint8_t> >
+        buffer_type;
+
+    buffer_pool(uint32_t buffers, uint32_t buffer_size)
+        : m_buffers(buffers, buffer_type(buffer_size))
+    {
+        for(auto &b : m_buffers)
+            m_free.insert(&b[0]);
+    }
+
+    uint8_t* get()
+    {
+        assert(!m_free.empty());
+
+        uint8_t *buffer = *m_free.begin();
+        m_free.erase(m_free.begin());
+
+        return buffer;
+    }
+
+    void release(uint8_t *buffer)
+    {
+        EXPECT_TRUE(m_free.insert(buffer).second);
+    }
+
+    uint32_t lent() const
+    {
+        return m_buffers.size() - m_free.size();
+    }
+
+    std::vector<buffer_type> m_buffers;
+    std::set<uint8_t*> m_free;
+};
+
+/// Decodes a block from lent payload buffers, the first half of the
+/// symbols is sent coded so the systematic symbols replace coded rows
+template<class Field>
+void invoke_lending(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::full_rlnc_lending_decoder<Field> decoder_t;
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    buffer_pool pool(symbols + 2, encoder->payload_size());
+
+    decoder->set_release_callback(
+        [&pool](uint8_t *buffer) { pool.release(buffer); });
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    kodo::set_systematic_off(encoder);
+
+    for(uint32_t i = 0; i < symbols / 2; ++i)
+    {
+        uint8_t *payload = pool.get();
+        encoder->encode(payload);
+
+        uint32_t rank = decoder->rank();
+        bool adopted = decoder->decode_lent(payload);
+
+        EXPECT_EQ(adopted, decoder->rank() == rank + 1);
+        EXPECT_EQ(decoder->rank(), pool.lent());
+    }
+
+    kodo::set_systematic_on(encoder);
+
+    while(!decoder->is_complete())
+    {
+        uint8_t *payload = pool.get();
+        encoder->encode(payload);
+
+        // A systematic symbol replacing a coded row is adopted even if
+        // the rank does not change
+        decoder->decode_lent(payload);
+
+        EXPECT_GE(decoder->rank(), pool.lent());
+    }
+
+    // A non-innovative symbol is handed back right away
+    {
+        kodo::set_systematic_off(encoder);
+
+        uint8_t *payload = pool.get();
+        encoder->encode(payload);
+
+        EXPECT_FALSE(decoder->decode_lent(payload));
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    // The symbols are copied to the internal storage when the buffers
+    // are handed back
+    decoder->release_symbols();
+    EXPECT_EQ(0U, pool.lent());
+
+    std::fill(data_out.begin(), data_out.end(), 0);
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    // Decode a new block using separate symbol data and header buffers,
+    // the buffers still held are handed back when the decoder is
+    // initialized
+    decoder->initialize(decoder_factory);
+    encoder->initialize(encoder_factory);
+
+    data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+
+        uint8_t *symbol_data = pool.get();
+        std::copy(payload.begin(), payload.begin() + symbol_size,
+                  symbol_data);
+
+        decoder->decode_lent(symbol_data, &payload[symbol_size]);
+    }
+
+    EXPECT_EQ(symbols, pool.lent());
+
+    decoder->copy_symbols(sak::storage(data_out));
+    EXPECT_TRUE(data_in == data_out);
+
+    decoder->initialize(decoder_factory);
+    EXPECT_EQ(0U, pool.lent());
+}
+
+TEST(TestLendingSymbolStorage, decode)
+{
+    invoke_lending<fifi::binary>(32, 1600);
+    invoke_lending<fifi::binary8>(32, 1600);
+    invoke_lending<fifi::binary8>(1, 100);
+    invoke_lending<fifi::binary16>(16, 1600);
+}
+
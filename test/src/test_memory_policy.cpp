@@ -0,0 +1,122 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_memory_policy.cpp Unit tests for the memory policies and
+///       the page_memory allocations
+
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <kodo/page_memory.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks that the memory is zero initialized and may be written
+inline void check_memory(kodo::page_memory &memory, uint32_t size)
+{
+    ASSERT_TRUE(memory.data() != 0);
+    EXPECT_EQ(size, memory.size());
+    EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(memory.data()) % 16);
+
+    for(uint32_t i = 0; i < size; ++i)
+    {
+        EXPECT_EQ(0U, memory.data()[i]);
+        memory.data()[i] = uint8_t(i);
+    }
+}
+
+TEST(TestMemoryPolicy, heap)
+{
+    uint32_t size = 10000;
+
+    kodo::page_memory memory;
+    memory.allocate(size, kodo::memory_policy());
+
+    check_memory(memory, size);
+
+    EXPECT_EQ(kodo::memory_policy::huge_pages_none, memory.huge_pages());
+    EXPECT_EQ(-1, memory.numa_node());
+}
+
+/// The huge page and NUMA policies depend on the system, so we only check
+/// that the fallbacks produce usable memory and that the reported pages
+/// match what was requested.
+TEST(TestMemoryPolicy, huge_pages)
+{
+    uint32_t size = 3 * kodo::page_memory::huge_page_size + 100;
+
+    {
+        kodo::memory_policy policy;
+        policy.m_huge_pages = kodo::memory_policy::huge_pages_transparent;
+
+        kodo::page_memory memory;
+        memory.allocate(size, policy);
+
+        check_memory(memory, size);
+
+        EXPECT_NE(kodo::memory_policy::huge_pages_explicit,
+                  memory.huge_pages());
+
+        if(memory.huge_pages() != kodo::memory_policy::huge_pages_none)
+        {
+            EXPECT_EQ(0U, reinterpret_cast<uintptr_t>(memory.data()) %
+                      kodo::page_memory::huge_page_size);
+        }
+    }
+
+    {
+        kodo::memory_policy policy;
+        policy.m_huge_pages = kodo::memory_policy::huge_pages_explicit;
+        policy.m_numa_local = true;
+
+        kodo::page_memory memory;
+        memory.allocate(size, policy);
+
+        check_memory(memory, size);
+    }
+}
+
+TEST(TestMemoryPolicy, factory)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_decoder<fifi::binary8> decoder_t;
+
+    kodo::memory_policy policy;
+    policy.m_huge_pages = kodo::memory_policy::huge_pages_transparent;
+    policy.m_numa_local = true;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 1400;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    decoder_factory.set_memory_policy(policy);
+
+    EXPECT_EQ(policy.m_huge_pages,
+              decoder_factory.memory_policy().m_huge_pages);
+    EXPECT_TRUE(decoder_factory.memory_policy().m_numa_local);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
@@ -0,0 +1,139 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_memory_usage.cpp Unit tests for the memory usage reported
+///       by the coders and factories
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Checks the memory usage of a coder against the storage it must hold
+/// @param stores_coefficients True if the coder stores the coding
+///        coefficients of every symbol, i.e. contains the
+///        coefficient_storage layer
+template<class Coder>
+void check_coder_memory_usage(uint32_t symbols, uint32_t symbol_size,
+                              bool stores_coefficients)
+{
+    typename Coder::factory factory(symbols, symbol_size);
+
+    auto coder = factory.build();
+
+    uint64_t usage = coder->memory_usage();
+
+    uint64_t coefficients = stores_coefficients ?
+        symbols * coder->coefficients_size() : 0;
+
+    EXPECT_GE(usage, uint64_t(coder->block_size()) + coefficients);
+
+    // The arena and vectors are sized from the maxima of the factory
+    typename Coder::factory larger_factory(2 * symbols, symbol_size);
+    auto larger_coder = larger_factory.build();
+
+    EXPECT_GT(larger_coder->memory_usage(), usage);
+
+    // A coder returned to the pool is accounted for by the factory
+    uint64_t factory_usage = factory.memory_usage();
+    coder.reset();
+
+    EXPECT_GE(factory.memory_usage(), factory_usage + usage);
+
+    // Building the coder again takes it from the pool
+    coder = factory.build();
+    EXPECT_EQ(usage, coder->memory_usage());
+    EXPECT_EQ(factory_usage, factory.memory_usage());
+}
+
+TEST(TestMemoryUsage, coders)
+{
+    uint32_t symbols = rand_symbols();
+    uint32_t symbol_size = rand_symbol_size();
+
+    check_coder_memory_usage<kodo::full_rlnc_encoder<fifi::binary> >(
+        symbols, symbol_size, false);
+
+    check_coder_memory_usage<kodo::full_rlnc_decoder<fifi::binary8> >(
+        symbols, symbol_size, true);
+
+    check_coder_memory_usage<kodo::full_rlnc_relay<fifi::binary16> >(
+        symbols, symbol_size, true);
+
+    check_coder_memory_usage<kodo::full_rlnc_lending_decoder<fifi::binary8> >(
+        symbols, symbol_size, true);
+}
+
+/// The shallow storage of the lending decoder holds a pointer per symbol
+/// on top of the storage of the deep decoder
+TEST(TestMemoryUsage, lending_storage)
+{
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 160;
+
+    kodo::full_rlnc_decoder<fifi::binary8>::factory
+        deep_factory(symbols, symbol_size);
+
+    kodo::full_rlnc_lending_decoder<fifi::binary8>::factory
+        lending_factory(symbols, symbol_size);
+
+    auto deep_decoder = deep_factory.build();
+    auto lending_decoder = lending_factory.build();
+
+    EXPECT_GE(lending_decoder->memory_usage(),
+              deep_decoder->memory_usage() + symbols * sizeof(uint8_t*));
+}
+
+/// The nibble tables of the binary8 field are shared by the coders and
+/// therefore accounted for by the factory
+TEST(TestMemoryUsage, simd_tables)
+{
+    kodo::full_rlnc_decoder<fifi::binary>::factory
+        binary_factory(16, 160);
+
+    kodo::full_rlnc_decoder<fifi::binary8>::factory
+        binary8_factory(16, 160);
+
+    EXPECT_GE(binary8_factory.memory_usage(),
+              binary_factory.memory_usage() + 256 * 32);
+}
+
+/// The recoding stack is built on the first recode and included in the
+/// memory usage from then on
+TEST(TestMemoryUsage, recoding_stack)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_running_recoding_decoder<fifi::binary8>
+        decoder_t;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    encoder->encode(&payload[0]);
+    decoder->decode(&payload[0]);
+
+    EXPECT_FALSE(decoder->has_recode_stack());
+    uint64_t usage = decoder->memory_usage();
+
+    std::vector<uint8_t> recoded(decoder->payload_size());
+    decoder->recode(&recoded[0]);
+
+    EXPECT_TRUE(decoder->has_recode_stack());
+    EXPECT_GT(decoder->memory_usage(), usage);
+}
@@ -0,0 +1,173 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_out_of_core_decoder.cpp Unit tests for the out of core
+///       decoder
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <kodo/out_of_core_decoder.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+/// Writes a buffer to a file
+inline void write_file(const std::string &filename,
+                       const std::vector<uint8_t> &data)
+{
+    std::ofstream file(filename.c_str(), std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&data[0]), data.size());
+}
+
+/// Reads a file into a buffer
+inline std::vector<uint8_t> read_file(const std::string &filename)
+{
+    std::ifstream file(filename.c_str(), std::ios::binary);
+
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file),
+                                std::istreambuf_iterator<char>());
+}
+
+/// Encodes a block with a regular encoder, spills every encoded symbol to
+/// a file and decodes it using the out of core decoder.
+template<class Field>
+void invoke_out_of_core(uint32_t symbols, uint32_t symbol_size,
+                        uint32_t chunk_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::out_of_core_decoder<
+        kodo::full_rlnc_decoder<Field> > decoder_t;
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    auto encoder = encoder_factory.build();
+
+    typename decoder_t::factory decoder_factory(
+        symbols, decoder_t::solver_symbol_size(symbols));
+
+    decoder_t decoder(decoder_factory, symbols, symbol_size);
+
+    EXPECT_EQ(symbols, decoder.symbols());
+    EXPECT_EQ(symbol_size, decoder.symbol_size());
+    EXPECT_EQ(encoder->coefficients_size(), decoder.coefficients_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<std::string> spill_files;
+    std::vector<uint8_t> symbol(symbol_size);
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+
+    // Start with an uncoded symbol and a duplicate of it
+    for(uint32_t i = 0; i < 2; ++i)
+    {
+        std::ostringstream name;
+        name << "out_of_core_spill_" << spill_files.size();
+        spill_files.push_back(name.str());
+
+        encoder->encode_symbol(&symbol[0], 0U);
+        write_file(spill_files.back(), symbol);
+
+        EXPECT_EQ(i == 0, decoder.decode_symbol(spill_files.back(), 0U));
+        EXPECT_EQ(1U, decoder.rank());
+    }
+
+    while(!decoder.is_complete())
+    {
+        std::ostringstream name;
+        name << "out_of_core_spill_" << spill_files.size();
+        spill_files.push_back(name.str());
+
+        encoder->generate(&coefficients[0]);
+        std::vector<uint8_t> sent = coefficients;
+
+        encoder->encode_symbol(&symbol[0], &coefficients[0]);
+        write_file(spill_files.back(), symbol);
+
+        uint32_t rank = decoder.rank();
+        bool innovative = decoder.decode_symbol(spill_files.back(),
+                                                &sent[0]);
+
+        EXPECT_EQ(innovative, decoder.rank() == rank + 1);
+    }
+
+    EXPECT_TRUE(decoder.write("out_of_core_output", chunk_size));
+
+    std::vector<uint8_t> data_out = read_file("out_of_core_output");
+    EXPECT_TRUE(data_in == data_out);
+
+    for(const auto &f : spill_files)
+        std::remove(f.c_str());
+
+    std::remove("out_of_core_output");
+}
+
+TEST(TestOutOfCoreDecoder, decode)
+{
+    invoke_out_of_core<fifi::binary>(16, 1600, 256);
+    invoke_out_of_core<fifi::binary8>(16, 1600, 256);
+    invoke_out_of_core<fifi::binary8>(5, 1000, 3);
+    invoke_out_of_core<fifi::binary16>(32, 1600, 300);
+    invoke_out_of_core<fifi::binary16>(8, 800, 4000);
+}
+
+/// Decodes a block from uncoded spill files, the write fails when a
+/// spill file is missing or too short
+template<class Field>
+void invoke_out_of_core_io_errors(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::out_of_core_decoder<
+        kodo::full_rlnc_decoder<Field> > decoder_t;
+
+    typename decoder_t::factory decoder_factory(
+        symbols, decoder_t::solver_symbol_size(symbols));
+
+    decoder_t decoder(decoder_factory, symbols, symbol_size);
+
+    std::vector<std::string> spill_files;
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        std::ostringstream name;
+        name << "out_of_core_spill_" << i;
+        spill_files.push_back(name.str());
+
+        write_file(spill_files.back(), random_vector(symbol_size));
+        EXPECT_TRUE(decoder.decode_symbol(spill_files.back(), i));
+    }
+
+    EXPECT_TRUE(decoder.is_complete());
+    EXPECT_TRUE(decoder.write("out_of_core_output", symbol_size));
+
+    // The output cannot be created in a missing directory
+    EXPECT_FALSE(decoder.write("out_of_core_missing/output", symbol_size));
+
+    // A spill file shorter than a symbol
+    std::vector<uint8_t> short_symbol = random_vector(symbol_size);
+    short_symbol.resize(symbol_size / 2);
+    write_file(spill_files.back(), short_symbol);
+
+    EXPECT_FALSE(decoder.write("out_of_core_output", symbol_size));
+
+    // A spill file removed before the write
+    std::remove(spill_files.front().c_str());
+    EXPECT_FALSE(decoder.write("out_of_core_output", symbol_size));
+
+    for(const auto &f : spill_files)
+        std::remove(f.c_str());
+
+    std::remove("out_of_core_output");
+}
+
+TEST(TestOutOfCoreDecoder, io_errors)
+{
+    invoke_out_of_core_io_errors<fifi::binary8>(4, 100);
+}
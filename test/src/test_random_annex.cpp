@@ -35,6 +35,71 @@ TEST(TestRandomAnnexBase, build_annex)
     invoke_random_annex_base<kodo::rfc5052_partitioning_scheme>();
 }
 
+/// Gives access to the annex data structures
+template<class Partitioning>
+struct random_annex_inspect : public kodo::random_annex_base<Partitioning>
+{
+    typedef kodo::random_annex_base<Partitioning> Base;
+
+    using Base::annex_begin;
+    using Base::annex_end;
+    using Base::reverse_annex_begin;
+    using Base::reverse_annex_end;
+};
+
+/// Tests that the annex is sorted and that the reverse annex maps back
+/// to the annex entries
+template<class Partitioning>
+inline void invoke_random_annex_reverse(uint32_t annex_size)
+{
+    Partitioning scheme(16, 1400, 342430);
+
+    random_annex_inspect<Partitioning> annex_base;
+    annex_base.build_annex(annex_size, scheme);
+
+    uint32_t reverse_entries = 0;
+
+    for(uint32_t i = 0; i < scheme.blocks(); ++i)
+    {
+        const kodo::annex_info *first = annex_base.annex_begin(i);
+        const kodo::annex_info *last = annex_base.annex_end(i);
+
+        EXPECT_EQ(annex_size, uint32_t(last - first));
+
+        for(const kodo::annex_info *it = first; it != last; ++it)
+        {
+            EXPECT_NE(i, it->m_coder_id);
+
+            if(it != first)
+            {
+                EXPECT_TRUE(*(it - 1) < *it);
+            }
+        }
+
+        const kodo::reverse_annex_info *r =
+            annex_base.reverse_annex_begin(i);
+
+        for(; r != annex_base.reverse_annex_end(i); ++r)
+        {
+            const kodo::annex_info &annex =
+                annex_base.annex_begin(r->m_coder_id)[r->m_annex_position];
+
+            EXPECT_EQ(i, annex.m_coder_id);
+            EXPECT_EQ(r->m_symbol_id, annex.m_symbol_id);
+
+            ++reverse_entries;
+        }
+    }
+
+    EXPECT_EQ(scheme.blocks() * annex_size, reverse_entries);
+}
+
+TEST(TestRandomAnnexBase, reverse_annex)
+{
+    invoke_random_annex_reverse<kodo::rfc5052_partitioning_scheme>(0);
+    invoke_random_annex_reverse<kodo::rfc5052_partitioning_scheme>(4);
+}
+
 /// Tests the results returned by the max_annex_size function
 template<class Partitioning>
 inline void invoke_max_annex_size(uint32_t max_symbols,
@@ -125,6 +190,12 @@ void invoke_random_annex_partial(uint32_t max_symbols,
     EXPECT_TRUE(obj_decoder.decoders() >= 1);
     EXPECT_TRUE(obj_encoder.encoders() == obj_decoder.decoders());
 
+    // The object coders hold the coders of all blocks
+    EXPECT_GE(obj_encoder.memory_usage(),
+              obj_encoder.build(0)->memory_usage());
+    EXPECT_GE(obj_decoder.memory_usage(),
+              obj_decoder.build(0).unwrap()->memory_usage());
+
     uint32_t bytes_used = 0;
 
     for(uint32_t i = 0; i < obj_encoder.encoders(); ++i)
@@ -528,6 +528,10 @@ void test_recoders(recoding_parameters param)
         kodo::full_rlnc_encoder,
         kodo::full_rlnc_decoder_delayed_shallow>(param);
 
+    test_recoders<
+        kodo::full_rlnc_encoder,
+        kodo::full_rlnc_running_recoding_decoder>(param);
+
 }
 
 /// Tests that the recoding function works, this is done by using one
@@ -574,6 +578,315 @@ TEST(TestRlncFullVectorCodes, recoding_simple)
     test_recoders(param);
 }
 
+/// Tests recoding from running combinations with different numbers of
+/// combinations and refresh rows, also when the recoded symbols are
+/// decoded by a plain decoder
+template<class Field>
+void test_running_recoding(uint32_t combinations, uint32_t refresh_rows,
+                           bool uncoded)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::full_rlnc_running_recoding_decoder<Field> relay_t;
+    typedef kodo::full_rlnc_decoder<Field> decoder_t;
+
+    uint32_t symbols = 20;
+    uint32_t symbol_size = 100;
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename relay_t::factory relay_factory(symbols, symbol_size);
+    typename decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    relay_factory.set_running_combinations(combinations);
+    relay_factory.set_refresh_rows(refresh_rows);
+
+    auto encoder = encoder_factory.build();
+    auto relay = relay_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(combinations, relay->running_combination_count());
+    EXPECT_EQ(encoder->payload_size(), relay->payload_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    if(!uncoded)
+        kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(relay_factory.max_payload_size());
+
+    // The relay recodes twice per symbol received so the refresh is
+    // used, once the relay is complete it only recodes
+    uint32_t packets = 0;
+
+    while(!decoder->is_complete())
+    {
+        if(!relay->is_complete())
+        {
+            encoder->encode(&payload[0]);
+            relay->decode(&payload[0]);
+        }
+
+        relay->recode(&payload[0]);
+        decoder->decode(&payload[0]);
+
+        relay->recode(&payload[0]);
+        decoder->decode(&payload[0]);
+
+        ++packets;
+        ASSERT_LT(packets, 10 * symbols);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, running_recoding)
+{
+    test_running_recoding<fifi::binary>(1, 1, false);
+    test_running_recoding<fifi::binary>(4, 2, true);
+    test_running_recoding<fifi::binary8>(1, 1, true);
+    test_running_recoding<fifi::binary8>(2, 1, false);
+    test_running_recoding<fifi::binary8>(8, 4, false);
+    test_running_recoding<fifi::binary16>(2, 1, false);
+}
+
+/// Tests a relay storing the symbols received without decoding them,
+/// the recoded symbols are decoded by a plain decoder
+template<class Field>
+void test_relay(uint32_t buffer_symbols, bool rank_check, bool uncoded)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::full_rlnc_relay<Field> relay_t;
+    typedef kodo::full_rlnc_decoder<Field> decoder_t;
+
+    uint32_t symbols = 20;
+    uint32_t symbol_size = 100;
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename relay_t::factory relay_factory(symbols, symbol_size);
+    typename decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    relay_factory.set_buffer_symbols(buffer_symbols);
+    relay_factory.set_rank_check(rank_check);
+
+    auto encoder = encoder_factory.build();
+    auto relay = relay_factory.build();
+    auto decoder = decoder_factory.build();
+
+    EXPECT_EQ(encoder->payload_size(), relay->payload_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    if(!uncoded)
+        kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(relay_factory.max_payload_size());
+
+    uint32_t packets = 0;
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        relay->decode(&payload[0]);
+
+        EXPECT_LE(relay->rank(), std::min(buffer_symbols, symbols));
+
+        relay->recode(&payload[0]);
+        decoder->decode(&payload[0]);
+
+        ++packets;
+        ASSERT_LT(packets, 20 * symbols);
+    }
+
+    if(rank_check)
+    {
+        EXPECT_EQ(relay->received_rank(), relay->rank());
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, relay)
+{
+    test_relay<fifi::binary>(20, true, false);
+    test_relay<fifi::binary>(20, false, true);
+    test_relay<fifi::binary8>(20, true, true);
+    test_relay<fifi::binary8>(20, false, false);
+    test_relay<fifi::binary8>(8, false, false);
+    test_relay<fifi::binary16>(20, true, false);
+    test_relay<fifi::binary16>(5, false, true);
+}
+
+/// Tests that the rank check of the relay drops the symbols which are
+/// not innovative
+TEST(TestRlncFullVectorCodes, relay_rank_check)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_relay<fifi::binary8> relay_t;
+
+    uint32_t symbols = 10;
+    uint32_t symbol_size = 40;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    relay_t::factory relay_factory(symbols, symbol_size);
+    relay_factory.set_rank_check(true);
+
+    auto encoder = encoder_factory.build();
+    auto relay = relay_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(relay_factory.max_payload_size());
+
+    // The systematic symbols are stored once
+    for(uint32_t i = 0; i < symbols / 2; ++i)
+    {
+        encoder->encode(&payload[0]);
+
+        std::vector<uint8_t> copy = payload;
+
+        relay->decode(&payload[0]);
+        relay->decode(&copy[0]);
+    }
+
+    EXPECT_EQ(symbols / 2, relay->rank());
+    EXPECT_EQ(symbols / 2, relay->received_rank());
+
+    // Coded symbols are stored until the relay has full rank
+    while(!relay->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        relay->decode(&payload[0]);
+    }
+
+    EXPECT_EQ(symbols, relay->received_rank());
+
+    encoder->encode(&payload[0]);
+    relay->decode(&payload[0]);
+
+    EXPECT_EQ(symbols, relay->rank());
+}
+
+/// Tests that the symbols recoded by the inline_payload_recoder and by
+/// the payload_recoder with the recoding_stack can be mixed in a chain
+/// of relays
+template<class Field>
+void test_inline_recoder_chain(uint32_t symbols, uint32_t symbol_size)
+{
+    typedef kodo::full_rlnc_encoder<Field> encoder_t;
+    typedef kodo::full_rlnc_decoder<Field> inline_t;
+    typedef kodo::full_rlnc_decoder_delayed<Field> proxy_t;
+
+    typename encoder_t::factory encoder_factory(symbols, symbol_size);
+    typename inline_t::factory inline_factory(symbols, symbol_size);
+    typename proxy_t::factory proxy_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto relay_one = inline_factory.build();
+    auto relay_two = proxy_factory.build();
+    auto decoder = inline_factory.build();
+
+    EXPECT_EQ(relay_one->payload_size(), relay_two->payload_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(std::max(inline_factory.max_payload_size(),
+                                          proxy_factory.max_payload_size()));
+
+    // Recoding without any symbols produces a zero symbol
+    relay_one->recode(&payload[0]);
+    decoder->decode(&payload[0]);
+    EXPECT_EQ(0U, decoder->rank());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        relay_one->decode(&payload[0]);
+
+        relay_one->recode(&payload[0]);
+        relay_two->decode(&payload[0]);
+
+        relay_two->recode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, inline_recoder_chain)
+{
+    test_inline_recoder_chain<fifi::binary>(40, 32);
+    test_inline_recoder_chain<fifi::binary8>(16, 160);
+    test_inline_recoder_chain<fifi::binary16>(8, 64);
+}
+
+/// Tests that the recoding stack of a decoder is only built when the
+/// decoder recodes, unless the factory asks for it on initialize
+TEST(TestRlncFullVectorCodes, lazy_recode_stack)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_t;
+    typedef kodo::full_rlnc_decoder_delayed<fifi::binary8> decoder_t;
+
+    uint32_t symbols = 16;
+    uint32_t symbol_size = 160;
+
+    encoder_t::factory encoder_factory(symbols, symbol_size);
+    decoder_t::factory decoder_factory(symbols, symbol_size);
+
+    EXPECT_FALSE(decoder_factory.eager_recoding());
+
+    std::vector<uint8_t> data_in = random_vector(symbols * symbol_size);
+    std::vector<uint8_t> payload(decoder_factory.max_payload_size());
+
+    for(uint32_t i = 0; i < 2; ++i)
+    {
+        auto encoder = encoder_factory.build();
+        auto decoder_one = decoder_factory.build();
+        auto decoder_two = decoder_factory.build();
+
+        // A recycled decoder keeps its recoding stack
+        EXPECT_EQ(i > 0, decoder_one->has_recode_stack());
+        EXPECT_EQ(encoder->payload_size(), decoder_one->payload_size());
+
+        encoder->set_symbols(sak::storage(data_in));
+        kodo::set_systematic_off(encoder);
+
+        while(!decoder_two->is_complete())
+        {
+            encoder->encode(&payload[0]);
+            decoder_one->decode(&payload[0]);
+
+            decoder_one->recode(&payload[0]);
+            decoder_two->decode(&payload[0]);
+        }
+
+        EXPECT_TRUE(decoder_one->has_recode_stack());
+
+        std::vector<uint8_t> data_out(decoder_two->block_size());
+        decoder_two->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(data_in == data_out);
+    }
+
+    decoder_t::factory eager_factory(symbols, symbol_size);
+    eager_factory.set_eager_recoding(true);
+
+    auto decoder = eager_factory.build();
+    EXPECT_TRUE(decoder->has_recode_stack());
+}
+
 
 template
     <
@@ -701,3 +1014,285 @@ TEST(TestRlncFullVectorCodes, test_reuse_incomplete)
 
 
 
+
+/// Recycles the same coders with a small block between two large ones.
+/// Only the part of the coder state used by the previous block is
+/// cleared on initialize, so the large block must not see any state left
+/// over from the first large block.
+template<class Encoder, class Decoder>
+void test_recycle_block_size(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    uint32_t sizes[] = { symbols, 1, symbols };
+
+    for(uint32_t s : sizes)
+    {
+        encoder_factory.set_symbols(s);
+        decoder_factory.set_symbols(s);
+
+        auto encoder = encoder_factory.build();
+        auto decoder = decoder_factory.build();
+
+        EXPECT_EQ(0U, decoder->rank());
+        EXPECT_EQ(0U, decoder->symbols_initialized());
+
+        for(uint32_t i = 0; i < decoder->symbols(); ++i)
+        {
+            EXPECT_FALSE(decoder->symbol_pivot(i));
+
+            std::vector<uint8_t> zero(decoder->symbol_size(), 0);
+            EXPECT_TRUE(std::equal(zero.begin(), zero.end(),
+                                   decoder->symbol(i)));
+        }
+
+        invoke_reuse_helper(encoder, decoder);
+    }
+}
+
+TEST(TestRlncFullVectorCodes, test_recycle_block_size)
+{
+    test_recycle_block_size<
+        kodo::full_rlnc_encoder<fifi::binary8>,
+        kodo::full_rlnc_decoder<fifi::binary8>
+        >(32, 160);
+
+    test_recycle_block_size<
+        kodo::full_rlnc_encoder<fifi::binary>,
+        kodo::full_rlnc_decoder_delayed<fifi::binary>
+        >(16, 64);
+}
+
+/// Checks that encode_view() produces the same payloads as encode() and
+/// that systematic symbols refer directly to the encoder storage
+template<class Encoder, class Decoder>
+void test_encode_view(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto view_encoder = encoder_factory.build();
+    auto copy_encoder = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(view_encoder->block_size());
+
+    view_encoder->set_symbols(sak::storage(data_in));
+    copy_encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> buffer(view_encoder->payload_size());
+    std::vector<uint8_t> payload(view_encoder->payload_size());
+    std::vector<uint8_t> expected(copy_encoder->payload_size());
+
+    uint32_t count = 0;
+
+    while(!decoder->is_complete())
+    {
+        kodo::payload_view view;
+        uint32_t used = view_encoder->encode_view(&buffer[0], view);
+        uint32_t expected_used = copy_encoder->encode(&expected[0]);
+
+        EXPECT_EQ(expected_used, used);
+        EXPECT_EQ(used, view.m_symbol.m_size + view.m_header.m_size);
+        EXPECT_EQ(view_encoder->symbol_size(), view.m_symbol.m_size);
+
+        if(count < symbols)
+        {
+            // Systematic symbols are not copied
+            EXPECT_TRUE(view.m_symbol.m_data < &buffer[0] ||
+                        view.m_symbol.m_data >= &buffer[0] + buffer.size());
+        }
+
+        // Gather the two parts as a writev() would
+        std::copy(view.m_symbol.m_data,
+                  view.m_symbol.m_data + view.m_symbol.m_size,
+                  payload.begin());
+
+        std::copy(view.m_header.m_data,
+                  view.m_header.m_data + view.m_header.m_size,
+                  payload.begin() + view.m_symbol.m_size);
+
+        EXPECT_TRUE(std::equal(payload.begin(), payload.begin() + used,
+                               expected.begin()));
+
+        decoder->decode(&payload[0]);
+        ++count;
+    }
+
+    EXPECT_EQ(symbols, view_encoder->systematic_count());
+
+    std::vector<uint8_t> data_out(decoder->block_size());
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, test_encode_view)
+{
+    test_encode_view<
+        kodo::full_rlnc_encoder<fifi::binary8>,
+        kodo::full_rlnc_decoder<fifi::binary8>
+        >(16, 160);
+
+    test_encode_view<
+        kodo::full_rlnc_encoder_shallow<fifi::binary>,
+        kodo::full_rlnc_decoder<fifi::binary>
+        >(8, 64);
+}
+
+/// Checks that symbols encoded, recoded and decoded using separate symbol
+/// data and header buffers are decoded correctly
+template<class Encoder, class Decoder>
+void test_split_header(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto decoder_one = decoder_factory.build();
+    auto decoder_two = decoder_factory.build();
+
+    EXPECT_EQ(encoder->payload_size(),
+              encoder->symbol_size() + encoder->header_size());
+
+    EXPECT_GE(decoder_one->header_size(), encoder->header_size());
+
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+    encoder->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> header(decoder_one->header_size());
+
+    // Compare with the contiguous layout of the payload API
+    auto reference = encoder_factory.build();
+    reference->set_symbols(sak::storage(data_in));
+
+    std::vector<uint8_t> payload(reference->payload_size());
+
+    while(!decoder_two->is_complete())
+    {
+        uint32_t used = encoder->encode(&symbol[0], &header[0]);
+        EXPECT_LE(used, encoder->header_size());
+
+        reference->encode(&payload[0]);
+
+        EXPECT_TRUE(std::equal(symbol.begin(), symbol.end(),
+                               payload.begin()));
+        EXPECT_TRUE(std::equal(header.begin(), header.begin() + used,
+                               payload.begin() + symbol.size()));
+
+        decoder_one->decode(&symbol[0], &header[0]);
+
+        used = decoder_one->recode(&symbol[0], &header[0]);
+        EXPECT_LE(used, decoder_one->header_size());
+
+        decoder_two->decode(&symbol[0], &header[0]);
+    }
+
+    std::vector<uint8_t> data_out(decoder_two->block_size());
+    decoder_two->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, test_split_header)
+{
+    test_split_header<
+        kodo::full_rlnc_encoder<fifi::binary8>,
+        kodo::full_rlnc_decoder<fifi::binary8>
+        >(16, 160);
+
+    test_split_header<
+        kodo::full_rlnc_encoder<fifi::binary16>,
+        kodo::full_rlnc_decoder<fifi::binary16>
+        >(8, 64);
+}
+
+/// Tests that a block only partially filled with data is encoded as if
+/// the padding was coded and that the decoder treats the padding
+/// symbols as decoded
+template<class Encoder, class Decoder>
+void test_padding(uint32_t symbols, uint32_t symbol_size,
+                  uint32_t bytes_used)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+
+    auto encoder = encoder_factory.build();
+    auto reference = encoder_factory.build();
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> data_in = random_vector(bytes_used);
+
+    encoder->set_symbols(sak::storage(data_in));
+    encoder->set_bytes_used(bytes_used);
+
+    reference->set_symbols(sak::storage(data_in));
+
+    uint32_t symbols_used = (bytes_used + symbol_size - 1) / symbol_size;
+    EXPECT_EQ(symbols_used, encoder->symbols_used());
+    EXPECT_EQ(symbols, reference->symbols_used());
+    EXPECT_EQ(bytes_used - (symbols_used - 1) * symbol_size,
+              encoder->symbol_bytes_used(symbols_used - 1));
+
+    if(symbols_used < symbols)
+    {
+        EXPECT_EQ(0U, encoder->symbol_bytes_used(symbols_used));
+    }
+
+    std::vector<uint8_t> coefficients(encoder->coefficients_size());
+    std::vector<uint8_t> symbol(encoder->symbol_size());
+    std::vector<uint8_t> expected(encoder->symbol_size());
+
+    for(uint32_t i = 0; i < symbols; ++i)
+    {
+        encoder->generate(&coefficients[0]);
+
+        encoder->encode_symbol(&symbol[0], &coefficients[0]);
+        reference->encode_symbol(&expected[0], &coefficients[0]);
+
+        EXPECT_TRUE(symbol == expected);
+    }
+
+    decoder->set_bytes_used(bytes_used);
+    EXPECT_EQ(symbols - symbols_used, decoder->rank());
+
+    kodo::set_systematic_off(encoder);
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+
+    while(!decoder->is_complete())
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    std::vector<uint8_t> data_out(bytes_used);
+    decoder->copy_symbols(sak::storage(data_out));
+
+    EXPECT_TRUE(data_in == data_out);
+}
+
+TEST(TestRlncFullVectorCodes, test_padding)
+{
+    test_padding<
+        kodo::full_rlnc_padding_aware_encoder<fifi::binary>,
+        kodo::full_rlnc_padding_aware_decoder<fifi::binary>
+        >(32, 160, 5 * 160 + 33);
+
+    test_padding<
+        kodo::full_rlnc_padding_aware_encoder<fifi::binary8>,
+        kodo::full_rlnc_padding_aware_decoder<fifi::binary8>
+        >(16, 160, 161);
+
+    test_padding<
+        kodo::full_rlnc_padding_aware_encoder<fifi::binary16>,
+        kodo::full_rlnc_padding_aware_decoder<fifi::binary16>
+        >(8, 64, 7 * 64 + 1);
+
+    test_padding<
+        kodo::full_rlnc_padding_aware_encoder<fifi::binary8>,
+        kodo::full_rlnc_padding_aware_decoder<fifi::binary8>
+        >(8, 64, 8 * 64);
+}
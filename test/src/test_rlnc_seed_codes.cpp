@@ -29,6 +29,18 @@ static void test_coders(uint32_t symbols, uint32_t symbol_size)
             kodo::seed_rlnc_encoder<fifi::binary16>,
             kodo::seed_rlnc_decoder<fifi::binary16>
             >(symbols, symbol_size);
+
+    invoke_basic_api
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary>
+            >(symbols, symbol_size);
+
+    invoke_basic_api
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary8>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary8>
+            >(symbols, symbol_size);
 }
 
 
@@ -67,6 +79,12 @@ static void test_coders_systematic(uint32_t symbols, uint32_t symbol_size)
             kodo::seed_rlnc_decoder<fifi::binary16>
             >(symbols, symbol_size);
 
+    invoke_systematic
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary8>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary8>
+            >(symbols, symbol_size);
+
 }
 
 TEST(TestRlncSeedCodes, systematic)
@@ -82,3 +100,112 @@ TEST(TestRlncSeedCodes, systematic)
     test_coders_systematic(symbols, symbol_size);
 }
 
+
+
+TEST(TestRlncSeedCodes, initialize)
+{
+    invoke_initialize
+        <
+            kodo::seed_rlnc_encoder<fifi::binary8>,
+            kodo::seed_rlnc_decoder<fifi::binary8>
+            >(32, 1600);
+
+    invoke_initialize
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary8>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary8>
+            >(32, 1600);
+}
+
+/// Checks that symbols with an already received seed are dropped and that
+/// the coefficients of reused seeds are served from the cache
+template<class Encoder, class Decoder>
+static void test_duplicate_seeds(uint32_t symbols, uint32_t symbol_size)
+{
+    typename Encoder::factory encoder_factory(symbols, symbol_size);
+    auto encoder = encoder_factory.build();
+
+    // Large enough to hold all seeds used in a generation
+    typename Decoder::factory decoder_factory(symbols, symbol_size);
+    decoder_factory.set_coefficient_cache_size(4 * symbols);
+    auto decoder = decoder_factory.build();
+
+    std::vector<uint8_t> payload(encoder->payload_size());
+    std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+
+    for(uint32_t generation = 0; generation < 2; ++generation)
+    {
+        encoder->initialize(encoder_factory);
+        decoder->initialize(decoder_factory);
+
+        encoder->set_seed_nonce(generation);
+        decoder->set_seed_nonce(generation);
+
+        encoder->set_symbols(sak::storage(data_in));
+        kodo::set_systematic_off(encoder);
+
+        uint32_t duplicates = 0;
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&payload[0]);
+
+            std::vector<uint8_t> copy(payload);
+            decoder->decode(&payload[0]);
+
+            uint32_t rank = decoder->rank();
+            decoder->decode(&copy[0]);
+            ++duplicates;
+
+            EXPECT_EQ(rank, decoder->rank());
+            EXPECT_EQ(duplicates, decoder->duplicate_seeds());
+        }
+
+        std::vector<uint8_t> data_out(decoder->block_size(), '\0');
+        decoder->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(std::equal(data_out.begin(),
+                               data_out.end(),
+                               data_in.begin()));
+    }
+
+    // The duplicates never reached the generator, so every lookup was
+    // a miss as the nonce changed between the generations
+    EXPECT_EQ(0U, decoder->cached_coefficients().hits());
+
+    // Same nonce as the previous generation so all seeds are cached
+    encoder->initialize(encoder_factory);
+    decoder->initialize(decoder_factory);
+
+    encoder->set_seed_nonce(1);
+    decoder->set_seed_nonce(1);
+
+    encoder->set_symbols(sak::storage(data_in));
+    kodo::set_systematic_off(encoder);
+
+    uint32_t misses = decoder->cached_coefficients().misses();
+
+    while(!decoder->is_complete() && encoder->encode_symbol_count() < symbols)
+    {
+        encoder->encode(&payload[0]);
+        decoder->decode(&payload[0]);
+    }
+
+    EXPECT_EQ(misses, decoder->cached_coefficients().misses());
+    EXPECT_GT(decoder->cached_coefficients().hits(), 0U);
+}
+
+TEST(TestRlncSeedCodes, duplicate_seeds)
+{
+    test_duplicate_seeds
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary8>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary8>
+            >(32, 160);
+
+    test_duplicate_seeds
+        <
+            kodo::compact_seed_rlnc_encoder<fifi::binary>,
+            kodo::compact_seed_rlnc_decoder<fifi::binary>
+            >(16, 160);
+}
@@ -0,0 +1,208 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+/// @file test_simd_finite_field_math.cpp Unit tests for the
+///       kodo::simd_finite_field_math class
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fifi/default_field.hpp>
+#include <fifi/field_types.hpp>
+
+#include <kodo/final_coder_factory.hpp>
+#include <kodo/finite_field_info.hpp>
+#include <kodo/finite_field_math.hpp>
+#include <kodo/simd_finite_field_math.hpp>
+#include <kodo/storage_block_info.hpp>
+#include <kodo/rlnc/full_vector_codes.hpp>
+
+#include "basic_api_test_helper.hpp"
+
+namespace kodo
+{
+
+    // Stack using the SIMD kernels
+    template<class Field>
+    class simd_math_stack
+        : public storage_block_info<
+                 simd_finite_field_math<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 final_coder_factory<
+                 simd_math_stack<Field>
+                     > > > > >
+    { };
+
+    // Stack using the fifi arithmetics
+    template<class Field>
+    class reference_math_stack
+        : public storage_block_info<
+                 finite_field_math<typename fifi::default_field<Field>::type,
+                 finite_field_info<Field,
+                 final_coder_factory<
+                 reference_math_stack<Field>
+                     > > > >
+    { };
+
+}
+
+namespace
+{
+
+    /// Checks that the operations of the given coder match the
+    /// reference for all constants and lengths covering the tails of the
+    /// kernels
+    template<class Coder, class Reference>
+    void check_operations(Coder &coder, Reference &reference)
+    {
+        typedef typename Coder::element_type::value_type value_type;
+
+        uint32_t lengths[] = { 1, 15, 16, 17, 31, 32, 33, 100, 1600 };
+
+        for(uint32_t length : lengths)
+        {
+            std::vector<uint8_t> src = random_vector(length);
+            std::vector<uint8_t> dest = random_vector(length);
+
+            value_type *s = (value_type*) &src[0];
+
+            for(uint32_t c = 0; c <= fifi::binary8::max_value; ++c)
+            {
+                if(c > Coder::element_type::field_type::max_value)
+                    break;
+
+                value_type coefficient = (value_type) c;
+
+                std::vector<uint8_t> expected = dest;
+                std::vector<uint8_t> result = dest;
+
+                value_type *e = (value_type*) &expected[0];
+                value_type *r = (value_type*) &result[0];
+
+                reference->multiply_add(e, s, coefficient, length);
+                coder->multiply_add(r, s, coefficient, length);
+                EXPECT_TRUE(expected == result);
+
+                reference->multiply_subtract(e, s, coefficient, length);
+                coder->multiply_subtract(r, s, coefficient, length);
+                EXPECT_TRUE(expected == result);
+
+                reference->multiply(e, coefficient, length);
+                coder->multiply(r, coefficient, length);
+                EXPECT_TRUE(expected == result);
+
+                reference->add(e, s, length);
+                coder->add(r, s, length);
+                EXPECT_TRUE(expected == result);
+
+                reference->subtract(e, s, length);
+                coder->subtract(r, s, length);
+                EXPECT_TRUE(expected == result);
+            }
+        }
+    }
+
+    template<class Field>
+    void test_backends()
+    {
+        typename kodo::simd_math_stack<Field>::factory factory(10, 1600);
+        typename kodo::reference_math_stack<Field>::factory
+            reference_factory(10, 1600);
+
+        auto reference = reference_factory.build();
+
+        EXPECT_EQ(kodo::cpu_simd_backend(), factory.backend());
+
+        for(uint32_t b = kodo::simd_scalar; b <= kodo::cpu_simd_backend(); ++b)
+        {
+            kodo::simd_backend backend = (kodo::simd_backend) b;
+            factory.set_backend(backend);
+
+            auto coder = factory.build();
+            EXPECT_EQ(backend, coder->backend());
+
+            check_operations(coder, reference);
+        }
+    }
+
+}
+
+TEST(TestSimdFiniteFieldMath, test_backends)
+{
+    test_backends<fifi::binary>();
+    test_backends<fifi::binary8>();
+}
+
+TEST(TestSimdFiniteFieldMath, test_no_kernels)
+{
+    // The fields without kernels use the finite_field_math layer
+    kodo::simd_math_stack<fifi::binary16>::factory factory(10, 1600);
+    auto coder = factory.build();
+
+    EXPECT_FALSE(kodo::simd_math_stack<fifi::binary16>::has_kernels);
+    EXPECT_EQ(kodo::simd_scalar, coder->backend());
+
+    kodo::reference_math_stack<fifi::binary16>::factory
+        reference_factory(10, 1600);
+
+    auto reference = reference_factory.build();
+
+    std::vector<uint8_t> src = random_vector(200);
+    std::vector<uint8_t> expected = random_vector(200);
+    std::vector<uint8_t> result = expected;
+
+    reference->multiply_add((uint16_t*) &expected[0],
+                            (const uint16_t*) &src[0], 1234, 100);
+    coder->multiply_add((uint16_t*) &result[0],
+                        (const uint16_t*) &src[0], 1234, 100);
+
+    EXPECT_TRUE(expected == result);
+}
+
+TEST(TestSimdFiniteFieldMath, test_round_trip)
+{
+    typedef kodo::full_rlnc_encoder<fifi::binary8> encoder_type;
+    typedef kodo::full_rlnc_decoder<fifi::binary8> decoder_type;
+
+    uint32_t symbols = 32;
+    uint32_t symbol_size = 1403;
+
+    for(uint32_t b = kodo::simd_scalar; b <= kodo::cpu_simd_backend(); ++b)
+    {
+        kodo::simd_backend backend = (kodo::simd_backend) b;
+
+        encoder_type::factory encoder_factory(symbols, symbol_size);
+        decoder_type::factory decoder_factory(symbols, symbol_size);
+
+        encoder_factory.set_backend(backend);
+        decoder_factory.set_backend(kodo::cpu_simd_backend());
+
+        auto encoder = encoder_factory.build();
+        auto decoder = decoder_factory.build();
+
+        EXPECT_EQ(backend, encoder->backend());
+
+        std::vector<uint8_t> data_in = random_vector(encoder->block_size());
+        encoder->set_symbols(sak::storage(data_in));
+        encoder->set_systematic_off();
+
+        std::vector<uint8_t> payload(encoder->payload_size());
+
+        while(!decoder->is_complete())
+        {
+            encoder->encode(&payload[0]);
+            decoder->decode(&payload[0]);
+        }
+
+        std::vector<uint8_t> data_out(decoder->block_size());
+        decoder->copy_symbols(sak::storage(data_out));
+
+        EXPECT_TRUE(data_in == data_out);
+    }
+}
+
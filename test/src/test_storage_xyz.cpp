@@ -277,3 +277,46 @@ TEST(TestStorageCoder, deep_storage_decoder)
 
 
 
+
+/// Decodes into a deep storage buffer allocated using a huge page policy
+TEST(TestStorageCoder, deep_storage_decoder_memory_policy)
+{
+    typedef kodo::storage_encoder<
+        kodo::full_rlnc_encoder<fifi::binary8> > storage_encoder;
+
+    typedef kodo::deep_storage_decoder<
+        kodo::shallow_rlnc_decoder<fifi::binary8> > storage_decoder;
+
+    kodo::memory_policy policy;
+    policy.m_huge_pages = kodo::memory_policy::huge_pages_transparent;
+    policy.m_numa_local = true;
+
+    uint32_t object_size = 100000;
+
+    storage_encoder::factory encoder_factory(32, 1000);
+    storage_decoder::factory decoder_factory(32, 1000);
+
+    std::vector<uint8_t> data_in = random_vector(object_size);
+
+    storage_encoder encoder(encoder_factory, sak::storage(data_in));
+    storage_decoder decoder(decoder_factory, object_size, policy);
+
+    for(uint32_t i = 0; i < encoder.encoders(); ++i)
+    {
+        auto e = encoder.build(i);
+        auto d = decoder.build(i);
+
+        std::vector<uint8_t> payload(e->payload_size());
+
+        while(!d->is_complete())
+        {
+            e->encode(&payload[0]);
+            d->decode(&payload[0]);
+        }
+    }
+
+    std::vector<uint8_t> data_out;
+    decoder.swap(data_out);
+
+    EXPECT_TRUE(data_in == data_out);
+}
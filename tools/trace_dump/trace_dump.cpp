@@ -0,0 +1,215 @@
+// Copyright Steinwurf ApS 2011-2013.
+// Distributed under the "STEINWURF RESEARCH LICENSE 1.0".
+// See accompanying file LICENSE.rst or
+// http://www.steinwurf.com/licensing
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <kodo/trace_event.hpp>
+#include <kodo/trace_file.hpp>
+
+/// @file trace_dump.cpp
+///
+/// Prints the events saved from the trace_buffer of the decoder_trace
+/// layer as a timeline. Usage:
+///
+///     trace_dump <trace file> [<trace file> ...]
+///
+/// The time of an event is shown in microseconds since the first
+/// event in the file, followed by the time since the previous event.
+/// The events of a generation start with the initialized event, the
+/// timeline is followed by a summary of each generation.
+
+/// The counts of a generation, i.e. the events from an initialized
+/// event to the next
+struct generation_summary
+{
+    generation_summary()
+        : m_symbols(0),
+          m_start(0),
+          m_complete(0),
+          m_packets(0),
+          m_non_innovative(0),
+          m_swaps(0),
+          m_rank(0)
+    { }
+
+    uint32_t m_symbols;
+    uint64_t m_start;
+    uint64_t m_complete;
+    uint32_t m_packets;
+    uint32_t m_non_innovative;
+    uint32_t m_swaps;
+    uint32_t m_rank;
+};
+
+/// @return The time between two tick counts in microseconds
+double microseconds(uint64_t from, uint64_t to, uint64_t ticks_per_second)
+{
+    return (to - from) * 1e6 / ticks_per_second;
+}
+
+/// @return The value of an event as text
+std::string event_value(const kodo::trace_record &record)
+{
+    if(record.m_value == kodo::trace_event::coded_symbol &&
+       (record.m_event == kodo::trace_event::packet_received ||
+        record.m_event == kodo::trace_event::non_innovative))
+    {
+        return "coded";
+    }
+
+    return std::to_string(record.m_value);
+}
+
+/// Prints the summary of a generation
+void print_summary(uint32_t index, const generation_summary &summary,
+                   uint64_t ticks_per_second)
+{
+    std::cout << "generation " << index << ": "
+              << summary.m_symbols << " symbols, "
+              << summary.m_packets << " packets, "
+              << summary.m_non_innovative << " non-innovative, "
+              << summary.m_swaps << " swaps, rank " << summary.m_rank;
+
+    if(summary.m_complete != 0)
+    {
+        std::cout << ", complete after "
+                  << microseconds(summary.m_start, summary.m_complete,
+                                  ticks_per_second) << " us";
+    }
+
+    std::cout << std::endl;
+}
+
+/// Prints the timeline of a trace file
+void dump(const kodo::trace_file &file)
+{
+    std::cout << file.m_records.size() << " events";
+
+    uint64_t dropped = file.dropped();
+    if(dropped > 0)
+    {
+        std::cout << ", " << dropped << " earlier events were "
+                  << "overwritten";
+    }
+
+    std::cout << ", " << file.m_ticks_per_second << " ticks per second"
+              << std::endl << std::endl;
+
+    if(file.m_records.empty() || file.m_ticks_per_second == 0)
+        return;
+
+    std::cout << std::setw(14) << "time_us" << std::setw(14) << "delta_us"
+              << "  " << std::left << std::setw(18) << "event"
+              << "value" << std::right << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+    uint64_t first = file.m_records.front().m_ticks;
+    uint64_t previous = first;
+
+    std::vector<generation_summary> generations;
+
+    for(const auto &record : file.m_records)
+    {
+        if(record.m_event >= kodo::trace_event::event_count)
+        {
+            std::cout << "unknown event " << uint32_t(record.m_event)
+                      << std::endl;
+            continue;
+        }
+
+        auto event = static_cast<kodo::trace_event::type>(record.m_event);
+
+        std::cout << std::setw(14)
+                  << microseconds(first, record.m_ticks,
+                                  file.m_ticks_per_second)
+                  << std::setw(14)
+                  << microseconds(previous, record.m_ticks,
+                                  file.m_ticks_per_second)
+                  << "  " << std::left << std::setw(18)
+                  << kodo::trace_event::name(event)
+                  << event_value(record) << std::right << std::endl;
+
+        previous = record.m_ticks;
+
+        // Events before the first initialized event belong to a
+        // generation started before the oldest event kept
+        if(event == kodo::trace_event::initialized || generations.empty())
+        {
+            generations.push_back(generation_summary());
+            generations.back().m_start = record.m_ticks;
+        }
+
+        generation_summary &summary = generations.back();
+
+        switch(event)
+        {
+        case kodo::trace_event::initialized:
+            summary.m_symbols = record.m_value;
+            break;
+        case kodo::trace_event::packet_received:
+            ++summary.m_packets;
+            break;
+        case kodo::trace_event::non_innovative:
+            ++summary.m_non_innovative;
+            break;
+        case kodo::trace_event::rank_changed:
+            summary.m_rank = record.m_value;
+            break;
+        case kodo::trace_event::swap_decode:
+            ++summary.m_swaps;
+            break;
+        case kodo::trace_event::complete:
+            summary.m_complete = record.m_ticks;
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::cout << std::endl;
+
+    for(uint32_t i = 0; i < generations.size(); ++i)
+    {
+        print_summary(i, generations[i], file.m_ticks_per_second);
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    if(argc < 2)
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " <trace file> [<trace file> ...]" << std::endl;
+        return 1;
+    }
+
+    int result = 0;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::ifstream in(argv[i], std::ios::binary);
+
+        kodo::trace_file file;
+
+        if(!in || !file.read(in))
+        {
+            std::cerr << argv[i] << ": not a kodo trace file" << std::endl;
+            result = 1;
+            continue;
+        }
+
+        std::cout << argv[i] << ": ";
+        dump(file);
+        std::cout << std::endl;
+    }
+
+    return result;
+}